@@ -0,0 +1,65 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "cache.hpp"
+
+namespace py = pybind11;
+
+namespace revkit
+{
+
+void cache( py::module m )
+{
+  using namespace py::literals;
+
+  m.def(
+      "enable_cache", []( std::size_t capacity, std::string const& directory ) {
+        result_cache::instance().enable( capacity, directory );
+      },
+      R"doc(
+    Enables the result cache for synthesis calls
+
+    Results of :func:`tbs`, :func:`dbs`, :func:`oracle_synth`,
+    :func:`phase_oracle_synth`, and :func:`lhrs` are cached under a 128-bit
+    hash of their input (permutation, truth table, or contents of the logic
+    network file) and all of their parameters.  The input and parameters are
+    stored with the result and compared on each hit, such that a hash
+    collision is treated as a miss.  The most recently used ``capacity``
+    results are kept in memory.  If ``directory`` is not empty, results are
+    also stored in that (existing) directory in a binary netlist format and
+    are loaded from there when they are not in memory, e.g., in later
+    sessions.
+
+    Side effects of cached calls are not repeated, e.g., :func:`lhrs` does not
+    update the ``minmc_cache`` file when its result is taken from the cache.
+    Results of calls that stopped at their ``timeout`` are not cached.
+
+    :param int capacity: Maximum number of results kept in memory
+    :param string directory: Directory for on-disk results
+)doc",
+      "capacity"_a = 1024u, "directory"_a = "" );
+
+  m.def(
+      "disable_cache", []() { result_cache::instance().disable(); },
+      R"doc(
+    Disables the result cache and clears the results kept in memory
+
+    Results on disk are kept.
+)doc" );
+
+  m.def(
+      "cache_stats", []() { return result_cache::instance().stats(); },
+      R"doc(
+    Statistics of the result cache
+
+    The number of cache hits (``hits``, which are the sum of ``memory_hits``
+    and ``disk_hits``), ``misses``, and ``evictions`` from memory are counted
+    since the module was loaded.  Also the number of results in memory
+    (``entries``), the ``capacity``, and whether the cache is ``enabled`` are
+    returned.
+
+    :rtype: dict
+)doc" );
+}
+
+} // namespace revkit
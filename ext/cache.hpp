@@ -0,0 +1,661 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <easy/utils/cancellation.hpp>
+#include <fmt/format.h>
+#include <kitty/dynamic_truth_table.hpp>
+
+#include "types.hpp"
+
+namespace revkit
+{
+
+/* 128-bit content hash that identifies a synthesis call */
+struct cache_key
+{
+  uint64_t h1{0u};
+  uint64_t h2{0u};
+
+  bool operator==( cache_key const& other ) const
+  {
+    return h1 == other.h1 && h2 == other.h2;
+  }
+
+  std::string to_string() const
+  {
+    return fmt::format( "{:016x}{:016x}", h1, h2 );
+  }
+};
+
+struct cache_key_hash
+{
+  std::size_t operator()( cache_key const& key ) const
+  {
+    return static_cast<std::size_t>( key.h1 );
+  }
+};
+
+/* MurmurHash3_x64_128 by Austin Appleby; blocks and tail are read in
+ * little-endian byte order, such that keys do not depend on the platform */
+inline cache_key _hash128( std::string const& data, uint32_t seed = 0u )
+{
+  constexpr uint64_t c1 = 0x87c37b91114253d5ull;
+  constexpr uint64_t c2 = 0x4cf5ad432745937full;
+
+  const auto rotl = []( uint64_t x, int r ) { return ( x << r ) | ( x >> ( 64 - r ) ); };
+  const auto fmix = []( uint64_t k ) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+  };
+  const auto load = [&]( std::size_t pos, std::size_t size ) {
+    uint64_t k{0u};
+    for ( auto i = 0u; i < size; ++i )
+    {
+      k |= static_cast<uint64_t>( static_cast<uint8_t>( data[pos + i] ) ) << ( 8u * i );
+    }
+    return k;
+  };
+
+  uint64_t h1{seed}, h2{seed};
+
+  const auto num_blocks = data.size() / 16u;
+  for ( auto i = 0u; i < num_blocks; ++i )
+  {
+    auto k1 = load( 16u * i, 8u );
+    auto k2 = load( 16u * i + 8u, 8u );
+
+    k1 *= c1;
+    k1 = rotl( k1, 31 );
+    k1 *= c2;
+    h1 ^= k1;
+
+    h1 = rotl( h1, 27 );
+    h1 += h2;
+    h1 = h1 * 5 + 0x52dce729;
+
+    k2 *= c2;
+    k2 = rotl( k2, 33 );
+    k2 *= c1;
+    h2 ^= k2;
+
+    h2 = rotl( h2, 31 );
+    h2 += h1;
+    h2 = h2 * 5 + 0x38495ab5;
+  }
+
+  const auto tail = data.size() % 16u;
+  if ( tail > 8u )
+  {
+    auto k2 = load( 16u * num_blocks + 8u, tail - 8u );
+    k2 *= c2;
+    k2 = rotl( k2, 33 );
+    k2 *= c1;
+    h2 ^= k2;
+  }
+  if ( tail > 0u )
+  {
+    auto k1 = load( 16u * num_blocks, std::min<std::size_t>( tail, 8u ) );
+    k1 *= c1;
+    k1 = rotl( k1, 31 );
+    k1 *= c2;
+    h1 ^= k1;
+  }
+
+  h1 ^= data.size();
+  h2 ^= data.size();
+  h1 += h2;
+  h2 += h1;
+  h1 = fmix( h1 );
+  h2 = fmix( h2 );
+  h1 += h2;
+  h2 += h1;
+
+  return {h1, h2};
+}
+
+/* Appends values in native byte order to a byte buffer */
+class byte_writer
+{
+public:
+  template<typename T>
+  void write( T const& value )
+  {
+    static_assert( std::is_trivially_copyable_v<T> );
+    data_.append( reinterpret_cast<char const*>( &value ), sizeof( T ) );
+  }
+
+  void write( std::string const& value )
+  {
+    write<uint64_t>( value.size() );
+    data_.append( value );
+  }
+
+  template<typename T>
+  void write( std::vector<T> const& values )
+  {
+    write<uint64_t>( values.size() );
+    for ( auto const& value : values )
+    {
+      write( value );
+    }
+  }
+
+  std::string const& data() const
+  {
+    return data_;
+  }
+
+private:
+  std::string data_;
+};
+
+/* Reads values written by `byte_writer`; reading past the end invalidates the reader */
+class byte_reader
+{
+public:
+  explicit byte_reader( std::string const& data )
+      : data_( data )
+  {
+  }
+
+  template<typename T>
+  bool read( T& value )
+  {
+    static_assert( std::is_trivially_copyable_v<T> );
+    if ( !valid_ || data_.size() - pos_ < sizeof( T ) )
+    {
+      return valid_ = false;
+    }
+    std::memcpy( &value, data_.data() + pos_, sizeof( T ) );
+    pos_ += sizeof( T );
+    return true;
+  }
+
+  bool read( std::string& value )
+  {
+    uint64_t size{0u};
+    if ( !read( size ) || data_.size() - pos_ < size )
+    {
+      return valid_ = false;
+    }
+    value = data_.substr( pos_, size );
+    pos_ += size;
+    return true;
+  }
+
+  template<typename T>
+  bool read( std::vector<T>& values )
+  {
+    uint64_t size{0u};
+    if ( !read( size ) || size > data_.size() - pos_ )
+    {
+      return valid_ = false;
+    }
+    values.resize( size );
+    for ( auto& value : values )
+    {
+      if ( !read( value ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  std::string const& data_;
+  std::size_t pos_{0u};
+  bool valid_{true};
+};
+
+/* Binary netlist format
+ *
+ * After the magic number and the format version follow the rewiring map and
+ * the nodes of the netlist in their order, each tagged as qubit or gate, and
+ * a final end tag.  A gate consists of its operation, its rotation angle
+ * (exact or numeric), its controls (index and polarity) and its targets.
+ * Single-target gates with a control function store the function instead of
+ * the rotation angle.  Values are stored in native byte order.
+ */
+constexpr uint32_t _netlist_magic = 0x4c4e4b52u; /* "RKNL" */
+constexpr uint32_t _netlist_format_version = 1u;
+
+enum class _netlist_tag : uint8_t
+{
+  qubit,
+  gate,
+  end
+};
+
+inline void write_binary_netlist( byte_writer& out, netlist_t const& circ )
+{
+  out.write( _netlist_magic );
+  out.write( _netlist_format_version );
+  out.write( circ.rewire_map() );
+
+  circ.foreach_cnode( [&]( auto const& node ) {
+    auto const& gate = node.gate;
+    if ( gate.is( tweedledum::gate_set::output ) )
+    {
+      return;
+    }
+    if ( gate.is( tweedledum::gate_set::input ) )
+    {
+      out.write( _netlist_tag::qubit );
+      return;
+    }
+
+    out.write( _netlist_tag::gate );
+    out.write( gate.operation() );
+    if ( gate.is( tweedledum::gate_set::num_defined_ops ) )
+    {
+      auto const& function = gate.function();
+      out.write( static_cast<uint32_t>( function.num_vars() ) );
+      out.write( std::vector<uint64_t>( function.begin(), function.end() ) );
+    }
+    else if ( const auto angle = gate.rotation_angle(); angle.is_dyadic() )
+    {
+      out.write<uint8_t>( 1u );
+      out.write( angle.dyadic_value().numerator() );
+      out.write( angle.dyadic_value().exponent() );
+    }
+    else
+    {
+      out.write<uint8_t>( 0u );
+      out.write( angle.numeric_value() );
+    }
+
+    std::vector<uint32_t> controls, targets;
+    gate.foreach_control( [&]( auto q ) { controls.push_back( ( q.index() << 1u ) | ( q.is_complemented() ? 1u : 0u ) ); } );
+    gate.foreach_target( [&]( auto q ) { targets.push_back( q.index() ); } );
+    out.write( controls );
+    out.write( targets );
+  } );
+
+  out.write( _netlist_tag::end );
+}
+
+inline bool read_binary_netlist( byte_reader& in, netlist_t& circ )
+{
+  uint32_t magic{0u}, version{0u};
+  if ( !in.read( magic ) || magic != _netlist_magic || !in.read( version ) || version != _netlist_format_version )
+  {
+    return false;
+  }
+
+  std::vector<uint32_t> rewiring_map;
+  if ( !in.read( rewiring_map ) )
+  {
+    return false;
+  }
+
+  while ( true )
+  {
+    _netlist_tag tag;
+    if ( !in.read( tag ) )
+    {
+      return false;
+    }
+
+    switch ( tag )
+    {
+    case _netlist_tag::qubit:
+      circ.add_qubit();
+      break;
+
+    case _netlist_tag::gate:
+    {
+      tweedledum::gate_set operation;
+      if ( !in.read( operation ) )
+      {
+        return false;
+      }
+
+      std::optional<kitty::dynamic_truth_table> function;
+      tweedledum::angle angle{0.0};
+      if ( operation == tweedledum::gate_set::num_defined_ops )
+      {
+        uint32_t num_vars{0u};
+        std::vector<uint64_t> words;
+        if ( !in.read( num_vars ) || !in.read( words ) )
+        {
+          return false;
+        }
+        function.emplace( num_vars );
+        if ( function->num_blocks() != words.size() )
+        {
+          return false;
+        }
+        std::copy( words.begin(), words.end(), function->begin() );
+      }
+      else
+      {
+        uint8_t is_dyadic{0u};
+        if ( !in.read( is_dyadic ) )
+        {
+          return false;
+        }
+        if ( is_dyadic )
+        {
+          uint64_t numerator{0u};
+          uint32_t exponent{0u};
+          if ( !in.read( numerator ) || !in.read( exponent ) || exponent > tweedledum::dyadic_angle::max_exponent )
+          {
+            return false;
+          }
+          angle = tweedledum::dyadic_angle( static_cast<int64_t>( numerator ), exponent );
+        }
+        else
+        {
+          double value{0.0};
+          if ( !in.read( value ) )
+          {
+            return false;
+          }
+          angle = value;
+        }
+      }
+
+      std::vector<uint32_t> control_literals, target_indexes;
+      if ( !in.read( control_literals ) || !in.read( target_indexes ) || target_indexes.empty() )
+      {
+        return false;
+      }
+
+      std::vector<tweedledum::qubit_id> controls, targets;
+      for ( auto c : control_literals )
+      {
+        controls.emplace_back( c >> 1u, ( c & 1u ) == 1u );
+      }
+      for ( auto t : target_indexes )
+      {
+        targets.emplace_back( t );
+      }
+
+      if ( function )
+      {
+        circ.emplace_gate( gate_t( *function, controls, targets.front() ) );
+      }
+      else
+      {
+        circ.emplace_gate( gate_t( tweedledum::gate_base( operation, angle ), controls, targets ) );
+      }
+      break;
+    }
+
+    case _netlist_tag::end:
+      circ.rewire( rewiring_map );
+      return true;
+
+    default:
+      return false;
+    }
+  }
+}
+
+inline void write_cache_result( byte_writer& out, netlist_t const& circ )
+{
+  write_binary_netlist( out, circ );
+}
+
+inline bool read_cache_result( byte_reader& in, netlist_t& circ )
+{
+  return read_binary_netlist( in, circ );
+}
+
+/* netlist and statistics as returned by lhrs */
+inline void write_cache_result( byte_writer& out, std::pair<netlist_t, std::unordered_map<std::string, std::vector<uint32_t>>> const& result )
+{
+  write_binary_netlist( out, result.first );
+  out.write<uint64_t>( result.second.size() );
+  for ( auto const& [key, values] : result.second )
+  {
+    out.write( key );
+    out.write( values );
+  }
+}
+
+inline bool read_cache_result( byte_reader& in, std::pair<netlist_t, std::unordered_map<std::string, std::vector<uint32_t>>>& result )
+{
+  uint64_t size{0u};
+  if ( !read_binary_netlist( in, result.first ) || !in.read( size ) )
+  {
+    return false;
+  }
+  for ( auto i = 0u; i < size; ++i )
+  {
+    std::string key;
+    std::vector<uint32_t> values;
+    if ( !in.read( key ) || !in.read( values ) )
+    {
+      return false;
+    }
+    result.second.emplace( key, values );
+  }
+  return true;
+}
+
+/* Result cache for synthesis calls
+ *
+ * Results are kept in an in-memory LRU list of at most `capacity` entries.
+ * If a directory is given, results are also stored in files
+ * `<directory>/<key>.rknl`, from which they are loaded when they are not in
+ * memory.  Each entry keeps the data that was hashed into its key, and a
+ * lookup only succeeds if that data matches, such that hash collisions and
+ * foreign files are treated as misses.  The cache is disabled by default.
+ */
+class result_cache
+{
+public:
+  static result_cache& instance()
+  {
+    static result_cache cache;
+    return cache;
+  }
+
+  void enable( std::size_t capacity, std::string const& directory )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    enabled_ = true;
+    capacity_ = capacity;
+    directory_ = directory;
+    shrink();
+  }
+
+  void disable()
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    enabled_ = false;
+    entries_.clear();
+    index_.clear();
+  }
+
+  bool enabled() const
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    return enabled_;
+  }
+
+  std::optional<std::string> lookup( cache_key const& key, std::string const& key_data )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    if ( const auto it = index_.find( key ); it != index_.end() && it->second->key_data == key_data )
+    {
+      entries_.splice( entries_.begin(), entries_, it->second );
+      ++hits_;
+      return it->second->payload;
+    }
+
+    if ( !directory_.empty() )
+    {
+      std::ifstream is( filename( key ), std::ios::binary );
+      if ( is )
+      {
+        const std::string contents( ( std::istreambuf_iterator<char>( is ) ), std::istreambuf_iterator<char>() );
+        byte_reader in( contents );
+        std::string stored_key_data, payload;
+        if ( in.read( stored_key_data ) && stored_key_data == key_data && in.read( payload ) )
+        {
+          ++disk_hits_;
+          insert( key, key_data, payload );
+          return payload;
+        }
+      }
+    }
+
+    ++misses_;
+    return std::nullopt;
+  }
+
+  void store( cache_key const& key, std::string const& key_data, std::string const& payload )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    insert( key, key_data, payload );
+
+    if ( !directory_.empty() )
+    {
+      byte_writer out;
+      out.write( key_data );
+      out.write( payload );
+
+      /* write to a temporary file first, such that readers never see partial results */
+      const auto name = filename( key );
+      const auto tmp_name = name + ".tmp";
+      {
+        std::ofstream os( tmp_name, std::ios::binary | std::ios::trunc );
+        os.write( out.data().data(), out.data().size() );
+        if ( !os )
+        {
+          std::remove( tmp_name.c_str() );
+          return;
+        }
+      }
+      std::rename( tmp_name.c_str(), name.c_str() );
+    }
+  }
+
+  std::unordered_map<std::string, uint64_t> stats() const
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    return {{"enabled", enabled_ ? 1u : 0u},
+            {"hits", hits_ + disk_hits_},
+            {"memory_hits", hits_},
+            {"disk_hits", disk_hits_},
+            {"misses", misses_},
+            {"evictions", evictions_},
+            {"entries", entries_.size()},
+            {"capacity", capacity_}};
+  }
+
+private:
+  result_cache() = default;
+
+  std::string filename( cache_key const& key ) const
+  {
+    return directory_ + "/" + key.to_string() + ".rknl";
+  }
+
+  void insert( cache_key const& key, std::string const& key_data, std::string const& payload )
+  {
+    if ( const auto it = index_.find( key ); it != index_.end() )
+    {
+      it->second->key_data = key_data;
+      it->second->payload = payload;
+      entries_.splice( entries_.begin(), entries_, it->second );
+      return;
+    }
+    entries_.push_front( {key, key_data, payload} );
+    index_[key] = entries_.begin();
+    shrink();
+  }
+
+  void shrink()
+  {
+    while ( entries_.size() > capacity_ )
+    {
+      index_.erase( entries_.back().key );
+      entries_.pop_back();
+      ++evictions_;
+    }
+  }
+
+private:
+  mutable std::mutex mutex_;
+  bool enabled_{false};
+  std::size_t capacity_{0u};
+  std::string directory_;
+
+  struct entry
+  {
+    cache_key key;
+    std::string key_data;
+    std::string payload;
+  };
+
+  std::list<entry> entries_;
+  std::unordered_map<cache_key, std::list<entry>::iterator, cache_key_hash> index_;
+
+  uint64_t hits_{0u};
+  uint64_t disk_hits_{0u};
+  uint64_t misses_{0u};
+  uint64_t evictions_{0u};
+};
+
+/* Returns the result of `fn` and caches it under the data that `make_key`
+ * writes, which must include all inputs and parameters of the synthesis
+ * call.  Nothing is hashed if the cache is disabled.  Results of
+ * calls that stopped because `token` was canceled are not cached. */
+template<class Result, class MakeKey, class Fn>
+Result _cached( MakeKey&& make_key, Fn&& fn, easy::utils::cancellation_token const* token = nullptr )
+{
+  auto& cache = result_cache::instance();
+  if ( !cache.enabled() )
+  {
+    return fn();
+  }
+
+  byte_writer key_data;
+  make_key( key_data );
+  const auto key = _hash128( key_data.data() );
+
+  if ( const auto payload = cache.lookup( key, key_data.data() ) )
+  {
+    byte_reader in( *payload );
+    Result result;
+    if ( read_cache_result( in, result ) )
+    {
+      return result;
+    }
+  }
+
+  Result result = fn();
+  if ( token && token->is_canceled() )
+  {
+    return result;
+  }
+
+  byte_writer out;
+  write_cache_result( out, result );
+  cache.store( key, key_data.data(), out.data() );
+  return result;
+}
+
+} // namespace revkit
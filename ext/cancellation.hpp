@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+#include <easy/utils/cancellation.hpp>
+
+namespace py = pybind11;
+
+namespace revkit
+{
+
+using cancellation_token = easy::utils::cancellation_token;
+
+/* raised from a synthesis call that stopped at its timeout without a result;
+   it is translated into Python's TimeoutError */
+class timeout_error : public std::runtime_error
+{
+public:
+  explicit timeout_error( std::string const& what )
+      : std::runtime_error( what )
+  {
+  }
+};
+
+/* time budget in seconds for a `timeout` argument (negative if there is no timeout) */
+inline double _time_budget( std::optional<double> const& timeout )
+{
+  return timeout ? std::max( *timeout, 0.0 ) : -1.0;
+}
+
+/* true if `perm` maps every value to itself */
+inline bool _is_identity( std::vector<uint32_t> const& perm )
+{
+  for ( auto i = 0u; i < perm.size(); ++i )
+  {
+    if ( perm[i] != i )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* runs `fn()` on a worker thread, while the calling thread releases the GIL
+   and handles Python signals every 50ms; a KeyboardInterrupt (or any other
+   exception raised by a signal handler) cancels `token`, waits for the
+   worker to reach its next safe point, and is then raised; the deadline of
+   `token` also raises its stop flag for SAT solvers that only poll the flag;
+   without a deadline, `fn()` runs inline on the calling thread */
+template<class Fn>
+auto _interruptible( cancellation_token& token, Fn&& fn ) -> decltype( fn() )
+{
+  using result_t = decltype( fn() );
+
+  if ( !token.has_deadline() )
+  {
+    return fn();
+  }
+
+  std::optional<result_t> result;
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done{false};
+
+  std::thread worker( [&]() {
+    try
+    {
+      result.emplace( fn() );
+    }
+    catch ( ... )
+    {
+      error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock( mutex );
+    done = true;
+    cv.notify_one();
+  } );
+
+  bool interrupted{false};
+  {
+    py::gil_scoped_release release;
+
+    std::unique_lock<std::mutex> lock( mutex );
+    while ( !cv.wait_for( lock, std::chrono::milliseconds( 50 ), [&]() { return done; } ) )
+    {
+      if ( interrupted )
+      {
+        continue;
+      }
+
+      lock.unlock();
+      {
+        py::gil_scoped_acquire acquire;
+        interrupted = PyErr_CheckSignals() != 0;
+      }
+      if ( interrupted )
+      {
+        token.cancel();
+      }
+      else
+      {
+        token.is_canceled();
+      }
+      lock.lock();
+    }
+  }
+  worker.join();
+
+  if ( interrupted )
+  {
+    throw py::error_already_set();
+  }
+
+  if ( error )
+  {
+    try
+    {
+      std::rethrow_exception( error );
+    }
+    catch ( timeout_error const& e )
+    {
+      PyErr_SetString( PyExc_TimeoutError, e.what() );
+      throw py::error_already_set();
+    }
+  }
+
+  return std::move( *result );
+}
+
+} // namespace revkit
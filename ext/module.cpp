@@ -16,6 +16,7 @@ void truth_table( py::module m );
 
 void decomposition( py::module m );
 void synthesis( py::module m );
+void cache( py::module m );
 
 }
 
@@ -28,4 +29,5 @@ PYBIND11_MODULE( _revkit, m )
 
   revkit::decomposition( m );
   revkit::synthesis( m );
+  revkit::cache( m );
 }
@@ -3,6 +3,7 @@
 
 #include <sstream>
 
+#include <tweedledum/algorithms/generic/append_adjoint.hpp>
 #include <tweedledum/gates/mcst_gate.hpp>
 #include <tweedledum/io/qasm.hpp>
 #include <tweedledum/io/quil.hpp>
@@ -82,6 +83,25 @@ void netlist( py::module m )
     :rtype: List[gate]
 )doc" );
 
+  _netlist.def( "adjoint", []( netlist_t const& ref ) {
+    netlist_t adj;
+    std::vector<tweedledum::qubit_id> qubits;
+    for ( auto i = 0u; i < ref.num_qubits(); ++i )
+    {
+      qubits.push_back( adj.add_qubit() );
+    }
+    tweedledum::append_adjoint( adj, ref, qubits );
+    return adj;
+  }, R"doc(
+    Adjoint circuit
+
+    Returns a circuit on the same qubits with the gates in reverse order,
+    each replaced by its adjoint, e.g., T by T† and Rz(θ) by Rz(-θ).  Applying
+    the adjoint after the circuit yields the identity.
+
+    :rtype: netlist
+)doc" );
+
   _netlist.def( "to_quil", []( netlist_t const& ref ) {
     std::ostringstream s;
     tweedledum::write_quil( ref, s );
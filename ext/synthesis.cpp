@@ -2,20 +2,40 @@
 #include <pybind11/stl.h>
 
 #include <algorithm>
+#include <cctype>
 #include <cstdint>
+#include <fstream>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include <caterpillar/synthesis/lhrs.hpp>
+#include <caterpillar/synthesis/strategies/best_fit_mapping_strategy.hpp>
 #include <caterpillar/synthesis/strategies/eager_mapping_strategy.hpp>
 #include <caterpillar/synthesis/strategies/bennett_mapping_strategy.hpp>
+#include <caterpillar/synthesis/strategies/heuristic_pebbling_mapping_strategy.hpp>
 #include <caterpillar/synthesis/strategies/pebbling_mapping_strategy.hpp>
+#include <caterpillar/synthesis/strategies/xag_mapping_strategy.hpp>
 #include <lorina/aiger.hpp>
 #include <lorina/bench.hpp>
 #include <lorina/verilog.hpp>
+#include <mockturtle/algorithms/aig_resub.hpp>
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/cut_rewriting.hpp>
+#include <mockturtle/algorithms/mig_algebraic_rewriting.hpp>
+#include <mockturtle/algorithms/mig_resub.hpp>
+#include <mockturtle/algorithms/node_resynthesis/mig_npn.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_minmc.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_npn.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xmg_npn.hpp>
+#include <mockturtle/algorithms/refactoring.hpp>
+#include <mockturtle/algorithms/xmg_algebraic_rewriting.hpp>
 #include <mockturtle/io/aiger_reader.hpp>
 #include <mockturtle/io/bench_reader.hpp>
 #include <mockturtle/io/verilog_reader.hpp>
@@ -24,12 +44,19 @@
 #include <mockturtle/networks/mig.hpp>
 #include <mockturtle/networks/xag.hpp>
 #include <mockturtle/networks/xmg.hpp>
+#include <mockturtle/utils/cost_functions.hpp>
+#include <mockturtle/views/depth_view.hpp>
+#include <mockturtle/views/fanout_view.hpp>
 #include <tweedledum/algorithms/synthesis/dbs.hpp>
 #include <tweedledum/algorithms/synthesis/diagonal_synth.hpp>
+#include <tweedledum/algorithms/synthesis/esop_phase_synth.hpp>
 #include <tweedledum/algorithms/synthesis/gray_synth.hpp>
+#include <tweedledum/algorithms/synthesis/spectrum_phase_synth.hpp>
 #include <tweedledum/algorithms/synthesis/stg.hpp>
 #include <tweedledum/algorithms/synthesis/tbs.hpp>
 
+#include "cache.hpp"
+#include "cancellation.hpp"
 #include "types.hpp"
 
 namespace py = pybind11;
@@ -42,7 +69,16 @@ enum class mapping_strategy_type
   bennett,
   bennett_inplace,
   eager,
-  pebbling
+  pebbling,
+  heuristic_pebbling,
+  best_fit,
+  xag
+};
+
+enum class sat_solver_type
+{
+  bsat,
+  glucose
 };
 
 std::string _filename_extension( const std::string& filename )
@@ -57,11 +93,253 @@ std::string _filename_extension( const std::string& filename )
   return std::string();
 }
 
+/* contents of a file, or the empty string if it cannot be read */
+std::string _file_contents( std::string const& filename )
+{
+  if ( filename.empty() )
+  {
+    return std::string();
+  }
+  std::ifstream is( filename, std::ios::binary );
+  return std::string( ( std::istreambuf_iterator<char>( is ) ), std::istreambuf_iterator<char>() );
+}
+
+std::vector<std::string> _split_script( std::string const& script )
+{
+  std::vector<std::string> passes;
+
+  std::string::size_type begin = 0u;
+  while ( begin <= script.size() )
+  {
+    auto end = script.find( ';', begin );
+    if ( end == std::string::npos )
+    {
+      end = script.size();
+    }
+
+    auto pass = script.substr( begin, end - begin );
+    pass.erase( std::remove_if( pass.begin(), pass.end(), ::isspace ), pass.end() );
+    if ( !pass.empty() )
+    {
+      passes.push_back( pass );
+    }
+
+    begin = end + 1u;
+  }
+
+  return passes;
+}
+
+/* NPN-based resynthesis for 4-input cuts with the logic network's own gate types */
+template<class LogicNetwork>
+auto _npn_resynthesis()
+{
+  if constexpr ( std::is_same_v<LogicNetwork, mockturtle::aig_network> || std::is_same_v<LogicNetwork, mockturtle::xag_network> )
+  {
+    return mockturtle::xag_npn_resynthesis<LogicNetwork>();
+  }
+  else if constexpr ( std::is_same_v<LogicNetwork, mockturtle::mig_network> )
+  {
+    return mockturtle::mig_npn_resynthesis();
+  }
+  else
+  {
+    return mockturtle::xmg_npn_resynthesis();
+  }
+}
+
+/* classification cache for MC-minimizing resynthesis, shared by all runs; the
+   cache is not thread-safe, every access must hold _minmc_classify_cache_mutex() */
+std::shared_ptr<mockturtle::xag_minmc_classify_cache> const& _minmc_classify_cache()
+{
+  static const auto cache = std::make_shared<mockturtle::xag_minmc_classify_cache>();
+  return cache;
+}
+
+std::mutex& _minmc_classify_cache_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+template<class LogicNetwork>
+std::vector<uint32_t> _num_ands( LogicNetwork const& ntk )
+{
+  if constexpr ( std::is_same_v<LogicNetwork, mockturtle::aig_network> || std::is_same_v<LogicNetwork, mockturtle::xag_network> )
+  {
+    uint32_t num_ands{0u};
+    ntk.foreach_gate( [&]( auto const& n ) {
+      if ( ntk.is_and( n ) )
+      {
+        ++num_ands;
+      }
+    } );
+    return {num_ands};
+  }
+  else
+  {
+    (void)ntk;
+    return {};
+  }
+}
+
+template<class LogicNetwork>
+void _optimization_pass( LogicNetwork& ntk, std::string const& pass, std::string const& minmc_database )
+{
+  if constexpr ( std::is_same_v<LogicNetwork, mockturtle::klut_network> )
+  {
+    throw "optimization is not supported for k-LUT networks";
+  }
+  else
+  {
+    if ( pass == "rw" )
+    {
+      auto resyn = _npn_resynthesis<LogicNetwork>();
+      mockturtle::cut_rewriting_params ps;
+      ps.cut_enumeration_ps.cut_size = 4u;
+      mockturtle::cut_rewriting( ntk, resyn, ps );
+    }
+    else if ( pass == "rf" )
+    {
+      auto resyn = _npn_resynthesis<LogicNetwork>();
+      mockturtle::refactoring_params ps;
+      ps.max_pis = 4u;
+      mockturtle::refactoring( ntk, resyn, ps );
+    }
+    else if ( pass == "rs" )
+    {
+      mockturtle::depth_view depth_ntk{ntk};
+      mockturtle::fanout_view fanout_ntk{depth_ntk};
+      if constexpr ( std::is_same_v<LogicNetwork, mockturtle::aig_network> )
+      {
+        mockturtle::aig_resubstitution( fanout_ntk );
+      }
+      else if constexpr ( std::is_same_v<LogicNetwork, mockturtle::mig_network> )
+      {
+        mockturtle::mig_resubstitution( fanout_ntk );
+      }
+      else
+      {
+        throw "resubstitution (rs) is only supported for AIGs and MIGs";
+      }
+    }
+    else if ( pass == "mc" )
+    {
+      if constexpr ( std::is_same_v<LogicNetwork, mockturtle::xag_network> )
+      {
+        if ( minmc_database.empty() )
+        {
+          throw "MC-minimizing rewriting (mc) requires a database file";
+        }
+
+        mockturtle::xag_minmc_resynthesis resyn( minmc_database, _minmc_classify_cache() );
+        mockturtle::cut_rewriting_params ps;
+        ps.cut_enumeration_ps.cut_size = 6u;
+        mockturtle::cut_rewriting( ntk, resyn, ps, nullptr, mockturtle::mc_cost<LogicNetwork>() );
+      }
+      else
+      {
+        throw "MC-minimizing rewriting (mc) is only supported for XAGs";
+      }
+    }
+    else if ( pass == "ad" )
+    {
+      mockturtle::depth_view depth_ntk{ntk};
+      if constexpr ( std::is_same_v<LogicNetwork, mockturtle::mig_network> )
+      {
+        mockturtle::mig_algebraic_depth_rewriting( depth_ntk );
+      }
+      else if constexpr ( std::is_same_v<LogicNetwork, mockturtle::xmg_network> )
+      {
+        mockturtle::xmg_algebraic_depth_rewriting( depth_ntk );
+      }
+      else
+      {
+        throw "algebraic depth rewriting (ad) is only supported for MIGs and XMGs";
+      }
+    }
+    else
+    {
+      throw "unknown optimization pass: " + pass;
+    }
+
+    ntk = mockturtle::cleanup_dangling( ntk );
+  }
+}
+
+/* runs the optimization script up to `rounds` times, and stops early once a
+   round reduces neither the number of gates nor the number of AND gates;
+   records the number of gates (and AND gates for AIGs and XAGs) before
+   optimization and after each pass */
+template<class LogicNetwork>
+void _optimize( LogicNetwork& ntk, std::string const& script, uint32_t rounds, std::string const& minmc_database, std::string const& minmc_cache, std::unordered_map<std::string, std::vector<uint32_t>>& stats )
+{
+  const auto passes = _split_script( script );
+
+  auto& sizes = stats["optimization_sizes"];
+  auto& num_ands = stats["optimization_num_ands"];
+  const auto record = [&]() {
+    sizes.push_back( ntk.num_gates() );
+    for ( auto n : _num_ands( ntk ) )
+    {
+      num_ands.push_back( n );
+    }
+  };
+
+  record();
+
+  /* concurrent runs that use the classification cache are serialized */
+  std::unique_lock<std::mutex> cache_lock( _minmc_classify_cache_mutex(), std::defer_lock );
+  if ( std::find( passes.begin(), passes.end(), "mc" ) != passes.end() || ( !passes.empty() && !minmc_cache.empty() ) )
+  {
+    cache_lock.lock();
+  }
+
+  if ( !passes.empty() && !minmc_cache.empty() )
+  {
+    _minmc_classify_cache()->load( minmc_cache );
+  }
+
+  for ( auto round = 0u; !passes.empty() && round < rounds; ++round )
+  {
+    const auto size_before = sizes.back();
+    const auto num_ands_before = num_ands.empty() ? 0u : num_ands.back();
+    for ( auto const& pass : passes )
+    {
+      _optimization_pass( ntk, pass, minmc_database );
+      record();
+    }
+
+    if ( sizes.back() >= size_before && ( num_ands.empty() || num_ands.back() >= num_ands_before ) )
+    {
+      break;
+    }
+  }
+
+  if ( !passes.empty() && !minmc_cache.empty() )
+  {
+    _minmc_classify_cache()->save( minmc_cache );
+  }
+
+  if ( num_ands.empty() )
+  {
+    stats.erase( "optimization_num_ands" );
+  }
+}
+
 using lut_synthesis_t = std::function<void( netlist_t&, std::vector<tweedledum::qubit_id> const&, kitty::dynamic_truth_table const& )>;
 
+/* spectrum-based single-target gate synthesis that stops rewiring at `token` and keeps the best wiring found so far */
+tweedledum::stg_from_spectrum_params _stg_from_spectrum_params( cancellation_token const& token )
+{
+  tweedledum::stg_from_spectrum_params ps;
+  ps.gs_params.cp_params.token = &token;
+  return ps;
+}
+
 template<class LogicNetwork>
 std::pair<netlist_t, std::unordered_map<std::string, std::vector<uint32_t>>>
-_lhrs_wrapper( std::string const& filename, mapping_strategy_type strategy_type, lut_synthesis_t const& lut_synthesis, uint32_t num_pebbles )
+_lhrs_wrapper( std::string const& filename, mapping_strategy_type strategy_type, lut_synthesis_t const& lut_synthesis, caterpillar::lut_cost_model lut_cost, uint32_t num_pebbles, std::string const& optimize, uint32_t optimize_rounds, std::string const& minmc_database, std::string const& minmc_cache, sat_solver_type sat_solver, bool lazy_cardinality, double tradeoff, cancellation_token const& token )
 {
   LogicNetwork ntk;
 
@@ -99,6 +377,9 @@ _lhrs_wrapper( std::string const& filename, mapping_strategy_type strategy_type,
     throw "unknown file extension: " + ext;
   }
 
+  std::unordered_map<std::string, std::vector<uint32_t>> stats;
+  _optimize( ntk, optimize, optimize_rounds, minmc_database, minmc_cache, stats );
+
   auto strategy = [&]() -> std::shared_ptr<caterpillar::mapping_strategy<LogicNetwork>> {
     switch ( strategy_type )
     {
@@ -112,16 +393,59 @@ _lhrs_wrapper( std::string const& filename, mapping_strategy_type strategy_type,
       case mapping_strategy_type::pebbling: {
         caterpillar::pebbling_mapping_strategy_params ps;
         ps.pebble_limit = num_pebbles;
+        ps.solver_type = sat_solver == sat_solver_type::glucose ? percy::SLV_BMCG : percy::SLV_BSAT2;
+        ps.lazy_cardinality = lazy_cardinality;
+        ps.token = &token;
         return std::make_shared<caterpillar::pebbling_mapping_strategy<LogicNetwork>>( ps );
       }
+      case mapping_strategy_type::heuristic_pebbling: {
+        caterpillar::heuristic_pebbling_mapping_strategy_params ps;
+        ps.pebble_limit = num_pebbles;
+        ps.tradeoff = tradeoff;
+        return std::make_shared<caterpillar::heuristic_pebbling_mapping_strategy<LogicNetwork>>( ps );
+      }
+      case mapping_strategy_type::best_fit: {
+        caterpillar::best_fit_mapping_strategy_params ps;
+        ps.num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+        ps.cost_model = lut_cost;
+        return std::make_shared<caterpillar::best_fit_mapping_strategy<LogicNetwork>>( ps );
+      }
+      case mapping_strategy_type::xag:
+        if constexpr ( std::is_same_v<LogicNetwork, mockturtle::xag_network> )
+        {
+          return std::make_shared<caterpillar::xag_mapping_strategy>();
+        }
+        else
+        {
+          throw "XAG mapping strategy requires XAG network type";
+        }
     }
   }();
 
   netlist_t circ;
   caterpillar::logic_network_synthesis_stats st;
-  caterpillar::logic_network_synthesis( circ, ntk, *strategy, lut_synthesis, {}, &st );
+  if ( !caterpillar::logic_network_synthesis( circ, ntk, *strategy, lut_synthesis, {}, &st ) )
+  {
+    if ( token.is_canceled() )
+    {
+      throw timeout_error( "lhrs stopped at its timeout before a mapping was found" );
+    }
+
+    /* the heuristic did not meet the pebble limit */
+    if ( strategy_type == mapping_strategy_type::heuristic_pebbling )
+    {
+      circ = netlist_t();
+      st = caterpillar::logic_network_synthesis_stats();
+      caterpillar::bennett_mapping_strategy<LogicNetwork> bennett;
+      caterpillar::logic_network_synthesis( circ, ntk, bennett, lut_synthesis, {}, &st );
+      stats["bennett_fallback"] = {1u};
+    }
+  }
+  else if ( strategy_type == mapping_strategy_type::heuristic_pebbling )
+  {
+    stats["bennett_fallback"] = {0u};
+  }
 
-  std::unordered_map<std::string, std::vector<uint32_t>> stats;
   stats["input_indexes"] = st.i_indexes;
   stats["output_indexes"] = st.o_indexes;
 
@@ -194,30 +518,39 @@ void synthesis( py::module m )
       .export_values();
 
   m.def(
-      "oracle_synth", []( truth_table_t const& function, oracle_synth_type kind ) {
-        netlist_t circ;
-        for ( auto i = 0u; i < function.num_vars() + 1u; ++i )
-        {
-          circ.add_qubit();
-        }
-        std::vector<tweedledum::qubit_id> qubits( function.num_vars() + 1u );
-        std::iota( qubits.begin(), qubits.end(), 0u );
+      "oracle_synth", []( truth_table_t const& function, oracle_synth_type kind, std::optional<double> timeout ) {
+        const auto make_key = [&]( byte_writer& key ) {
+          key.write( std::string( "oracle_synth" ) );
+          key.write( kind );
+          key.write( static_cast<uint32_t>( function.num_vars() ) );
+          key.write( std::vector<uint64_t>( function.begin(), function.end() ) );
+        };
+        cancellation_token token( _time_budget( timeout ) );
+        return _cached<netlist_t>( make_key, [&]() { return _interruptible( token, [&]() {
+          netlist_t circ;
+          for ( auto i = 0u; i < function.num_vars() + 1u; ++i )
+          {
+            circ.add_qubit();
+          }
+          std::vector<tweedledum::qubit_id> qubits( function.num_vars() + 1u );
+          std::iota( qubits.begin(), qubits.end(), 0u );
 
-        switch ( kind )
-        {
-        default:
-        case oracle_synth_type::spectrum:
-          tweedledum::stg_from_spectrum()( circ, qubits, function );
-          break;
-        case oracle_synth_type::pkrm:
-          tweedledum::stg_from_pkrm()( circ, qubits, function );
-          break;
-        case oracle_synth_type::pprm:
-          tweedledum::stg_from_pprm()( circ, qubits, function );
-          break;
-        }
+          switch ( kind )
+          {
+          default:
+          case oracle_synth_type::spectrum:
+            tweedledum::stg_from_spectrum( _stg_from_spectrum_params( token ) )( circ, qubits, function );
+            break;
+          case oracle_synth_type::pkrm:
+            tweedledum::stg_from_pkrm()( circ, qubits, function );
+            break;
+          case oracle_synth_type::pprm:
+            tweedledum::stg_from_pprm()( circ, qubits, function );
+            break;
+          }
 
-        return circ;
+          return circ;
+        } ); }, &token );
       },
       R"doc(
     Oracle synthesis
@@ -225,11 +558,83 @@ void synthesis( py::module m )
     Creates a quantum circuit that flips the target qubit based on a Boolean
     function.  The target qubit is the last qubit in the circuit.
 
+    The ``spectrum`` kind searches for a qubit wiring that minimizes the
+    number of CNOT gates.  If ``timeout`` seconds have passed, the search
+    stops and the best wiring found so far is used.
+
     :param truth_table function: Oracle function
     :param oracle_synth_type kind: Synthesis type
+    :param float timeout: Time limit in seconds (no limit if None)
     :rtype: netlist
 )doc",
-      "function"_a, "kind"_a = oracle_synth_type::spectrum );
+      "function"_a, "kind"_a = oracle_synth_type::spectrum, "timeout"_a = py::none() );
+
+  enum class phase_oracle_synth_type
+  {
+    pkrm,
+    pprm,
+    exorlink,
+    spectrum
+  };
+
+  py::enum_<phase_oracle_synth_type>( m, "phase_oracle_synth_type", "Phase oracle synthesis kind enumeration" )
+      .value( "pkrm", phase_oracle_synth_type::pkrm )
+      .value( "pprm", phase_oracle_synth_type::pprm )
+      .value( "exorlink", phase_oracle_synth_type::exorlink )
+      .value( "spectrum", phase_oracle_synth_type::spectrum )
+      .export_values();
+
+  m.def(
+      "phase_oracle_synth", []( truth_table_t const& function, phase_oracle_synth_type kind ) {
+        const auto make_key = [&]( byte_writer& key ) {
+          key.write( std::string( "phase_oracle_synth" ) );
+          key.write( kind );
+          key.write( static_cast<uint32_t>( function.num_vars() ) );
+          key.write( std::vector<uint64_t>( function.begin(), function.end() ) );
+        };
+        return _cached<netlist_t>( make_key, [&]() {
+          using esop_type = tweedledum::esop_phase_synth_params::esop_type;
+          tweedledum::esop_phase_synth_params ps;
+
+          switch ( kind )
+          {
+          default:
+          case phase_oracle_synth_type::spectrum:
+            return tweedledum::spectrum_phase_synth<netlist_t>( function );
+          case phase_oracle_synth_type::pkrm:
+            ps.esop = esop_type::pkrm;
+            break;
+          case phase_oracle_synth_type::pprm:
+            ps.esop = esop_type::pprm;
+            break;
+          case phase_oracle_synth_type::exorlink:
+            ps.esop = esop_type::exorlink;
+            break;
+          }
+          return tweedledum::esop_phase_synth<netlist_t>( function, ps );
+        } );
+      },
+      R"doc(
+    Phase oracle synthesis
+
+    Creates a quantum circuit that flips the phase of the computational basis
+    states for which a Boolean function evaluates to true, i.e., it realizes
+    the diagonal unitary with entries :math:`(-1)^{f(x)}` (up to a global
+    phase).  Compared to :func:`oracle_synth`, it requires no target qubit, and
+    hence no Hadamard gates on the target.
+
+    The ``spectrum`` kind computes rotation angles from the function's
+    Rademacher-Walsh spectrum and synthesizes {CNOT, Rz} circuits with
+    Gray synthesis.  The other kinds compute an ESOP expression of the function
+    (``pprm``, ``pkrm``, or a PKRM expression improved with EXORLINK cube
+    transformations for ``exorlink``) and add one multiple-controlled Z gate
+    for each cube.
+
+    :param truth_table function: Oracle function
+    :param phase_oracle_synth_type kind: Synthesis type
+    :rtype: netlist
+)doc",
+      "function"_a, "kind"_a = phase_oracle_synth_type::spectrum );
 
   m.def(
       "diagonal_synth", [&]( std::vector<double> const& angles ) {
@@ -249,39 +654,85 @@ void synthesis( py::module m )
 )doc" );
 
   m.def(
-      "dbs", []( std::vector<uint32_t> const& perm, oracle_synth_type kind ) {
-        switch ( kind )
-        {
-        default:
-        case oracle_synth_type::spectrum:
-          return tweedledum::dbs<netlist_t>( perm, tweedledum::stg_from_spectrum() );
-        case oracle_synth_type::pkrm:
-          return tweedledum::dbs<netlist_t>( perm, tweedledum::stg_from_pkrm() );
-        case oracle_synth_type::pprm:
-          return tweedledum::dbs<netlist_t>( perm, tweedledum::stg_from_pprm() );
-        }
+      "dbs", []( std::vector<uint32_t> const& perm, oracle_synth_type kind, std::optional<double> timeout ) {
+        const auto make_key = [&]( byte_writer& key ) {
+          key.write( std::string( "dbs" ) );
+          key.write( kind );
+          key.write( perm );
+        };
+        cancellation_token token( _time_budget( timeout ) );
+        return _cached<netlist_t>( make_key, [&]() { return _interruptible( token, [&]() {
+          tweedledum::dbs_params ps;
+          ps.token = &token;
+
+          const auto circ = [&]() {
+            switch ( kind )
+            {
+            default:
+            case oracle_synth_type::spectrum:
+              return tweedledum::dbs<netlist_t>( perm, tweedledum::stg_from_spectrum( _stg_from_spectrum_params( token ) ), ps );
+            case oracle_synth_type::pkrm:
+              return tweedledum::dbs<netlist_t>( perm, tweedledum::stg_from_pkrm(), ps );
+            case oracle_synth_type::pprm:
+              return tweedledum::dbs<netlist_t>( perm, tweedledum::stg_from_pprm(), ps );
+            }
+          }();
+
+          if ( token.is_canceled() && circ.num_gates() == 0u && !_is_identity( perm ) )
+          {
+            throw timeout_error( "dbs stopped at its timeout" );
+          }
+          return circ;
+        } ); }, &token );
       },
       R"doc(
     Decomposition-based synthesis
 
+    If ``timeout`` seconds have passed before the permutation is decomposed,
+    a ``TimeoutError`` is raised.  Afterwards, single-target gates of the
+    ``spectrum`` kind are synthesized with the best qubit wiring found so far.
+
     :param List[int] perm: A permutation of the values :math:`\{0, \dots, 2^n - 1\}`.
     :param oracle_synth_type kind: Synthesis type
+    :param float timeout: Time limit in seconds (no limit if None)
     :rtype: netlist
 
     .. seealso:: `tweedledum documentation for dbs <https://tweedledum.readthedocs.io/en/latest/algorithms/synthesis/dbs.html>`_
 )doc",
-      "perm"_a, "kind"_a = oracle_synth_type::spectrum );
+      "perm"_a, "kind"_a = oracle_synth_type::spectrum, "timeout"_a = py::none() );
 
   m.def(
-      "tbs", []( std::vector<uint32_t> const& perm ) { return tweedledum::tbs<netlist_t>( perm ); }, R"doc(
+      "tbs", []( std::vector<uint32_t> const& perm, std::optional<double> timeout ) {
+        const auto make_key = [&]( byte_writer& key ) {
+          key.write( std::string( "tbs" ) );
+          key.write( perm );
+        };
+        cancellation_token token( _time_budget( timeout ) );
+        return _cached<netlist_t>( make_key, [&]() { return _interruptible( token, [&]() {
+          tweedledum::tbs_params ps;
+          ps.token = &token;
+
+          const auto circ = tweedledum::tbs<netlist_t>( perm, ps );
+          if ( token.is_canceled() && circ.num_gates() == 0u && !_is_identity( perm ) )
+          {
+            throw timeout_error( "tbs stopped at its timeout" );
+          }
+          return circ;
+        } ); }, &token );
+      },
+      R"doc(
     Transformation based synthesis
 
+    If ``timeout`` seconds have passed before the circuit is complete, a
+    ``TimeoutError`` is raised.
+
     :param List[int] perm: A permutation of the values :math:`\{0, \dots, 2^n - 1\}`.
+    :param float timeout: Time limit in seconds (no limit if None)
     :rtype: netlist
 
     .. seealso:: `tweedledum documentation for tbs <https://tweedledum.readthedocs.io/en/latest/algorithms/synthesis/tbs.html>`_
 )doc",
-      "perm"_a );
+      "perm"_a, "timeout"_a = py::none() );
 
   enum class lhrs_network_type
   {
@@ -305,16 +756,26 @@ void synthesis( py::module m )
       .value( "bennett_inplace", mapping_strategy_type::bennett_inplace )
       .value( "eager", mapping_strategy_type::eager )
       .value( "pebbling", mapping_strategy_type::pebbling )
+      .value( "heuristic_pebbling", mapping_strategy_type::heuristic_pebbling )
+      .value( "best_fit", mapping_strategy_type::best_fit )
+      .value( "xag", mapping_strategy_type::xag )
+      .export_values();
+
+  py::enum_<sat_solver_type>( m, "sat_solver_type", "SAT solver back-end" )
+      .value( "bsat", sat_solver_type::bsat )
+      .value( "glucose", sat_solver_type::glucose )
       .export_values();
 
   m.def(
-      "lhrs", []( std::string const& filename, lhrs_network_type network_type, mapping_strategy_type strategy, oracle_synth_type lut_synthesis, uint32_t num_pebbles ) {
+      "lhrs", []( std::string const& filename, lhrs_network_type network_type, mapping_strategy_type strategy, oracle_synth_type lut_synthesis, uint32_t num_pebbles, std::string const& optimize, uint32_t optimize_rounds, std::string const& minmc_database, std::string const& minmc_cache, sat_solver_type sat_solver, bool lazy_cardinality, double tradeoff, std::optional<double> timeout ) {
+        cancellation_token token( _time_budget( timeout ) );
+
         const auto lut_synthesis_fn = [&]() {
           switch ( lut_synthesis )
           {
           default:
           case oracle_synth_type::spectrum:
-            return lut_synthesis_t( tweedledum::stg_from_spectrum{} );
+            return lut_synthesis_t( tweedledum::stg_from_spectrum( _stg_from_spectrum_params( token ) ) );
           case oracle_synth_type::pprm:
             return lut_synthesis_t( tweedledum::stg_from_pprm{} );
           case oracle_synth_type::pkrm:
@@ -322,20 +783,53 @@ void synthesis( py::module m )
           }
         }();
 
-        switch ( network_type )
-        {
-        case lhrs_network_type::aig:
-          return _lhrs_wrapper<mockturtle::aig_network>( filename, strategy, lut_synthesis_fn, num_pebbles );
-        default:
-        case lhrs_network_type::xag:
-          return _lhrs_wrapper<mockturtle::xag_network>( filename, strategy, lut_synthesis_fn, num_pebbles );
-        case lhrs_network_type::mig:
-          return _lhrs_wrapper<mockturtle::mig_network>( filename, strategy, lut_synthesis_fn, num_pebbles );
-        case lhrs_network_type::xmg:
-          return _lhrs_wrapper<mockturtle::xmg_network>( filename, strategy, lut_synthesis_fn, num_pebbles );
-        case lhrs_network_type::klut:
-          return _lhrs_wrapper<mockturtle::klut_network>( filename, strategy, lut_synthesis_fn, num_pebbles );
-        }
+        /* LUT functions are mapped according to the cost of their synthesis */
+        const auto lut_cost = [&]() {
+          switch ( lut_synthesis )
+          {
+          default:
+          case oracle_synth_type::spectrum:
+            return caterpillar::lut_cost_model::spectrum;
+          case oracle_synth_type::pprm:
+            return caterpillar::lut_cost_model::lut_count;
+          case oracle_synth_type::pkrm:
+            return caterpillar::lut_cost_model::pkrm;
+          }
+        }();
+
+        /* the file contents and the file extension determine the logic network */
+        const auto make_key = [&]( byte_writer& key ) {
+          key.write( std::string( "lhrs" ) );
+          key.write( _file_contents( filename ) );
+          key.write( _filename_extension( filename ) );
+          key.write( network_type );
+          key.write( strategy );
+          key.write( lut_synthesis );
+          key.write( num_pebbles );
+          key.write( optimize );
+          key.write( optimize_rounds );
+          key.write( _file_contents( minmc_database ) );
+          key.write( sat_solver );
+          key.write( lazy_cardinality );
+          key.write( tradeoff );
+        };
+
+        return _cached<std::pair<netlist_t, std::unordered_map<std::string, std::vector<uint32_t>>>>( make_key, [&]() { return _interruptible( token, [&]() {
+          switch ( network_type )
+          {
+          case lhrs_network_type::aig:
+            return _lhrs_wrapper<mockturtle::aig_network>( filename, strategy, lut_synthesis_fn, lut_cost, num_pebbles, optimize, optimize_rounds, minmc_database, minmc_cache, sat_solver, lazy_cardinality, tradeoff, token );
+          default:
+          case lhrs_network_type::xag:
+            return _lhrs_wrapper<mockturtle::xag_network>( filename, strategy, lut_synthesis_fn, lut_cost, num_pebbles, optimize, optimize_rounds, minmc_database, minmc_cache, sat_solver, lazy_cardinality, tradeoff, token );
+          case lhrs_network_type::mig:
+            return _lhrs_wrapper<mockturtle::mig_network>( filename, strategy, lut_synthesis_fn, lut_cost, num_pebbles, optimize, optimize_rounds, minmc_database, minmc_cache, sat_solver, lazy_cardinality, tradeoff, token );
+          case lhrs_network_type::xmg:
+            return _lhrs_wrapper<mockturtle::xmg_network>( filename, strategy, lut_synthesis_fn, lut_cost, num_pebbles, optimize, optimize_rounds, minmc_database, minmc_cache, sat_solver, lazy_cardinality, tradeoff, token );
+          case lhrs_network_type::klut:
+            return _lhrs_wrapper<mockturtle::klut_network>( filename, strategy, lut_synthesis_fn, lut_cost, num_pebbles, optimize, optimize_rounds, minmc_database, minmc_cache, sat_solver, lazy_cardinality, tradeoff, token );
+          }
+        } ); }, &token );
       }, R"doc(
     LUT-based hierarchical reversible logic synthesis
 
@@ -356,12 +850,83 @@ void synthesis( py::module m )
     | BENCH (``*.bench``) | klut                           |
     +---------------------+--------------------------------+
 
+    The logic network can be optimized before mapping with an optimization
+    script of semicolon-separated passes, e.g., ``"rw;rs;rf"``.  The script is
+    repeated up to ``optimize_rounds`` times, but stops as soon as a round does
+    not reduce the number of gates.  The following passes are available:
+
+    +------+-------------------------------------------+-------------------------+
+    | Pass | Algorithm                                 | Logic network types     |
+    +======+===========================================+=========================+
+    | rw   | Cut rewriting with NPN databases          | aig, xag, mig, xmg      |
+    +------+-------------------------------------------+-------------------------+
+    | rf   | Refactoring with NPN databases            | aig, xag, mig, xmg      |
+    +------+-------------------------------------------+-------------------------+
+    | rs   | Resubstitution                            | aig, mig                |
+    +------+-------------------------------------------+-------------------------+
+    | ad   | Algebraic depth rewriting                 | mig, xmg                |
+    +------+-------------------------------------------+-------------------------+
+    | mc   | Cut rewriting minimizing AND gates        | xag                     |
+    +------+-------------------------------------------+-------------------------+
+
+    The number of gates before optimization and after each pass is returned
+    in the statistics under the key ``optimization_sizes``, and for AIGs and
+    XAGs the number of AND gates under the key ``optimization_num_ands``.
+
+    The ``mc`` pass minimizes the multiplicative complexity, i.e., the number
+    of AND gates, which determines the T-count of the resulting circuit.  It
+    requires a database of MC-optimum circuits for 6-input functions
+    (``minmc_database``).  Spectral classifications of functions are cached
+    across calls, and the cache can be kept on disk (``minmc_cache``).  For
+    XAGs, the ``xag`` mapping strategy computes XOR gates in-place and only
+    allocates ancillae for AND gates, e.g.,
+    ``lhrs("f.v", optimize="mc", minmc_database="db.txt", strategy=mapping_strategy.xag)``.
+
+    The ``best_fit`` mapping strategy first maps the network into large LUTs
+    and then remaps each LUT into smaller LUTs as long as there are enough
+    clean ancillae available at that point to store the intermediate results.
+    It requires fewer ancillae than the Bennett strategies without solving a
+    pebbling problem.  LUTs are remapped on all available hardware threads.
+    For ``spectrum`` and ``pkrm`` LUT synthesis, the remapping minimizes the
+    estimated gate count of the synthesized LUTs rather than their number.
+
+    The ``heuristic_pebbling`` strategy meets the pebble limit without a SAT
+    solver by pebbling topological segments of the network recursively.
+    ``tradeoff`` selects between the fewest gates (1, default) and the fewest
+    qubits (0) among the schedules it finds within the limit.  Without a
+    limit and with ``tradeoff`` of 1, Bennett's schedule is used.  The
+    heuristic may miss pebble limits that are feasible, which is more likely
+    the more primary outputs the network has.  In that case the circuit is
+    computed with the ``bennett`` strategy instead, which exceeds the limit.
+    The statistics report this under the key ``bennett_fallback`` (1 if
+    Bennett's strategy was used, 0 otherwise).
+
+    The ``pebbling`` strategy encodes the pebble limit into the SAT problem
+    at every step.  With ``lazy_cardinality``, the limit is only added at the
+    steps that exceed it in a solution, and the problem is solved again until
+    no step exceeds it.  This often leads to smaller SAT problems for large
+    networks.
+
+    If ``timeout`` seconds have passed, the ``pebbling`` strategy keeps the
+    best pebbling strategy found so far, and ``spectrum`` LUT synthesis uses
+    the best qubit wiring found so far.  If the pebbling strategy has not
+    found any solution, a ``TimeoutError`` is raised.
+
     :param string filename: Filename to a logic network
     :param lhrs_network_type network_type: Logic network representation type
     :param mapping_strategy strategy: Qubit mapping strategy
     :param oracle_synth_type lut_synthesis: Oracle synthesis method for LUT functions
+    :param int num_pebbles: Maximum number of pebbles for the pebbling strategies
+    :param sat_solver_type sat_solver: SAT solver back-end for the pebbling strategy
+    :param bool lazy_cardinality: Add the pebble limit of the pebbling strategy only at steps that exceed it
+    :param float tradeoff: Trade-off between gates (1) and qubits (0) for the heuristic pebbling strategy
+    :param string optimize: Optimization script that is applied before mapping
+    :param int optimize_rounds: Maximum number of times the optimization script is applied
+    :param string minmc_database: Database file for MC-minimizing rewriting
+    :param string minmc_cache: File to load and store the classification cache for MC-minimizing rewriting
+    :param float timeout: Time limit in seconds (no limit if None)
     :rtype: (netlist, dict)
-)doc", "filename"_a, "network_type"_a = lhrs_network_type::xag, "strategy"_a = mapping_strategy_type::bennett_inplace, "lut_synthesis"_a = oracle_synth_type::spectrum, "num_pebbles"_a = 0u );
+)doc", "filename"_a, "network_type"_a = lhrs_network_type::xag, "strategy"_a = mapping_strategy_type::bennett_inplace, "lut_synthesis"_a = oracle_synth_type::spectrum, "num_pebbles"_a = 0u, "optimize"_a = "", "optimize_rounds"_a = 1u, "minmc_database"_a = "", "minmc_cache"_a = "", "sat_solver"_a = sat_solver_type::bsat, "lazy_cardinality"_a = false, "tradeoff"_a = 1.0, "timeout"_a = py::none() );
 }
 
 } // namespace revkit
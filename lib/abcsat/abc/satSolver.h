@@ -172,6 +172,7 @@ struct sat_solver_t
     ABC_INT64_T nConfLimit;    // external limit on the number of conflicts
     ABC_INT64_T nInsLimit;     // external limit on the number of implications
     abctime     nRuntimeLimit; // external limit on runtime
+    int *       pStop;         // external stop flag (checked before each decision)
 
     veci        act_vars;      // variables whose activity has changed
     double*     factors;       // the activity factors
@@ -301,6 +302,21 @@ static inline abctime sat_solver_set_runtime_limit(sat_solver* s, abctime Limit)
     return nRuntimeLimit;
 }
 
+static inline void sat_solver_set_stop(sat_solver* s, int * pStop)
+{
+    s->pStop = pStop;
+}
+
+static inline int sat_solver_stop_requested(sat_solver* s)
+{
+    // the flag may be raised by another thread
+#if defined(__GNUC__) || defined(__clang__)
+    return s->pStop && __atomic_load_n(s->pStop, __ATOMIC_RELAXED);
+#else
+    return s->pStop && *(volatile int *)s->pStop;
+#endif
+}
+
 static inline int sat_solver_set_random(sat_solver* s, int fNotUseRandom)
 {
     int fNotUseRandomOld = s->fNotUseRandom;
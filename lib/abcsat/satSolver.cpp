@@ -1969,7 +1969,7 @@ static lbool sat_solver_search(sat_solver* s, ABC_INT64_T nof_conflicts)
             int next;
 
             // Reached bound on number of conflicts:
-            if ( (!s->fNoRestarts && nof_conflicts >= 0 && conflictC >= nof_conflicts) || (s->nRuntimeLimit && (s->stats.conflicts & 63) == 0 && Abc_Clock() > s->nRuntimeLimit)){
+            if ( (!s->fNoRestarts && nof_conflicts >= 0 && conflictC >= nof_conflicts) || (s->nRuntimeLimit && (s->stats.conflicts & 63) == 0 && Abc_Clock() > s->nRuntimeLimit) || sat_solver_stop_requested(s)){
                 s->progress_estimate = sat_solver_progress(s);
                 sat_solver_canceluntil(s,s->root_level);
                 veci_delete(&learnt_clause);
@@ -2072,6 +2072,8 @@ int sat_solver_solve_internal(sat_solver* s)
             break;
         if ( s->pFuncStop && s->pFuncStop(s->RunId) )
             break;
+        if ( sat_solver_stop_requested(s) )
+            break;
     }
     if (s->verbosity >= 1)
         printf("==============================================================================\n");
@@ -0,0 +1,250 @@
+/*------------------------------------------------------------------------------
+| This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+| Author(s): Mathias Soeken
+*-----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+#include <easy/esop/cost.hpp>
+#include <easy/esop/esop_from_pkrm.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/hash.hpp>
+#include <kitty/npn.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/spectral.hpp>
+#include <mockturtle/algorithms/cut_enumeration.hpp>
+
+namespace caterpillar
+{
+
+/*! \brief Cost model for the functions of LUTs during LUT mapping. */
+enum class lut_cost_model
+{
+  /*! \brief Each LUT has unit cost (area-oriented mapping). */
+  lut_count,
+  /*! \brief Estimated cost of `tweedledum::stg_from_spectrum`. */
+  spectrum,
+  /*! \brief Estimated cost of `tweedledum::stg_from_pkrm`.
+   *
+   * Computing an optimum PKRM is exponential in the number of variables,
+   * hence mapping strategies should use the `spectrum` estimate for LUTs
+   * with more than `lut_cost_cache::max_cached_vars` variables.
+   */
+  pkrm
+};
+
+/*! \brief Cost of a single-target gate synthesized with `stg_from_spectrum`.
+ *
+ * Number of non-zero coefficients in the Rademacher-Walsh spectrum of the
+ * single-target gate function, each of which is realized by one phase
+ * rotation and accompanying CNOT gates.
+ */
+struct stg_from_spectrum_cost
+{
+  uint32_t operator()( kitty::dynamic_truth_table const& function ) const
+  {
+    auto gate_function = kitty::extend_to( function, function.num_vars() + 1 );
+    auto xt = gate_function.construct();
+    kitty::create_nth_var( xt, function.num_vars() );
+    gate_function &= xt;
+
+    const auto spectrum = kitty::rademacher_walsh_spectrum( gate_function );
+    return static_cast<uint32_t>( std::count_if( spectrum.begin() + 1, spectrum.end(), []( auto s ) { return s != 0; } ) );
+  }
+};
+
+/*! \brief Cost of a single-target gate synthesized with `stg_from_pkrm`.
+ *
+ * Number of multiple-controlled Toffoli gates plus their T-count, i.e.,
+ * roughly the number of Clifford+T gates after decomposition.
+ */
+struct stg_from_pkrm_cost
+{
+  uint32_t operator()( kitty::dynamic_truth_table const& function ) const
+  {
+    const auto esop = easy::esop::esop_from_optimum_pkrm( function );
+    return static_cast<uint32_t>( esop.size() + easy::esop::T_count( esop, function.num_vars() + 1 ) );
+  }
+};
+
+/*! \brief Cache of LUT function costs.
+ *
+ * Both cost functions are invariant under permuting and complementing
+ * inputs and (up to one gate) under complementing the output.  Costs are
+ * therefore computed once for each NPN class, whose representative is
+ * found with sifting.  Functions with more than `max_cached_vars`
+ * variables are not cached.  The cost of each function is remembered to
+ * skip canonization when it is asked again, but this map is cleared once it
+ * holds `max_cached_functions` entries.  The cache is shared by all LUT
+ * mappings and can be accessed from several threads.
+ */
+template<class CostFn>
+class lut_cost_cache
+{
+public:
+  static constexpr uint32_t max_cached_vars = 10u;
+  static constexpr std::size_t max_cached_functions = 1u << 16u;
+
+  static lut_cost_cache& instance()
+  {
+    static lut_cost_cache cache;
+    return cache;
+  }
+
+  uint32_t operator()( kitty::dynamic_truth_table const& function )
+  {
+    if ( static_cast<uint32_t>( function.num_vars() ) > max_cached_vars )
+    {
+      return cost_fn( function );
+    }
+
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      if ( const auto it = functions.find( function ); it != functions.end() )
+      {
+        return it->second;
+      }
+    }
+
+    const auto repr = std::get<0>( kitty::sifting_npn_canonization( function ) );
+
+    std::unique_lock<std::mutex> lock( mutex );
+    auto it = classes.find( repr );
+    if ( it == classes.end() )
+    {
+      lock.unlock();
+      const auto cost = cost_fn( repr );
+      lock.lock();
+      it = classes.emplace( repr, cost ).first;
+    }
+    if ( functions.size() >= max_cached_functions )
+    {
+      functions.clear();
+    }
+    functions.emplace( function, it->second );
+    return it->second;
+  }
+
+  /*! \brief Number of cached NPN classes. */
+  std::size_t num_classes() const
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    return classes.size();
+  }
+
+private:
+  lut_cost_cache() = default;
+
+private:
+  CostFn cost_fn;
+  mutable std::mutex mutex;
+  std::unordered_map<kitty::dynamic_truth_table, uint32_t, kitty::hash<kitty::dynamic_truth_table>> functions;
+  std::unordered_map<kitty::dynamic_truth_table, uint32_t, kitty::hash<kitty::dynamic_truth_table>> classes;
+};
+
+/*! \brief Cost of a LUT function according to a cost model.
+ *
+ * Functions with fewer than two variables have no cost.
+ */
+inline uint32_t lut_cost( kitty::dynamic_truth_table const& function, lut_cost_model model )
+{
+  if ( function.num_vars() < 2 )
+  {
+    return 0u;
+  }
+
+  switch ( model )
+  {
+  default:
+  case lut_cost_model::lut_count:
+    return 1u;
+  case lut_cost_model::spectrum:
+    return lut_cost_cache<stg_from_spectrum_cost>::instance()( function );
+  case lut_cost_model::pkrm:
+    return lut_cost_cache<stg_from_pkrm_cost>::instance()( function );
+  }
+}
+
+/*! \brief Cut data for quantum-cost-aware LUT mapping.
+ *
+ * Can be passed as `CutData` to `mockturtle::lut_mapping` together with
+ * `StoreFunction` set to `true`.  The area of a cut is the cost of its
+ * function according to `CostFn`, such that area flow and exact area
+ * recovery minimize the total cost of the LUTs rather than their number.
+ */
+template<class CostFn>
+struct cut_enumeration_lut_cost_cut
+{
+  uint32_t delay{0};
+  float flow{0};
+  float cost{0};
+};
+
+} // namespace caterpillar
+
+namespace mockturtle
+{
+
+template<bool ComputeTruth, class CostFn>
+bool operator<( cut_type<ComputeTruth, caterpillar::cut_enumeration_lut_cost_cut<CostFn>> const& c1, cut_type<ComputeTruth, caterpillar::cut_enumeration_lut_cost_cut<CostFn>> const& c2 )
+{
+  constexpr auto eps{0.005f};
+  if ( c1->data.flow < c2->data.flow - eps )
+    return true;
+  if ( c1->data.flow > c2->data.flow + eps )
+    return false;
+  if ( c1->data.delay < c2->data.delay )
+    return true;
+  if ( c1->data.delay > c2->data.delay )
+    return false;
+  return c1.size() < c2.size();
+}
+
+template<class CostFn>
+struct cut_enumeration_update_cut<caterpillar::cut_enumeration_lut_cost_cut<CostFn>>
+{
+  template<typename Cut, typename NetworkCuts, typename Ntk>
+  static void apply( Cut& cut, NetworkCuts const& cuts, Ntk const& ntk, node<Ntk> const& n )
+  {
+    uint32_t delay{0};
+    if ( cut.size() < 2 )
+    {
+      cut->data.cost = 0.0f;
+    }
+    else
+    {
+      cut->data.cost = static_cast<float>( caterpillar::lut_cost_cache<CostFn>::instance()( cuts.truth_table( cut ) ) );
+    }
+
+    float flow = cut->data.cost;
+    for ( auto leaf : cut )
+    {
+      const auto& best_leaf_cut = cuts.cuts( leaf )[0];
+      delay = std::max( delay, best_leaf_cut->data.delay );
+      flow += best_leaf_cut->data.flow;
+    }
+
+    cut->data.delay = 1 + delay;
+    cut->data.flow = flow / ntk.fanout_size( n );
+  }
+};
+
+template<int MaxLeaves, class CostFn>
+std::ostream& operator<<( std::ostream& os, cut<MaxLeaves, cut_data<true, caterpillar::cut_enumeration_lut_cost_cut<CostFn>>> const& c )
+{
+  os << "{ ";
+  std::copy( c.begin(), c.end(), std::ostream_iterator<uint32_t>( os, " " ) );
+  os << "}, D = " << std::setw( 3 ) << c->data.delay << " A = " << c->data.flow << " C = " << c->data.cost;
+  return os;
+}
+
+} // namespace mockturtle
@@ -6,14 +6,18 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 #include <vector>
 
 #include <mockturtle/traits.hpp>
 #include <mockturtle/utils/node_map.hpp>
 #include <mockturtle/views/fanout_view.hpp>
+#include <percy/solvers/bmcg_sat.hpp>
 #include <percy/solvers/bsat2.hpp>
+#include <percy/spec.hpp>
 #include <algorithm>
 
 #include "strategies/action.hpp"
@@ -27,12 +31,14 @@ class pebble_solver
   using Steps = std::vector<std::pair<mockturtle::node<Network>, mapping_strategy_action>>;
 
 public:
-  pebble_solver( Network const& net, uint32_t pebbles )
+  pebble_solver( Network const& net, uint32_t pebbles, percy::SolverType solver_type = percy::SLV_BSAT2, bool lazy_cardinality = false )
       : index_to_gate( net.num_gates() ),
         gate_to_index( net ),
+        solver( make_solver( solver_type ) ),
         _net( net ),
         _pebbles( pebbles ),
-        _nr_gates( net.num_gates() )
+        _nr_gates( net.num_gates() ),
+        _lazy( lazy_cardinality && pebbles > 0 && pebbles < net.num_gates() )
   {
     net.foreach_gate( [&]( auto a, auto i ) {
       gate_to_index[a] = i;
@@ -43,7 +49,9 @@ public:
       o_set.insert( net.get_node( po ) );
     } );
 
-    extra = ( _pebbles < _nr_gates ) ? _pebbles * ( _nr_gates - _pebbles ) : 0;
+    extra = ( !_lazy && _pebbles < _nr_gates ) ? _pebbles * ( _nr_gates - _pebbles ) : 0;
+    _offsets.push_back( 0 );
+    _nr_vars = _nr_gates + extra;
   }
 
   inline uint32_t current_step() const
@@ -51,46 +59,54 @@ public:
     return _nr_steps;
   }
 
+  /*! \brief Makes `solve` return timeout as soon as `*pstop` becomes non-zero (see percy::solver_wrapper::set_stop) */
+  inline void set_stop( int* pstop )
+  {
+    solver->set_stop( pstop );
+  }
+
   inline void add_edge_clause( int p, int p_n, int ch, int ch_n )
   {
     int h[3];
     h[0] = pabc::Abc_Var2Lit( p, 1 );
     h[1] = pabc::Abc_Var2Lit( p_n, 0 );
     h[2] = pabc::Abc_Var2Lit( ch, 0 );
-    solver.add_clause( h, h + 3 );
+    solver->add_clause( h, h + 3 );
 
     h[0] = pabc::Abc_Var2Lit( p, 1 );
     h[1] = pabc::Abc_Var2Lit( p_n, 0 );
     h[2] = pabc::Abc_Var2Lit( ch_n, 0 );
-    solver.add_clause( h, h + 3 );
+    solver->add_clause( h, h + 3 );
 
     h[0] = pabc::Abc_Var2Lit( p, 0 );
     h[1] = pabc::Abc_Var2Lit( p_n, 1 );
     h[2] = pabc::Abc_Var2Lit( ch, 0 );
-    solver.add_clause( h, h + 3 );
+    solver->add_clause( h, h + 3 );
 
     h[0] = pabc::Abc_Var2Lit( p, 0 );
     h[1] = pabc::Abc_Var2Lit( p_n, 1 );
     h[2] = pabc::Abc_Var2Lit( ch_n, 0 );
-    solver.add_clause( h, h + 3 );
+    solver->add_clause( h, h + 3 );
   }
 
   void initialize()
   {
-    solver.set_nr_vars( _nr_gates + extra );
+    solver->set_nr_vars( _nr_vars );
 
     /* set constraint that everything is unpebbled */
     for ( auto v = 0u; v < _nr_gates; v++ )
     {
       int lit = pabc::Abc_Var2Lit( v, 1 ); // zero is not negated
-      solver.add_clause( &lit, &lit + 1 );
+      solver->add_clause( &lit, &lit + 1 );
     }
   }
 
   void add_step()
   {
     _nr_steps++;
-    solver.set_nr_vars( ( _nr_gates + extra ) * ( 1 + _nr_steps ) );
+    _offsets.push_back( _nr_vars );
+    _nr_vars += _nr_gates + extra;
+    solver->set_nr_vars( _nr_vars );
 
     /* encode move */
     _net.foreach_gate( [&]( auto n, auto i ) {
@@ -108,12 +124,12 @@ public:
       } );
     } );
 
-    /* cardinality constraint */
-    if ( ( _pebbles > 0 ) && ( _nr_gates > _pebbles ) )
+    /* cardinality constraint (added on demand in lazy mode) */
+    if ( !_lazy && ( _pebbles > 0 ) && ( _nr_gates > _pebbles ) )
     {
       /* var declaration */
       std::vector<std::vector<int>> card_vars( _nr_gates - _pebbles );
-      auto id_start = _nr_steps * ( _nr_gates + extra ) + _nr_gates;
+      auto id_start = _offsets[_nr_steps] + _nr_gates;
       for ( auto j = 0u; j < _nr_gates - _pebbles; ++j )
       {
         for ( auto k = 0u; k < _pebbles; ++k )
@@ -131,7 +147,7 @@ public:
           int to_or[2];
           to_or[0] = pabc::Abc_Var2Lit( card_vars[j][k], 1 );
           to_or[1] = pabc::Abc_Var2Lit( card_vars[j + 1][k], 0 );
-          solver.add_clause( to_or, to_or + 2 );
+          solver->add_clause( to_or, to_or + 2 );
         }
       }
 
@@ -145,22 +161,22 @@ public:
 
           if ( k == -1 )
           {
-            to_var_or[0] = pabc::Abc_Var2Lit( _nr_steps * ( _nr_gates + extra ) + j + k + 1, 1 );
+            to_var_or[0] = pabc::Abc_Var2Lit( _offsets[_nr_steps] + j + k + 1, 1 );
             to_var_or[1] = pabc::Abc_Var2Lit( card_vars[j][k + 1], 0 );
-            solver.add_clause( to_var_or, to_var_or + 2 );
+            solver->add_clause( to_var_or, to_var_or + 2 );
           }
           else if ( k == static_cast<int>( _pebbles - 1 ) )
           {
-            to_var_or[0] = pabc::Abc_Var2Lit( _nr_steps * ( _nr_gates + extra ) + j + k + 1, 1 );
+            to_var_or[0] = pabc::Abc_Var2Lit( _offsets[_nr_steps] + j + k + 1, 1 );
             to_var_or[1] = pabc::Abc_Var2Lit( card_vars[j][k], 1 );
-            solver.add_clause( to_var_or, to_var_or + 2 );
+            solver->add_clause( to_var_or, to_var_or + 2 );
           }
           else
           {
-            to_var_or[0] = pabc::Abc_Var2Lit( _nr_steps * ( _nr_gates + extra ) + j + k + 1, 1 );
+            to_var_or[0] = pabc::Abc_Var2Lit( _offsets[_nr_steps] + j + k + 1, 1 );
             to_var_or[1] = pabc::Abc_Var2Lit( card_vars[j][k], 1 );
             to_var_or[2] = pabc::Abc_Var2Lit( card_vars[j][k + 1], 0 );
-            solver.add_clause( to_var_or, to_var_or + 3 );
+            solver->add_clause( to_var_or, to_var_or + 3 );
           }
         }
       }
@@ -173,12 +189,102 @@ public:
     _net.foreach_gate( [&]( auto n, auto i ) {
       p[i] = pabc::Abc_Var2Lit( pebble_var( _nr_steps, i ), o_set.count( n ) ? 0 : 1 );
     } );
-    return solver.solve( &p[0], &p[0] + _nr_gates, conflict_limit );
+
+    while ( true )
+    {
+      const auto result = solver->solve( &p[0], &p[0] + _nr_gates, conflict_limit );
+      if ( !_lazy || result != percy::success )
+      {
+        return result;
+      }
+
+      /* refine: bound the pebbles at every step whose schedule exceeds the limit */
+      bool refined = false;
+      for ( auto i = 1u; i <= _nr_steps; ++i )
+      {
+        uint32_t count{0};
+        for ( auto j = 0u; j < _nr_gates; ++j )
+        {
+          count += solver->var_value( pebble_var( i, j ) );
+        }
+        if ( count > _pebbles )
+        {
+          add_cardinality( i );
+          refined = true;
+        }
+      }
+      if ( !refined )
+      {
+        return result;
+      }
+    }
   }
 
   inline int pebble_var( int step, int gate )
   {
-    return step * ( extra + _nr_gates ) + gate;
+    return _offsets[step] + gate;
+  }
+
+  /* at most `_pebbles` pebble variables at `step` are true (totalizer, outputs truncated at `_pebbles + 1`) */
+  void add_cardinality( uint32_t step )
+  {
+    std::vector<std::vector<int>> layer( _nr_gates );
+    for ( auto j = 0u; j < _nr_gates; ++j )
+    {
+      layer[j].push_back( pebble_var( step, j ) );
+    }
+
+    while ( layer.size() > 1u )
+    {
+      std::vector<std::vector<int>> next;
+      for ( auto j = 0u; j + 1u < layer.size(); j += 2u )
+      {
+        auto const& a = layer[j];
+        auto const& b = layer[j + 1u];
+        std::vector<int> o( std::min<std::size_t>( a.size() + b.size(), _pebbles + 1u ) );
+        for ( auto& v : o )
+        {
+          v = _nr_vars++;
+        }
+        solver->set_nr_vars( _nr_vars );
+
+        /* a_i and b_j imply o_(i + j), where a_0 and b_0 are true */
+        for ( auto i = 0u; i <= a.size(); ++i )
+        {
+          for ( auto k = 0u; k <= b.size() && i + k <= o.size(); ++k )
+          {
+            if ( i + k == 0u )
+            {
+              continue;
+            }
+            int lits[3];
+            auto n = 0u;
+            if ( i > 0u )
+            {
+              lits[n++] = pabc::Abc_Var2Lit( a[i - 1u], 1 );
+            }
+            if ( k > 0u )
+            {
+              lits[n++] = pabc::Abc_Var2Lit( b[k - 1u], 1 );
+            }
+            lits[n++] = pabc::Abc_Var2Lit( o[i + k - 1u], 0 );
+            solver->add_clause( lits, lits + n );
+          }
+        }
+        next.push_back( o );
+      }
+      if ( layer.size() % 2u == 1u )
+      {
+        next.push_back( layer.back() );
+      }
+      layer.swap( next );
+    }
+
+    if ( layer[0].size() > _pebbles )
+    {
+      int lit = pabc::Abc_Var2Lit( layer[0][_pebbles], 1 );
+      solver->add_clause( &lit, &lit + 1 );
+    }
   }
 
   Steps extract_result()
@@ -190,7 +296,7 @@ public:
     {
       for ( auto j = 0u; j < _nr_gates; ++j )
       {
-        const auto value = solver.var_value( pebble_var( i, j ) );
+        const auto value = solver->var_value( pebble_var( i, j ) );
         vals_step[i].push_back( value );
       }
     }
@@ -242,7 +348,8 @@ public:
         /* Is j unpebbled at step i? */
         if ( !vals_step[i][j] && vals_step[i - 1][j] )
         {
-          bool redundant = true;
+          /* keeping j pebbled must not exceed the limit, starting at step i */
+          bool redundant = std::count( vals_step[i].begin(), vals_step[i].end(), 1 ) != _pebbles;
           int redundant_until = -1;
           for ( auto ii = i + 1u; ii <= _nr_steps; ++ii )
           {
@@ -334,16 +441,29 @@ public:
   }
 
 private:
+  /* only the back-ends selectable for pebbling are included, any other type falls back to bsat */
+  static std::unique_ptr<percy::solver_wrapper> make_solver( percy::SolverType solver_type )
+  {
+    if ( solver_type == percy::SLV_BMCG )
+    {
+      return std::make_unique<percy::bmcg_wrapper>();
+    }
+    return std::make_unique<percy::bsat_wrapper>();
+  }
+
   std::vector<mockturtle::node<Network>> index_to_gate;
   mockturtle::node_map<int, Network> gate_to_index;
   std::unordered_set<mockturtle::node<Network>> o_set;
 
-  percy::bsat_wrapper solver;
+  std::unique_ptr<percy::solver_wrapper> solver;
   Network const& _net;
   uint32_t _pebbles;
   uint32_t _nr_gates;
   uint32_t _nr_steps = 0;
   uint32_t extra;
+  bool _lazy;
+  std::vector<int> _offsets; /* first variable of each step */
+  int _nr_vars;
 };
 
 } // namespace caterpillar
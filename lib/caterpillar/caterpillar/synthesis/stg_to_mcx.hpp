@@ -15,7 +15,6 @@
 
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
-#include <kitty/esop.hpp>
 #include <kitty/operations.hpp>
 #include <kitty/print.hpp>
 #include <kitty/properties.hpp>
@@ -26,6 +25,8 @@
 
 #include <easy/esop/constructors.hpp>
 #include <easy/esop/cost.hpp>
+#include <easy/esop/esop_from_pkrm.hpp>
+#include <easy/esop/esop_from_pprm.hpp>
 
 namespace caterpillar
 {
@@ -112,13 +113,13 @@ public:
     }
     else if ( is_totally_symmetric( function ) )
     {
-      esop = kitty::esop_from_optimum_pkrm( function );
+      esop = easy::esop::esop_from_optimum_pkrm( function );
       cache.emplace( function, esop );
     }
     else
     {
-      auto const& pprm = kitty::esop_from_pprm( function );
-      auto const& pkrm = kitty::esop_from_optimum_pkrm( function );
+      auto const& pprm = easy::esop::esop_from_pprm( function );
+      auto const& pkrm = easy::esop::esop_from_optimum_pkrm( function );
 
       if ( function.num_vars() >= 5 && pkrm.size() >= 8 )
       {
@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <stack>
+#include <thread>
 #include <vector>
 
 #include <kitty/dynamic_truth_table.hpp>
@@ -23,6 +27,7 @@
 
 #include <fmt/format.h>
 
+#include "../lut_cost.hpp"
 #include "eager_mapping_strategy.hpp"
 #include "mapping_strategy.hpp"
 
@@ -36,6 +41,13 @@ struct best_fit_mapping_strategy_params
 
   /* minimum cut size for remapping */
   uint32_t cut_lower_bound = 4u;
+
+  /* number of threads to remap cells concurrently */
+  uint32_t num_threads = 1u;
+
+  /* cost of LUT functions when remapping cells (cells with more than
+   * lut_cost_cache::max_cached_vars leaves use spectrum instead of pkrm) */
+  lut_cost_model cost_model = lut_cost_model::lut_count;
 };
 
 namespace detail
@@ -75,7 +87,7 @@ public:
   void foreach_node( Fn&& fn ) const
   {
     Ntk::foreach_node( [&]( auto n ) {
-      if ( Ntk::is_constant( n ) || Ntk::is_pi( n ) || Ntk::is_cell_root( n ) )
+      if ( this->is_constant( n ) || this->is_pi( n ) || this->is_cell_root( n ) )
       {
         fn( n );
       }
@@ -85,9 +97,11 @@ public:
   template<class Fn>
   void foreach_fanin( node<Ntk> const& n, Fn&& fn ) const
   {
+    std::vector<signal<Ntk>> fanins;
     Ntk::foreach_cell_fanin( n, [&]( auto n2 ) {
-      fn( Ntk::make_signal( n2 ) );
+      fanins.push_back( this->make_signal( n2 ) );
     } );
+    mockturtle::detail::foreach_element( fanins.begin(), fanins.end(), fn );
   }
 
   uint32_t size() const
@@ -114,7 +128,7 @@ private:
   void init_fanout()
   {
     Ntk::foreach_gate( [&]( auto n ) {
-      if ( !Ntk::is_cell_root( n ) )
+      if ( !this->is_cell_root( n ) )
         return true;
 
       (*_node_to_index)[n] = _index_to_node->size();
@@ -175,30 +189,91 @@ private:
     strategy.compute_steps( cell_ntk );
     const auto [total_ancilla, steps] = first_mapping_pass( strategy );
 
-    /* map the cells */
-    for ( auto const& [n, action, num_dirty_ancilla] : steps )
-    {
+    /* map the cells (independent of each other) */
+    std::vector<typename mapping_strategy<LogicNetwork>::step_vec_t> cell_steps( steps.size() );
+    std::mutex cut_mutex;
+    const auto map_cell = [&]( std::size_t i ) {
+      auto const& [n, action, num_dirty_ancilla] = steps[i];
+      auto& cell_step = cell_steps[i];
       auto num_clean_ancilla = total_ancilla - num_dirty_ancilla;
 
       std::vector<mt::node<LogicNetwork>> leaves;
       mapped_ntk.foreach_cell_fanin( n, [&]( auto c ) {
         leaves.push_back( c );
       } );
-      mt::cut_view cut{_ntk, leaves, n};
+
+      /* cut_view uses the visited flags of the shared network */
+      auto cut = [&]() {
+        std::lock_guard<std::mutex> lock( cut_mutex );
+        return mt::cut_view{_ntk, leaves, n};
+      }();
       mt::mapping_view<decltype( cut ), true> mapped_cut{cut};
       mt::lut_mapping_params lm_ps;
+      const auto cut_function = [&]() {
+        return mt::simulate<kitty::dynamic_truth_table>( cut, mt::default_simulator<kitty::dynamic_truth_table>( leaves.size() ) )[0];
+      };
+      /* optimum PKRMs of large cut functions are too expensive to compute */
+      auto cost_model = ps.cost_model;
+      if ( cost_model == lut_cost_model::pkrm && leaves.size() > lut_cost_cache<stg_from_pkrm_cost>::max_cached_vars )
+      {
+        cost_model = lut_cost_model::spectrum;
+      }
       uint32_t best_cut_size = leaves.size();
-      while ( best_cut_size > ps.cut_lower_bound )
+      auto best_model = lut_cost_model::lut_count;
+      if ( cost_model == lut_cost_model::lut_count )
       {
-        lm_ps.cut_enumeration_ps.cut_size = best_cut_size - 1;
-        mt::lut_mapping<decltype( mapped_cut ), true>( mapped_cut, lm_ps );
-        if ( mapped_cut.num_cells() > num_clean_ancilla + 1 )
+        while ( best_cut_size > ps.cut_lower_bound )
         {
-          break;
+          lm_ps.cut_enumeration_ps.cut_size = best_cut_size - 1;
+          remap( mapped_cut, lm_ps, best_model );
+          if ( mapped_cut.num_cells() > num_clean_ancilla + 1 )
+          {
+            break;
+          }
+          else
+          {
+            best_cut_size--;
+          }
         }
-        else
+      }
+      else
+      {
+        /* among all cut sizes that fit into the clean ancillae, take the
+         * mapping (either area- or cost-oriented) with the smallest cost; all
+         * cells but the root are computed and uncomputed */
+        auto best_cost = lut_cost( cut_function(), cost_model );
+        for ( auto cut_size = best_cut_size; cut_size > ps.cut_lower_bound; --cut_size )
         {
-          best_cut_size--;
+          lm_ps.cut_enumeration_ps.cut_size = cut_size - 1;
+          bool fits{false};
+          for ( auto model : {lut_cost_model::lut_count, cost_model} )
+          {
+            remap( mapped_cut, lm_ps, model );
+            if ( mapped_cut.num_cells() > num_clean_ancilla + 1 )
+            {
+              continue;
+            }
+            fits = true;
+
+            uint32_t cost{0u};
+            mapped_cut.foreach_gate( [&]( auto cell ) {
+              if ( mapped_cut.is_cell_root( cell ) )
+              {
+                cost += ( cell == n ? 1u : 2u ) * lut_cost( mapped_cut.cell_function( cell ), cost_model );
+              }
+            } );
+            if ( cost < best_cost )
+            {
+              best_cost = cost;
+              best_cut_size = cut_size - 1;
+              best_model = model;
+            }
+          }
+
+          if ( !fits )
+          {
+            break;
+          }
         }
       }
 
@@ -209,22 +284,22 @@ private:
         {
           leave_indexes.push_back( _ntk.node_to_index( l ) );
         }
-        const auto func = mt::simulate<kitty::dynamic_truth_table>( cut, mt::default_simulator<kitty::dynamic_truth_table>( leaves.size() ) )[0];
+        const auto func = cut_function();
         if ( std::holds_alternative<compute_action>( action ) )
         {
-          this->steps().emplace_back( n, compute_action{std::make_pair( func, leave_indexes )} );
+          cell_step.emplace_back( n, compute_action{std::make_pair( func, leave_indexes )} );
         }
         else
         {
-          this->steps().emplace_back( n, uncompute_action{std::make_pair( func, leave_indexes )} );
+          cell_step.emplace_back( n, uncompute_action{std::make_pair( func, leave_indexes )} );
         }
       }
       else
       {
         lm_ps.cut_enumeration_ps.cut_size = best_cut_size;
-        mt::lut_mapping<decltype( mapped_cut ), true>( mapped_cut, lm_ps );
+        remap( mapped_cut, lm_ps, best_model );
 
-        auto it = this->steps().end();
+        auto it = cell_step.end();
         mt::node<LogicNetwork> po;
         bool is_computing = std::holds_alternative<compute_action>( action );
         cut.foreach_po( [&]( auto f ) {
@@ -243,25 +318,75 @@ private:
           {
             if ( is_computing )
             {
-              it = this->steps().emplace( it, cell, compute_action{std::make_pair( mapped_cut.cell_function( cell ), cell_leaves )} );
+              it = cell_step.emplace( it, cell, compute_action{std::make_pair( mapped_cut.cell_function( cell ), cell_leaves )} );
             }
             else
             {
-              it = this->steps().emplace( it, cell, uncompute_action{std::make_pair( mapped_cut.cell_function( cell ), cell_leaves )} );
+              it = cell_step.emplace( it, cell, uncompute_action{std::make_pair( mapped_cut.cell_function( cell ), cell_leaves )} );
             }
             
             ++it;
           }
           else
           {
-            it = this->steps().emplace( it, cell, compute_action{std::make_pair( mapped_cut.cell_function( cell ), cell_leaves )} );
+            it = cell_step.emplace( it, cell, compute_action{std::make_pair( mapped_cut.cell_function( cell ), cell_leaves )} );
             ++it;
-            it = this->steps().emplace( it, cell, uncompute_action{std::make_pair( mapped_cut.cell_function( cell ), cell_leaves )} );
+            it = cell_step.emplace( it, cell, uncompute_action{std::make_pair( mapped_cut.cell_function( cell ), cell_leaves )} );
           }
 
           return true;
         } );
       }
+    };
+
+    const auto num_threads = std::max<std::size_t>( 1u, std::min<std::size_t>( ps.num_threads, steps.size() ) );
+    if ( num_threads == 1u )
+    {
+      for ( auto i = 0u; i < steps.size(); ++i )
+      {
+        map_cell( i );
+      }
+    }
+    else
+    {
+      std::atomic<std::size_t> next{0u};
+      std::vector<std::thread> threads;
+      for ( auto t = 0u; t < num_threads; ++t )
+      {
+        threads.emplace_back( [&]() {
+          for ( auto i = next++; i < steps.size(); i = next++ )
+          {
+            map_cell( i );
+          }
+        } );
+      }
+      for ( auto& thread : threads )
+      {
+        thread.join();
+      }
+    }
+
+    for ( auto& cell_step : cell_steps )
+    {
+      std::move( cell_step.begin(), cell_step.end(), std::back_inserter( this->steps() ) );
+    }
+  }
+
+  template<class Ntk>
+  void remap( Ntk& ntk, mt::lut_mapping_params const& lm_ps, lut_cost_model model ) const
+  {
+    switch ( model )
+    {
+    default:
+    case lut_cost_model::lut_count:
+      mt::lut_mapping<Ntk, true>( ntk, lm_ps );
+      break;
+    case lut_cost_model::spectrum:
+      mt::lut_mapping<Ntk, true, cut_enumeration_lut_cost_cut<stg_from_spectrum_cost>>( ntk, lm_ps );
+      break;
+    case lut_cost_model::pkrm:
+      mt::lut_mapping<Ntk, true, cut_enumeration_lut_cost_cut<stg_from_pkrm_cost>>( ntk, lm_ps );
+      break;
     }
   }
 
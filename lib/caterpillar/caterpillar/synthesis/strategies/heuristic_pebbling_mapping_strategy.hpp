@@ -0,0 +1,672 @@
+/*------------------------------------------------------------------------------
+| This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+| Author(s): Mathias Soeken
+*-----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <vector>
+
+#include <mockturtle/traits.hpp>
+#include <mockturtle/views/topo_view.hpp>
+
+#include "mapping_strategy.hpp"
+
+namespace caterpillar
+{
+
+namespace mt = mockturtle;
+
+struct heuristic_pebbling_mapping_strategy_params
+{
+  /*! \brief Maximum number of pebbles (0 means no limit).
+   *
+   * If the limit admits one pebble per gate and `tradeoff` is 1, Bennett's
+   * schedule is returned, which has the fewest steps.
+   */
+  uint32_t pebble_limit{0u};
+
+  /*! \brief Number of gates per segment (0 means square root of number of gates). */
+  uint32_t segment_size{0u};
+
+  /*! \brief Trade-off between qubits and gates in [0, 1].
+   *
+   * 1 uses as many segment pebbles as fit into the pebble limit (fewest
+   * gates), 0 uses as few as the recursion allows (fewest qubits).  If
+   * no segment size is given, it is halved until the pebble limit is met,
+   * and then all sizes up to twice the initial one are tried.
+   */
+  double tradeoff{1.0};
+
+  /*! \brief Remove redundant compute/uncompute pairs after scheduling (never increases the number of pebbles). */
+  bool improve{true};
+};
+
+namespace detail
+{
+
+/* range add, range maximum */
+class max_segment_tree
+{
+public:
+  explicit max_segment_tree( std::vector<int32_t> const& values )
+      : _size( std::max<std::size_t>( values.size(), 1u ) ),
+        _max( 4 * _size, 0 ),
+        _add( 4 * _size, 0 )
+  {
+    if ( !values.empty() )
+    {
+      build( 1, 0, _size - 1, values );
+    }
+  }
+
+  int32_t max( std::size_t l, std::size_t r )
+  {
+    return max( 1, 0, _size - 1, l, r );
+  }
+
+  void add( std::size_t l, std::size_t r, int32_t value )
+  {
+    add( 1, 0, _size - 1, l, r, value );
+  }
+
+private:
+  void build( std::size_t i, std::size_t lo, std::size_t hi, std::vector<int32_t> const& values )
+  {
+    if ( lo == hi )
+    {
+      _max[i] = values[lo];
+      return;
+    }
+    const auto mid = ( lo + hi ) / 2;
+    build( 2 * i, lo, mid, values );
+    build( 2 * i + 1, mid + 1, hi, values );
+    _max[i] = std::max( _max[2 * i], _max[2 * i + 1] );
+  }
+
+  int32_t max( std::size_t i, std::size_t lo, std::size_t hi, std::size_t l, std::size_t r )
+  {
+    if ( r < lo || hi < l )
+    {
+      return std::numeric_limits<int32_t>::min();
+    }
+    if ( l <= lo && hi <= r )
+    {
+      return _max[i];
+    }
+    const auto mid = ( lo + hi ) / 2;
+    return _add[i] + std::max( max( 2 * i, lo, mid, l, r ), max( 2 * i + 1, mid + 1, hi, l, r ) );
+  }
+
+  void add( std::size_t i, std::size_t lo, std::size_t hi, std::size_t l, std::size_t r, int32_t value )
+  {
+    if ( r < lo || hi < l )
+    {
+      return;
+    }
+    if ( l <= lo && hi <= r )
+    {
+      _max[i] += value;
+      _add[i] += value;
+      return;
+    }
+    const auto mid = ( lo + hi ) / 2;
+    add( 2 * i, lo, mid, l, r, value );
+    add( 2 * i + 1, mid + 1, hi, l, r, value );
+    _max[i] = _add[i] + std::max( _max[2 * i], _max[2 * i + 1] );
+  }
+
+private:
+  std::size_t _size;
+  std::vector<int32_t> _max;
+  std::vector<int32_t> _add;
+};
+
+/*! \brief Divide-and-conquer pebbling along topological segments.
+ *
+ * The gates are split in topological order into segments S_1, ..., S_k.
+ * Segment i is abstracted into a node of a line graph, which is pebbled
+ * if all gates of S_1, ..., S_i that are used by later segments (or drive
+ * a primary output) are computed.  Pebbling or unpebbling line node i
+ * only needs line node i - 1 to be pebbled and touches only the gates in
+ * S_i, so the line can be pebbled with Bennett's recursive strategy with
+ * a given number of line pebbles, where short ranges are pebbled eagerly.
+ * The resulting schedule is improved by removing compute/uncompute pairs
+ * of unused gates and by keeping gates alive instead of recomputing them,
+ * if this does not increase the maximum number of pebbles.
+ */
+template<class LogicNetwork>
+class heuristic_pebbling_impl
+{
+public:
+  using step_vec_t = typename mapping_strategy<LogicNetwork>::step_vec_t;
+
+  heuristic_pebbling_impl( LogicNetwork const& ntk, heuristic_pebbling_mapping_strategy_params const& ps )
+      : _ntk( ntk ), _ps( ps )
+  {
+  }
+
+  bool run( step_vec_t& steps )
+  {
+    init();
+    if ( _gates.empty() )
+    {
+      return true;
+    }
+
+    /* Bennett's schedule pebbles all gates and has the fewest steps */
+    const auto num_gates = static_cast<uint32_t>( _gates.size() );
+    if ( _ps.tradeoff >= 1.0 && ( _ps.pebble_limit == 0u || _ps.pebble_limit >= num_gates ) )
+    {
+      bennett( steps );
+      return true;
+    }
+
+    /* smaller segments usually need fewer pebbles for intermediate results */
+    const auto initial_size = _ps.segment_size > 0u ? _ps.segment_size : std::max<uint32_t>( 1u, static_cast<uint32_t>( std::ceil( std::sqrt( _gates.size() ) ) ) );
+    uint32_t p_min;
+    const auto fits = [&]( uint32_t segment_size ) {
+      init_segments( segment_size );
+
+      /* smallest number of line pebbles to reach the last segment */
+      p_min = 1u;
+      while ( reach_distance( p_min ) < _num_segments )
+      {
+        ++p_min;
+      }
+
+      return _ps.pebble_limit == 0u || simulate( p_min, false ) <= _ps.pebble_limit;
+    };
+
+    if ( !fits( initial_size ) )
+    {
+      if ( _ps.segment_size > 0u )
+      {
+        return false;
+      }
+
+      /* halve the segment size first; since the peak does not decrease
+       * monotonically with the segment size, all sizes up to twice the
+       * initial one are tried afterwards */
+      std::vector<uint32_t> sizes;
+      for ( auto size = initial_size / 2u; size > 0u; size /= 2u )
+      {
+        sizes.push_back( size );
+      }
+      const auto halved = sizes.size();
+      for ( auto size = 2u; size <= std::min<uint32_t>( 2u * initial_size, num_gates ); ++size )
+      {
+        if ( size != initial_size && std::find( sizes.begin(), sizes.begin() + halved, size ) == sizes.begin() + halved )
+        {
+          sizes.push_back( size );
+        }
+      }
+      if ( std::find_if( sizes.begin(), sizes.end(), fits ) == sizes.end() )
+      {
+        return false;
+      }
+    }
+
+    /* largest number of line pebbles within the pebble limit */
+    uint32_t p_max = _num_segments;
+    if ( _ps.pebble_limit > 0u )
+    {
+      auto lo = p_min;
+      auto hi = _num_segments;
+      while ( lo < hi )
+      {
+        const auto mid = lo + ( hi - lo + 1u ) / 2u;
+        if ( simulate( mid, false ) <= _ps.pebble_limit )
+        {
+          lo = mid;
+        }
+        else
+        {
+          hi = mid - 1u;
+        }
+      }
+      p_max = lo;
+    }
+
+    const auto tradeoff = std::clamp( _ps.tradeoff, 0.0, 1.0 );
+    const auto pebbles = p_min + static_cast<uint32_t>( std::lround( tradeoff * ( p_max - p_min ) ) );
+    const auto peak = simulate( pebbles, true );
+    if ( peak >= num_gates )
+    {
+      bennett( steps );
+      return true;
+    }
+
+    if ( _ps.improve )
+    {
+      improve( peak );
+    }
+
+    for ( auto t = 0u; t < _actions.size(); ++t )
+    {
+      if ( _removed.empty() || !_removed[t] )
+      {
+        const auto node = _gates[_actions[t].first];
+        if ( _actions[t].second )
+        {
+          steps.emplace_back( node, compute_action{} );
+        }
+        else
+        {
+          steps.emplace_back( node, uncompute_action{} );
+        }
+      }
+    }
+
+    return true;
+  }
+
+private:
+  void bennett( step_vec_t& steps ) const
+  {
+    std::vector<bool> is_output( _gates.size() );
+    for ( auto pos : _outputs )
+    {
+      is_output[pos] = true;
+    }
+
+    for ( auto const& n : _gates )
+    {
+      steps.emplace_back( n, compute_action{} );
+    }
+    for ( auto v = _gates.size(); v-- > 0u; )
+    {
+      if ( !is_output[v] )
+      {
+        steps.emplace_back( _gates[v], uncompute_action{} );
+      }
+    }
+  }
+
+  void init()
+  {
+    std::vector<uint32_t> position( _ntk.size(), std::numeric_limits<uint32_t>::max() );
+
+    mt::topo_view<LogicNetwork> topo{_ntk};
+    topo.foreach_node( [&]( auto n ) {
+      if ( _ntk.is_constant( n ) || _ntk.is_pi( n ) )
+        return true;
+      position[_ntk.node_to_index( n )] = static_cast<uint32_t>( _gates.size() );
+      _gates.push_back( n );
+      return true;
+    } );
+
+    const auto num_gates = static_cast<uint32_t>( _gates.size() );
+
+    /* fanins in CSR format (only gates) */
+    _fanin_begin.reserve( num_gates + 1u );
+    for ( auto const& n : _gates )
+    {
+      _fanin_begin.push_back( static_cast<uint32_t>( _fanins.size() ) );
+      _ntk.foreach_fanin( n, [&]( auto const& f ) {
+        const auto pos = position[_ntk.node_to_index( _ntk.get_node( f ) )];
+        if ( pos != std::numeric_limits<uint32_t>::max() )
+        {
+          _fanins.push_back( pos );
+        }
+      } );
+    }
+    _fanin_begin.push_back( static_cast<uint32_t>( _fanins.size() ) );
+
+    _ntk.foreach_po( [&]( auto const& f ) {
+      const auto pos = position[_ntk.node_to_index( _ntk.get_node( f ) )];
+      if ( pos != std::numeric_limits<uint32_t>::max() )
+      {
+        _outputs.push_back( pos );
+      }
+    } );
+
+    _pebbled.resize( num_gates );
+    _target.resize( num_gates );
+    _need.resize( num_gates );
+    _computed.resize( num_gates );
+  }
+
+  void init_segments( uint32_t segment_size )
+  {
+    const auto num_gates = static_cast<uint32_t>( _gates.size() );
+    _segment_size = segment_size;
+    _num_segments = ( num_gates + _segment_size - 1u ) / _segment_size;
+
+    /* last line node in which a gate is alive */
+    _last.assign( num_gates, 0u );
+    for ( auto v = 0u; v < num_gates; ++v )
+    {
+      for ( auto i = _fanin_begin[v]; i < _fanin_begin[v + 1u]; ++i )
+      {
+        const auto u = _fanins[i];
+        if ( segment( v ) > segment( u ) )
+        {
+          _last[u] = std::max( _last[u], segment( v ) - 1u );
+        }
+      }
+    }
+    for ( auto pos : _outputs )
+    {
+      _last[pos] = _num_segments;
+    }
+
+    /* reach(p) = max(p, 2 * reach(p - 1)), saturated */
+    _reach.assign( 1u, 0u );
+    while ( _reach.back() < _num_segments )
+    {
+      _reach.push_back( std::max<uint64_t>( _reach.size(), 2u * _reach.back() ) );
+    }
+  }
+
+  inline uint32_t segment( uint32_t gate ) const
+  {
+    return gate / _segment_size + 1u;
+  }
+
+  /* maximum distance that can be pebbled with p pebbles */
+  inline uint64_t reach_distance( uint32_t p ) const
+  {
+    return _reach[std::min<std::size_t>( p, _reach.size() - 1u )];
+  }
+
+  /* returns maximum number of pebbles */
+  uint32_t simulate( uint32_t pebbles, bool record )
+  {
+    _record = record;
+    _actions.clear();
+    _removed.clear();
+    std::fill( _pebbled.begin(), _pebbled.end(), false );
+    _line.clear();
+    _count = _peak = 0u;
+
+    pebble( 0u, _num_segments, pebbles, false );
+
+    assert( _line.size() == 1u && *_line.begin() == _num_segments );
+    return _peak;
+  }
+
+  /* pebble line node b when a is pebbled (or reverse this) */
+  void pebble( uint32_t a, uint32_t b, uint32_t p, bool reverse )
+  {
+    const auto d = b - a;
+    if ( d <= p )
+    {
+      if ( !reverse )
+      {
+        for ( auto q = a + 1u; q <= b; ++q )
+          toggle( q );
+        for ( auto q = b - 1u; q > a; --q )
+          toggle( q );
+      }
+      else
+      {
+        for ( auto q = a + 1u; q < b; ++q )
+          toggle( q );
+        for ( auto q = b; q > a; --q )
+          toggle( q );
+      }
+      return;
+    }
+
+    /* the first half is pebbled twice, so keep it short */
+    const auto second = static_cast<uint32_t>( std::min<uint64_t>( reach_distance( p - 1u ), d - 1u ) );
+    const auto m = b - second;
+    pebble( a, m, p - 1u, false );
+    pebble( m, b, p - 1u, reverse );
+    pebble( a, m, p - 1u, true );
+  }
+
+  void toggle( uint32_t q )
+  {
+    if ( !_line.erase( q ) )
+    {
+      _line.insert( q );
+    }
+
+    const auto begin = ( q - 1u ) * _segment_size;
+    const auto end = std::min<uint32_t>( begin + _segment_size, static_cast<uint32_t>( _gates.size() ) );
+
+    /* new state of gates in this segment */
+    for ( auto v = begin; v < end; ++v )
+    {
+      bool target = false;
+      if ( _last[v] >= q )
+      {
+        const auto it = _line.lower_bound( q );
+        target = it != _line.end() && *it <= _last[v];
+      }
+      _target[v] = target;
+      _need[v] = target != _pebbled[v];
+    }
+
+    /* gates required to (un)compute the changed gates */
+    for ( auto v = end; v-- > begin; )
+    {
+      if ( !_need[v] )
+        continue;
+      for ( auto i = _fanin_begin[v]; i < _fanin_begin[v + 1u]; ++i )
+      {
+        const auto u = _fanins[i];
+        assert( u >= begin || _pebbled[u] );
+        if ( u >= begin && !_pebbled[u] )
+        {
+          _need[u] = true;
+        }
+      }
+    }
+
+    for ( auto v = begin; v < end; ++v )
+    {
+      if ( _need[v] && !_pebbled[v] )
+      {
+        action( v, true );
+        _computed[v] = true;
+      }
+    }
+
+    for ( auto v = end; v-- > begin; )
+    {
+      if ( _need[v] && !_target[v] && ( _pebbled[v] || _computed[v] ) )
+      {
+        action( v, false );
+      }
+      _pebbled[v] = _target[v];
+      _need[v] = _computed[v] = false;
+    }
+  }
+
+  inline void action( uint32_t gate, bool compute )
+  {
+    if ( compute )
+    {
+      _peak = std::max( _peak, ++_count );
+    }
+    else
+    {
+      --_count;
+    }
+    if ( _record )
+    {
+      _actions.emplace_back( gate, compute );
+    }
+  }
+
+  void improve( uint32_t bound )
+  {
+    const auto num_actions = _actions.size();
+    _removed.assign( num_actions, false );
+    if ( num_actions == 0u )
+    {
+      return;
+    }
+
+    /* actions per gate (CSR format) */
+    std::vector<uint32_t> begin( _gates.size() + 1u, 0u ), times( num_actions );
+    for ( auto const& a : _actions )
+    {
+      ++begin[a.first + 1u];
+    }
+    for ( auto v = 0u; v < _gates.size(); ++v )
+    {
+      begin[v + 1u] += begin[v];
+    }
+    {
+      auto fill = begin;
+      for ( auto t = 0u; t < num_actions; ++t )
+      {
+        times[fill[_actions[t].first]++] = t;
+      }
+    }
+
+    /* fanouts (CSR format) */
+    std::vector<uint32_t> fanout_begin( _gates.size() + 1u, 0u ), fanouts( _fanins.size() );
+    for ( auto u : _fanins )
+    {
+      ++fanout_begin[u + 1u];
+    }
+    for ( auto v = 0u; v < _gates.size(); ++v )
+    {
+      fanout_begin[v + 1u] += fanout_begin[v];
+    }
+    {
+      auto fill = fanout_begin;
+      for ( auto v = 0u; v < _gates.size(); ++v )
+      {
+        for ( auto i = _fanin_begin[v]; i < _fanin_begin[v + 1u]; ++i )
+        {
+          fanouts[fill[_fanins[i]]++] = v;
+        }
+      }
+    }
+
+    /* compute/uncompute pairs without a use of the gate in between */
+    for ( auto v = 0u; v < _gates.size(); ++v )
+    {
+      for ( auto i = begin[v]; i + 1u < begin[v + 1u]; ++i )
+      {
+        const auto t1 = times[i], t2 = times[i + 1u];
+        if ( !_actions[t1].second )
+          continue;
+
+        bool used = false;
+        for ( auto j = fanout_begin[v]; j < fanout_begin[v + 1u] && !used; ++j )
+        {
+          const auto w = fanouts[j];
+          const auto it = std::upper_bound( times.begin() + begin[w], times.begin() + begin[w + 1u], t1 );
+          used = it != times.begin() + begin[w + 1u] && *it < t2;
+        }
+        if ( !used )
+        {
+          _removed[t1] = _removed[t2] = true;
+          ++i;
+        }
+      }
+    }
+
+    /* number of pebbles after each action */
+    std::vector<int32_t> counts( num_actions );
+    int32_t count{0};
+    for ( auto t = 0u; t < num_actions; ++t )
+    {
+      if ( !_removed[t] )
+      {
+        count += _actions[t].second ? 1 : -1;
+      }
+      counts[t] = count;
+    }
+
+    /* keep gates alive instead of uncomputing and recomputing them */
+    max_segment_tree tree( counts );
+    for ( auto v = 0u; v < _gates.size(); ++v )
+    {
+      for ( auto i = begin[v]; i + 1u < begin[v + 1u]; ++i )
+      {
+        const auto t1 = times[i], t2 = times[i + 1u];
+        if ( _actions[t1].second || _removed[t1] || _removed[t2] )
+          continue;
+
+        if ( tree.max( t1, t2 - 1u ) + 1 <= static_cast<int32_t>( bound ) )
+        {
+          tree.add( t1, t2 - 1u, 1 );
+          _removed[t1] = _removed[t2] = true;
+          ++i;
+        }
+      }
+    }
+  }
+
+private:
+  LogicNetwork const& _ntk;
+  heuristic_pebbling_mapping_strategy_params const& _ps;
+
+  std::vector<mt::node<LogicNetwork>> _gates; /* in topological order */
+  std::vector<uint32_t> _fanin_begin;
+  std::vector<uint32_t> _fanins;
+  std::vector<uint32_t> _outputs;
+  std::vector<uint32_t> _last;
+  uint32_t _segment_size{1u};
+  uint32_t _num_segments{0u};
+  std::vector<uint64_t> _reach;
+
+  std::set<uint32_t> _line; /* pebbled line nodes */
+  std::vector<bool> _pebbled, _target, _need, _computed;
+  uint32_t _count{0u}, _peak{0u};
+  bool _record{false};
+  std::vector<std::pair<uint32_t, bool>> _actions;
+  std::vector<bool> _removed;
+};
+
+} // namespace detail
+
+/*! \brief Heuristic pebbling strategy for bounded space.
+ *
+ * Finds a pebbling schedule that respects `pebble_limit`, if possible,
+ * without invoking a SAT solver.  The gates are split into topological
+ * segments, which are pebbled with a recursive divide-and-conquer
+ * strategy, followed by a local improvement of the schedule.  The
+ * runtime is linear in the size of the network and the number of
+ * recomputations, which grows when fewer pebbles are available.  If the
+ * schedule would need as many pebbles as there are gates, Bennett's
+ * schedule is returned instead.  If no segment size meets the pebble
+ * limit, no steps are computed and `compute_steps` returns false.
+ */
+template<class LogicNetwork>
+class heuristic_pebbling_mapping_strategy : public mapping_strategy<LogicNetwork>
+{
+public:
+  heuristic_pebbling_mapping_strategy( heuristic_pebbling_mapping_strategy_params const& ps = {} )
+      : ps( ps )
+  {
+    static_assert( mt::is_network_type_v<LogicNetwork>, "LogicNetwork is not a network type" );
+    static_assert( mt::has_is_constant_v<LogicNetwork>, "LogicNetwork does not implement the is_constant method" );
+    static_assert( mt::has_is_pi_v<LogicNetwork>, "LogicNetwork does not implement the is_pi method" );
+    static_assert( mt::has_foreach_fanin_v<LogicNetwork>, "LogicNetwork does not implement the foreach_fanin method" );
+    static_assert( mt::has_foreach_node_v<LogicNetwork>, "LogicNetwork does not implement the foreach_node method" );
+    static_assert( mt::has_foreach_po_v<LogicNetwork>, "LogicNetwork does not implement the foreach_po method" );
+    static_assert( mt::has_get_node_v<LogicNetwork>, "LogicNetwork does not implement the get_node method" );
+    static_assert( mt::has_node_to_index_v<LogicNetwork>, "LogicNetwork does not implement the node_to_index method" );
+    static_assert( mt::has_size_v<LogicNetwork>, "LogicNetwork does not implement the size method" );
+  }
+
+  virtual ~heuristic_pebbling_mapping_strategy() = default;
+
+  bool compute_steps( LogicNetwork const& ntk ) override
+  {
+    this->steps().clear();
+    detail::heuristic_pebbling_impl<LogicNetwork> impl( ntk, ps );
+    return impl.run( this->steps() );
+  }
+
+private:
+  heuristic_pebbling_mapping_strategy_params ps;
+};
+
+} // namespace caterpillar
@@ -13,6 +13,7 @@
 #include "mapping_strategy.hpp"
 #include "../sat.hpp"
 
+#include <easy/utils/cancellation.hpp>
 #include <mockturtle/utils/progress_bar.hpp>
 
 namespace caterpillar
@@ -36,6 +37,19 @@ struct pebbling_mapping_strategy_params
 
   /*! \brief Decrement pebble numbers, if satisfiable. */
   bool decrement_on_success{false};
+
+  /*! \brief SAT solver back-end (SLV_BSAT2 or SLV_BMCG for Glucose with preprocessing). */
+  percy::SolverType solver_type{percy::SLV_BSAT2};
+
+  /*! \brief Add cardinality constraints only at steps that exceed the pebble limit (CEGAR). */
+  bool lazy_cardinality{false};
+
+  /*! \brief Cancellation token, which also interrupts running SAT calls (optional).
+   *
+   * If the token is canceled, the last solution found with `decrement_on_success` is kept;
+   * otherwise, no steps are computed.
+   */
+  easy::utils::cancellation_token const* token{nullptr};
 };
 
 template<class LogicNetwork>
@@ -62,9 +76,17 @@ public:
     std::vector<std::pair<mockturtle::node<LogicNetwork>, mapping_strategy_action>> store_steps;
     auto limit = ps.pebble_limit;
     unsigned max_steps = 100;
+    const auto is_canceled = [&]() { return ps.token && ps.token->is_canceled(); };
+
+    /* the SAT solvers only poll the stop flag of the token */
+    easy::utils::deadline_watcher watcher( ps.token );
     while ( true )
     {
-      pebble_solver<LogicNetwork> solver( ntk, limit );
+      pebble_solver<LogicNetwork> solver( ntk, limit, ps.solver_type, ps.lazy_cardinality );
+      if ( ps.token )
+      {
+        solver.set_stop( ps.token->stop_flag() );
+      }
       solver.initialize();
 
       mockturtle::progress_bar bar( 100, "|{0}| current step = {1}", ps.progress );
@@ -72,7 +94,7 @@ public:
 
       do
       {
-        if ( solver.current_step() >= max_steps )
+        if ( solver.current_step() >= max_steps || is_canceled() )
         {
           result = percy::timeout;
           break;
@@ -85,7 +107,11 @@ public:
 
       if ( result == percy::timeout )
       {
-        if ( ps.increment_on_timeout )
+        if ( is_canceled() )
+        {
+          return !this->steps().empty();
+        }
+        else if ( ps.increment_on_timeout )
         {
           limit++;
           continue;
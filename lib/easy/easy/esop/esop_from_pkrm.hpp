@@ -40,6 +40,7 @@
 #include <kitty/operators.hpp>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace easy::esop
 {
@@ -59,14 +60,14 @@ template<typename TT>
 using expansion_cache = std::unordered_map<TT, std::pair<uint32_t, pkrm_decomposition>, kitty::hash<TT>>;
 
 template<typename TT>
-inline uint32_t find_pkrm_expansions( const TT& tt, expansion_cache<TT>& cache, uint8_t var_index )
+inline uint32_t find_pkrm_expansions( const TT& tt, expansion_cache<TT>& cache, uint8_t var_index, std::vector<TT>& scratch )
 {
   /* terminal cases */
   if ( is_const0( tt ) )
   {
     return 0;
   }
-  if ( is_const0( ~tt ) )
+  if ( is_const1( tt ) )
   {
     return 1;
   }
@@ -78,12 +79,17 @@ inline uint32_t find_pkrm_expansions( const TT& tt, expansion_cache<TT>& cache,
     return it->second.first;
   }
 
-  const auto tt0 = cofactor0( tt, var_index );
-  const auto tt1 = cofactor1( tt, var_index );
+  /* each recursion level owns three scratch truth tables */
+  auto& tt0 = scratch[3 * var_index];
+  auto& tt1 = scratch[3 * var_index + 1];
+  auto& tt01 = scratch[3 * var_index + 2];
+  cofactor0_into( tt, var_index, tt0 );
+  cofactor1_into( tt, var_index, tt1 );
+  cofactor_xor_into( tt, var_index, tt01 );
 
-  const auto ex0 = find_pkrm_expansions( tt0, cache, var_index + 1 );
-  const auto ex1 = find_pkrm_expansions( tt1, cache, var_index + 1 );
-  const auto ex2 = find_pkrm_expansions( tt0 ^ tt1, cache, var_index + 1 );
+  const auto ex0 = find_pkrm_expansions( tt0, cache, var_index + 1, scratch );
+  const auto ex1 = find_pkrm_expansions( tt1, cache, var_index + 1, scratch );
+  const auto ex2 = find_pkrm_expansions( tt01, cache, var_index + 1, scratch );
 
   const auto ex_max = std::max( std::max( ex0, ex1 ), ex2 );
 
@@ -110,14 +116,14 @@ inline uint32_t find_pkrm_expansions( const TT& tt, expansion_cache<TT>& cache,
 }
 
 template<typename TT>
-inline void optimum_pkrm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& pkrm, const TT& tt, const expansion_cache<TT>& cache, uint8_t var_index, const kitty::cube& c )
+inline void optimum_pkrm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& pkrm, const TT& tt, const expansion_cache<TT>& cache, uint8_t var_index, const kitty::cube& c, std::vector<TT>& scratch )
 {
   /* terminal cases */
   if ( is_const0( tt ) )
   {
     return;
   }
-  if ( is_const0( ~tt ) )
+  if ( is_const1( tt ) )
   {
     add_to_cubes( pkrm, c );
     return;
@@ -125,22 +131,29 @@ inline void optimum_pkrm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty:
 
   const auto& p = cache.at( tt );
 
-  const auto tt0 = cofactor0( tt, var_index );
-  const auto tt1 = cofactor1( tt, var_index );
+  auto& tt0 = scratch[3 * var_index];
+  auto& tt1 = scratch[3 * var_index + 1];
+  auto& tt01 = scratch[3 * var_index + 2];
 
   switch ( p.second )
   {
   case pkrm_decomposition::positive_davio:
-    optimum_pkrm_rec( pkrm, tt0, cache, var_index + 1, c );
-    optimum_pkrm_rec( pkrm, tt0 ^ tt1, cache, var_index + 1, with_literal( c, var_index, true ) );
+    cofactor0_into( tt, var_index, tt0 );
+    cofactor_xor_into( tt, var_index, tt01 );
+    optimum_pkrm_rec( pkrm, tt0, cache, var_index + 1, c, scratch );
+    optimum_pkrm_rec( pkrm, tt01, cache, var_index + 1, with_literal( c, var_index, true ), scratch );
     break;
   case pkrm_decomposition::negative_davio:
-    optimum_pkrm_rec( pkrm, tt1, cache, var_index + 1, c );
-    optimum_pkrm_rec( pkrm, tt0 ^ tt1, cache, var_index + 1, with_literal( c, var_index, false ) );
+    cofactor1_into( tt, var_index, tt1 );
+    cofactor_xor_into( tt, var_index, tt01 );
+    optimum_pkrm_rec( pkrm, tt1, cache, var_index + 1, c, scratch );
+    optimum_pkrm_rec( pkrm, tt01, cache, var_index + 1, with_literal( c, var_index, false ), scratch );
     break;
   case pkrm_decomposition::shannon:
-    optimum_pkrm_rec( pkrm, tt0, cache, var_index + 1, with_literal( c, var_index, false ) );
-    optimum_pkrm_rec( pkrm, tt1, cache, var_index + 1, with_literal( c, var_index, true ) );
+    cofactor0_into( tt, var_index, tt0 );
+    cofactor1_into( tt, var_index, tt1 );
+    optimum_pkrm_rec( pkrm, tt0, cache, var_index + 1, with_literal( c, var_index, false ), scratch );
+    optimum_pkrm_rec( pkrm, tt1, cache, var_index + 1, with_literal( c, var_index, true ), scratch );
     break;
   }
 }
@@ -161,9 +174,10 @@ inline esop_t esop_from_optimum_pkrm( const TT& tt )
 {
   std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
   detail::expansion_cache<TT> cache;
+  std::vector<TT> scratch( 3 * tt.num_vars(), tt );
 
-  detail::find_pkrm_expansions( tt, cache, 0 );
-  detail::optimum_pkrm_rec( cubes, tt, cache, 0, kitty::cube() );
+  detail::find_pkrm_expansions( tt, cache, 0, scratch );
+  detail::optimum_pkrm_rec( cubes, tt, cache, 0, kitty::cube(), scratch );
 
   return esop_t( cubes.begin(), cubes.end() );
 }
@@ -35,9 +35,12 @@
 
 #include <easy/esop/esop.hpp>
 #include <easy/esop/cube_manipulators.hpp>
+#include <kitty/bit_operations.hpp>
 #include <kitty/cube.hpp>
+#include <kitty/operations.hpp>
 
 #include <unordered_set>
+#include <vector>
 
 namespace easy
 {
@@ -50,25 +53,28 @@ namespace detail
 {
 
 template<typename TT>
-inline void esop_from_pprm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& cubes, const TT& tt, uint8_t var_index, const kitty::cube& c )
+inline void esop_from_pprm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& cubes, const TT& tt, uint8_t var_index, const kitty::cube& c, std::vector<TT>& scratch )
 {
   /* terminal cases */
   if ( is_const0( tt ) )
   {
     return;
   }
-  if ( is_const0( ~tt ) )
+  if ( is_const1( tt ) )
   {
     /* add to cubes, but do not apply distance-1 merging */
     add_to_cubes( cubes, c, false );
     return;
   }
 
-  const auto tt0 = cofactor0( tt, var_index );
-  const auto tt1 = cofactor1( tt, var_index );
+  /* each recursion level owns two scratch truth tables */
+  auto& tt0 = scratch[2 * var_index];
+  auto& tt01 = scratch[2 * var_index + 1];
+  cofactor0_into( tt, var_index, tt0 );
+  cofactor_xor_into( tt, var_index, tt01 );
 
-  esop_from_pprm_rec( cubes, tt0, var_index + 1, c );
-  esop_from_pprm_rec( cubes, tt0 ^ tt1, var_index + 1, with_literal( c, var_index, true ) );
+  esop_from_pprm_rec( cubes, tt0, var_index + 1, c, scratch );
+  esop_from_pprm_rec( cubes, tt01, var_index + 1, with_literal( c, var_index, true ), scratch );
 }
 
 } // namespace detail
@@ -85,7 +91,8 @@ template<typename TT>
 inline esop_t esop_from_pprm( const TT& tt )
 {
   std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
-  detail::esop_from_pprm_rec( cubes, tt, 0, kitty::cube() );
+  std::vector<TT> scratch( 2 * tt.num_vars(), tt );
+  detail::esop_from_pprm_rec( cubes, tt, 0, kitty::cube(), scratch );
 
   return esop_t( cubes.begin(), cubes.end() );
 }
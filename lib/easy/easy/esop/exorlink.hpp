@@ -31,11 +31,11 @@
 namespace easy::esop
 {
 
-static unsigned cube_groups2[8] = {
+inline constexpr std::uint32_t cube_groups2[8] = {
     /* 0 */ 2, 0, 1, 2,
     /* 4 */ 0, 2, 2, 1};
 
-static unsigned cube_groups3[54] = {
+inline constexpr std::uint32_t cube_groups3[54] = {
     /*  0 */ 2, 0, 0, 1, 2, 0, 1, 1, 2,
     /*  9 */ 2, 0, 0, 1, 0, 2, 1, 2, 1,
     /* 18 */ 0, 2, 0, 2, 1, 0, 1, 1, 2,
@@ -57,7 +57,7 @@ static unsigned cube_groups3[54] = {
  * \param group A group of cube transformations
  * \return An array of up to 5 new cubes which are functionally equivalent to ``c0`` and ``c1``.
  */
-std::vector<kitty::cube> exorlink( kitty::cube c0, kitty::cube c1, std::uint32_t distance, std::uint32_t* group )
+inline std::vector<kitty::cube> exorlink( kitty::cube c0, kitty::cube c1, std::uint32_t distance, std::uint32_t const* group )
 {
   const auto diff = c0.difference( c1 );
 
@@ -112,9 +112,9 @@ std::vector<kitty::cube> exorlink( kitty::cube c0, kitty::cube c1, std::uint32_t
  * \param offset An offset that determines the transformation (must be a value in the series 0, 16, 32, ..., 368)
  * \return An array of 4 new cubes which are functionally equivalent to ``c0`` and ``c1``.
  */
-std::array<kitty::cube, 4> exorlink4( const kitty::cube& c0, const kitty::cube& c1, uint32_t offset )
+inline std::array<kitty::cube, 4> exorlink4( const kitty::cube& c0, const kitty::cube& c1, uint32_t offset )
 {
-  std::uint32_t* group = &cube_groups4[offset];
+  std::uint32_t const* group = &cube_groups4[offset];
   const auto diff = c0.difference( c1 );
 
   std::array<kitty::cube, 4> result;
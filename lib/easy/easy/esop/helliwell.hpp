@@ -218,12 +218,25 @@ struct helliwell_maxsat
 
 struct helliwell_maxsat_statistics
 {
+  bool optimal{false}; /*!< True if the ESOP is of minimum cost, false if the budget was exhausted */
 };
 
 struct helliwell_maxsat_params
 {
+  double time_budget{-1}; /*!< Wall-clock budget in seconds for portfolio solvers (a value < 0 denotes an unconstrained budget) */
+  uint32_t num_threads{0u}; /*!< Number of threads for portfolio solvers (0 uses the hardware concurrency) */
+  bool native_xor{true}; /*!< Propagate XOR-clauses natively instead of translating them into CNF */
+  utils::cancellation_token const* token{nullptr}; /*!< Token that stops the search once it is canceled (RC2) */
 };
 
+/*! \brief Exact ESOP synthesis with MAXSAT
+ *
+ * `Solver` selects the MAXSAT algorithm, e.g., `sat2::maxsat_rc2` or
+ * the multi-threaded `sat2::maxsat_rc2_portfolio`.  If a budget is
+ * exhausted or the cancellation token is canceled, the best ESOP
+ * found so far is returned and `optimal` is false in the statistics.
+ * The ESOP is empty if the search stopped before a first solution.
+ */
 template<typename TT, typename Solver>
 class esop_from_tt<TT, Solver, helliwell_maxsat>
 {
@@ -232,7 +245,7 @@ public:
 
 public:
   explicit esop_from_tt( helliwell_maxsat_statistics& stats, helliwell_maxsat_params& ps )
-      : _stats( stats ), _ps( ps ), _solver( _maxsat_stats, _maxsat_ps, _sid )
+      : _stats( stats ), _ps( ps ), _maxsat_ps( make_maxsat_params( ps ) ), _solver( _maxsat_stats, _maxsat_ps, _sid )
   {
   }
 
@@ -251,10 +264,21 @@ public:
     std::vector<std::vector<int>> xor_clauses;
     detail::derive_xor_clauses( xor_clauses, g, bits, care );
 
-    /* apply gause algorithm to translate XOR-clauses to clauses */
-    for ( const auto& c : detail::translate_to_cnf( _sid, xor_clauses, g.size() ) )
+    if ( _ps.native_xor )
+    {
+      /* XOR-clauses are propagated by Gauss-Jordan elimination inside the solver */
+      for ( const auto& c : xor_clauses )
+      {
+        _solver.add_xor_clause( c );
+      }
+    }
+    else
     {
-      _solver.add_clause( c );
+      /* apply gause algorithm to translate XOR-clauses to clauses */
+      for ( const auto& c : detail::translate_to_cnf( _sid, xor_clauses, g.size() ) )
+      {
+        _solver.add_clause( c );
+      }
     }
 
     /* add soft clauses and remember how they map onto g */
@@ -267,7 +291,8 @@ public:
 
     /* extract the esop from the model */
     auto const state = _solver.solve();
-    if ( state == maxsat_solver_t::state::success )
+    _stats.optimal = ( state == maxsat_solver_t::state::success );
+    if ( state == maxsat_solver_t::state::success || state == maxsat_solver_t::state::timeout )
     {
       auto const clause_selectors = _solver.get_disabled_clauses();
       return detail::esop_from_clause_selectors( clause_selectors, g, soft_clause_map );
@@ -288,6 +313,16 @@ public:
     return synthesize( bits, ~care, cost_fn );
   }
 
+protected:
+  static sat2::maxsat_solver_params make_maxsat_params( helliwell_maxsat_params const& ps )
+  {
+    sat2::maxsat_solver_params maxsat_ps;
+    maxsat_ps.time_budget = ps.time_budget;
+    maxsat_ps.num_threads = ps.num_threads;
+    maxsat_ps.token = ps.token;
+    return maxsat_ps;
+  }
+
 protected:
   helliwell_maxsat_statistics& _stats;
   helliwell_maxsat_params const& _ps;
@@ -309,6 +344,7 @@ struct helliwell_sat_statistics
 
 struct helliwell_sat_params
 {
+  bool native_xor{true}; /*!< Propagate XOR-clauses natively instead of translating them into CNF */
 };
 
 template<typename TT, typename Solver>
@@ -335,10 +371,21 @@ public:
     std::vector<std::vector<int>> xor_clauses;
     detail::derive_xor_clauses( xor_clauses, g, bits, care );
 
-    /* apply gause algorithm to translate XOR-clauses to clauses */
-    for ( const auto& c : detail::translate_to_cnf( _sid, xor_clauses, g.size() ) )
+    if ( _ps.native_xor )
+    {
+      /* XOR-clauses are propagated by Gauss-Jordan elimination inside the solver */
+      for ( const auto& c : xor_clauses )
+      {
+        _solver.add_xor_clause( c );
+      }
+    }
+    else
     {
-      _solver.add_clause( c );
+      /* apply gause algorithm to translate XOR-clauses to clauses */
+      for ( const auto& c : detail::translate_to_cnf( _sid, xor_clauses, g.size() ) )
+      {
+        _solver.add_clause( c );
+      }
     }
 
     /* extract the esop from the model */
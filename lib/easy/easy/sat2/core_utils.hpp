@@ -69,12 +69,13 @@ inline std::vector<T> copy_vector_without_index( std::vector<T> const& vs, uint6
  *
  * Returns the trimmed core.
  */
-inline core<> trim_core_copy( sat_solver& solver, core<> const& cs, uint32_t num_tries = 8u )
+template<typename Solver = sat_solver>
+inline core<> trim_core_copy( Solver& solver, core<> const& cs, uint32_t num_tries = 8u )
 {
   auto current = cs;
 
   uint32_t counter = 0;
-  while ( counter++ < num_tries && solver.solve( current ) == sat_solver::state::unsat )
+  while ( counter++ < num_tries && solver.solve( current ) == Solver::state::unsat )
   {
     auto const new_core = solver.get_core();
     if ( new_core.size() == current.size() )
@@ -101,7 +102,8 @@ inline core<> trim_core_copy( sat_solver& solver, core<> const& cs, uint32_t num
  * \param cs An unsatisfiable core
  * \param num_tries Maximal number of tries to trim core
  */
-inline void trim_core( sat_solver& solver, core<>& cs, uint32_t num_tries = 8u )
+template<typename Solver = sat_solver>
+inline void trim_core( Solver& solver, core<>& cs, uint32_t num_tries = 8u )
 {
   cs = trim_core_copy( solver, cs, num_tries );
 }
@@ -111,7 +113,8 @@ inline void trim_core( sat_solver& solver, core<>& cs, uint32_t num_tries = 8u )
  * Given a SAT-solver `solver` with an unsatisfiable core `cs`, such
  * that the solver is in state UNSAT undert the given assumptions, the
  * algorithm heuristically tries to minimize the core using an
- * `budget` as conflict limit.
+ * `budget` as conflict limit.  The conflict budget of the solver is
+ * restored afterwards.
  *
  * \param solver SAT-solver
  * \param cs An unsatisfiable core
@@ -119,8 +122,10 @@ inline void trim_core( sat_solver& solver, core<>& cs, uint32_t num_tries = 8u )
  *
  * Returns a potentially minimized unsatisfiable core.
  */
-inline core<> minimize_core_copy( sat_solver& solver, core<> const& cs, int64_t budget = 1000 )
+template<typename Solver = sat_solver>
+inline core<> minimize_core_copy( Solver& solver, core<> const& cs, int64_t budget = 1000 )
 {
+  const auto previous_budget = solver.get_budget();
   solver.set_budget( budget );
 
   auto pos = 0u;
@@ -129,11 +134,12 @@ inline core<> minimize_core_copy( sat_solver& solver, core<> const& cs, int64_t
   while ( pos < current.size() )
   {
     auto temp = core<>( detail::copy_vector_without_index( std::vector<int>( current ), pos ) );
-    solver.solve_limited( temp );
+    solver.solve( temp );
 
     if ( solver.is_unsat() )
     {
-      current = temp;
+      /* the core of the solver is a subset of temp that still contains all necessary literals before pos */
+      current = solver.get_core();
     }
     else
     {
@@ -141,7 +147,14 @@ inline core<> minimize_core_copy( sat_solver& solver, core<> const& cs, int64_t
     }
   }
 
-  solver.reset_budget();
+  if ( previous_budget < 0 )
+  {
+    solver.reset_budget();
+  }
+  else
+  {
+    solver.set_budget( previous_budget );
+  }
 
   if ( current.size() < cs.size() )
   {
@@ -165,7 +178,8 @@ inline core<> minimize_core_copy( sat_solver& solver, core<> const& cs, int64_t
  * \param budget A budget limit for SAT-solving
  *
  */
-inline void minimize_core( sat_solver& solver, core<>& cs, int64_t budget = 1000 )
+template<typename Solver = sat_solver>
+inline void minimize_core( Solver& solver, core<>& cs, int64_t budget = 1000 )
 {
   cs = minimize_core_copy( solver, cs, budget );
 }
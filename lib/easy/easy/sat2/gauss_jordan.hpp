@@ -0,0 +1,605 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file gauss_jordan.hpp
+  \brief Native XOR-constraint propagation for Glucose
+
+  \author Heinz Riener
+
+  XOR-clauses are kept as rows of a bit-packed matrix over GF(2)
+  instead of being translated into CNF.  The matrix is brought into
+  reduced row echelon form whenever XOR-clauses have been added.
+  During search, every row has a basic variable, which occurs in no
+  other row, and one watched non-basic variable.  If the basic
+  variable of a row is assigned, another unassigned variable of the
+  row becomes basic and is eliminated from all other rows
+  (incremental Gauss-Jordan elimination).  Since row operations do
+  not change the solution space, the matrix does not need to be
+  restored on backtracking.
+
+  Implied literals and conflicts are explained by clauses over the
+  assigned variables of a row.  These clauses are not attached to the
+  watch lists; they only serve as reasons during conflict analysis and
+  are released when the solver backtracks over their decision level.
+*/
+
+#pragma once
+
+#ifdef __clang__ // CLANG compiler
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#pragma clang diagnostic ignored "-Wsign-compare"
+#include <glucose/glucose.hpp>
+#pragma clang diagnostic pop
+#elif __GNUC__ // GCC compiler
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include <glucose/glucose.hpp>
+#pragma GCC diagnostic pop
+#else // other compilers
+#include <glucose/glucose.hpp>
+#endif
+
+#include <easy/utils/cancellation.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace easy::sat2
+{
+
+namespace detail
+{
+
+class gauss_jordan_solver : public Glucose::Solver
+{
+public:
+  /*! \brief Adds an XOR-clause
+   *
+   * The XOR of the literals is constrained to be true.  All variables
+   * must have been created before.
+   */
+  void add_xor_clause( Glucose::vec<Glucose::Lit> const& lits )
+  {
+    std::vector<Glucose::Var> vars;
+    bool parity = true;
+    for ( auto i = 0; i < lits.size(); ++i )
+    {
+      assert( Glucose::var( lits[i] ) < nVars() );
+      vars.emplace_back( Glucose::var( lits[i] ) );
+      parity ^= Glucose::sign( lits[i] );
+    }
+    _pending_rows.emplace_back( vars );
+    _pending_parities.emplace_back( parity );
+    _dirty = true;
+  }
+
+  /*! \brief Returns the number of (simplified) XOR-rows */
+  uint32_t num_xor_rows() const
+  {
+    return _dirty ? uint32_t( _basic.size() + _pending_rows.size() ) : uint32_t( _basic.size() );
+  }
+
+  uint64_t num_xor_propagations() const
+  {
+    return _num_propagations;
+  }
+
+  uint64_t num_xor_conflicts() const
+  {
+    return _num_conflicts;
+  }
+
+  /*! \brief Interrupts the search at the next conflict once `token` is canceled */
+  void set_cancellation_token( utils::cancellation_token const* token )
+  {
+    _token = token;
+  }
+
+protected:
+  bool parallelJobIsFinished() override
+  {
+    if ( _token && _token->is_canceled() )
+    {
+      /* the flag is only written from the thread that runs the solver */
+      interrupt();
+      return true;
+    }
+    return false;
+  }
+
+  Glucose::CRef extensionPropagate() override
+  {
+    if ( _dirty )
+    {
+      assert( decisionLevel() == 0 );
+      if ( !initialize() )
+      {
+        return unsat_reason();
+      }
+    }
+
+    while ( _qhead < trail.size() )
+    {
+      auto const v = Glucose::var( trail[_qhead++] );
+      if ( uint32_t( v ) >= _watches.size() )
+      {
+        continue;
+      }
+
+      auto& ws = _watches[v];
+      auto i = 0u, j = 0u;
+      for ( ; i < ws.size(); ++i )
+      {
+        auto const r = ws[i];
+        if ( _basic[r] != v && _watch[r] != v )
+        {
+          continue;
+        }
+
+        auto const confl = update_rows( r );
+        if ( _basic[r] == v || _watch[r] == v )
+        {
+          ws[j++] = r;
+        }
+
+        if ( confl != Glucose::CRef_Undef )
+        {
+          for ( ++i; i < ws.size(); ++i )
+          {
+            ws[j++] = ws[i];
+          }
+          ws.resize( j );
+          return confl;
+        }
+      }
+      ws.resize( j );
+    }
+
+    return Glucose::CRef_Undef;
+  }
+
+  void extensionCancelUntil( int level ) override
+  {
+    if ( _qhead > trail_lim[level] )
+    {
+      _qhead = trail_lim[level];
+    }
+
+    while ( !_reasons.empty() && _reasons.back().second > level )
+    {
+      ca.free( _reasons.back().first );
+      _reasons.pop_back();
+    }
+  }
+
+  void relocAll( Glucose::ClauseAllocator& to ) override
+  {
+    Glucose::Solver::relocAll( to );
+    for ( auto& r : _reasons )
+    {
+      ca.reloc( r.first, to );
+    }
+  }
+
+private:
+  /* merges pending rows, substitutes level-0 assignments, and computes the reduced row echelon form */
+  bool initialize()
+  {
+    _dirty = false;
+
+    auto const num_vars = uint32_t( nVars() );
+    auto const num_words = ( num_vars + 63u ) >> 6u;
+
+    /* copy existing rows into the new layout and append the pending ones */
+    std::vector<uint64_t> bits;
+    std::vector<uint8_t> parities;
+    auto const num_old_rows = uint32_t( _basic.size() );
+    for ( auto r = 0u; r < num_old_rows; ++r )
+    {
+      bits.insert( bits.end(), _bits.begin() + r * _num_words, _bits.begin() + ( r + 1 ) * _num_words );
+      bits.resize( bits.size() + ( num_words - _num_words ), 0u );
+      parities.emplace_back( _parities[r] );
+    }
+    for ( auto k = 0u; k < _pending_rows.size(); ++k )
+    {
+      bits.resize( bits.size() + num_words, 0u );
+      auto* row = &bits[bits.size() - num_words];
+      for ( auto const& v : _pending_rows[k] )
+      {
+        row[v >> 6u] ^= uint64_t( 1 ) << ( v & 63u );
+      }
+      parities.emplace_back( _pending_parities[k] );
+    }
+    _pending_rows.clear();
+    _pending_parities.clear();
+
+    _bits.swap( bits );
+    _parities.swap( parities );
+    _num_words = num_words;
+    auto num_rows = uint32_t( _parities.size() );
+
+    /* substitute variables that are assigned at level 0 */
+    for ( auto r = 0u; r < num_rows; ++r )
+    {
+      for_each_var( r, [&]( Glucose::Var v ) {
+        if ( value( v ) != Glucose::l_Undef )
+        {
+          toggle( r, v );
+          _parities[r] ^= ( value( v ) == Glucose::l_True );
+        }
+        return true;
+      } );
+    }
+
+    /* reduced row echelon form */
+    std::vector<Glucose::Var> pivots( num_rows, var_Undef );
+    for ( auto r = 0u; r < num_rows; ++r )
+    {
+      pivots[r] = first_var( r );
+      if ( pivots[r] == var_Undef )
+      {
+        if ( _parities[r] )
+        {
+          return false;
+        }
+        continue;
+      }
+
+      for ( auto s = 0u; s < num_rows; ++s )
+      {
+        if ( s != r && test( s, pivots[r] ) )
+        {
+          add_row( s, r );
+        }
+      }
+    }
+
+    /* remove empty rows; rows with a single variable are units at level 0 */
+    _basic.clear();
+    auto out = 0u;
+    for ( auto r = 0u; r < num_rows; ++r )
+    {
+      if ( pivots[r] == var_Undef )
+      {
+        continue;
+      }
+      if ( first_var_except( r, pivots[r] ) == var_Undef )
+      {
+        uncheckedEnqueue( Glucose::mkLit( pivots[r], !_parities[r] ) );
+        continue;
+      }
+      copy_row( out++, r );
+      _basic.emplace_back( pivots[r] );
+    }
+    num_rows = out;
+    _bits.resize( uint64_t( num_rows ) * _num_words );
+    _parities.resize( num_rows );
+
+    /* watch the basic variable and one other variable of each row */
+    _watch.assign( num_rows, var_Undef );
+    _watches.assign( num_vars, {} );
+    for ( auto r = 0u; r < num_rows; ++r )
+    {
+      _watch[r] = first_var_except( r, _basic[r] );
+      _watches[_basic[r]].emplace_back( r );
+      _watches[_watch[r]].emplace_back( r );
+    }
+
+    _qhead = trail.size();
+    return true;
+  }
+
+  /* restores the watch invariant of row r and all rows changed by pivoting */
+  Glucose::CRef update_rows( uint32_t r )
+  {
+    _worklist.clear();
+    _worklist.emplace_back( r );
+    while ( !_worklist.empty() )
+    {
+      auto const s = _worklist.back();
+      _worklist.pop_back();
+
+      auto const confl = update_row( s );
+      if ( confl != Glucose::CRef_Undef )
+      {
+        _worklist.clear();
+        return confl;
+      }
+    }
+    return Glucose::CRef_Undef;
+  }
+
+  Glucose::CRef update_row( uint32_t r )
+  {
+    if ( value( _basic[r] ) != Glucose::l_Undef )
+    {
+      auto const u = first_unassigned_except( r, var_Undef );
+      if ( u == var_Undef )
+      {
+        /* all variables are assigned */
+        if ( assigned_parity( r ) != bool( _parities[r] ) )
+        {
+          return explain( r, var_Undef );
+        }
+        set_watch( r, highest_level_var_except( r, _basic[r] ) );
+        return Glucose::CRef_Undef;
+      }
+      pivot( r, u );
+    }
+
+    /* the basic variable is unassigned */
+    if ( _watch[r] != var_Undef && _watch[r] != _basic[r] && test( r, _watch[r] ) && value( _watch[r] ) == Glucose::l_Undef )
+    {
+      return Glucose::CRef_Undef;
+    }
+
+    auto const w = first_unassigned_except( r, _basic[r] );
+    if ( w != var_Undef )
+    {
+      set_watch( r, w );
+      return Glucose::CRef_Undef;
+    }
+
+    /* the row is unit on its basic variable */
+    set_watch( r, highest_level_var_except( r, _basic[r] ) );
+    return explain( r, _basic[r] );
+  }
+
+  /* makes the unassigned variable u basic in row r */
+  void pivot( uint32_t r, Glucose::Var u )
+  {
+    auto const num_rows = uint32_t( _basic.size() );
+    for ( auto s = 0u; s < num_rows; ++s )
+    {
+      if ( s != r && test( s, u ) )
+      {
+        add_row( s, r );
+        _worklist.emplace_back( s );
+      }
+    }
+
+    _basic[r] = u;
+    _watches[u].emplace_back( r );
+    if ( _watch[r] == u )
+    {
+      _watch[r] = var_Undef;
+    }
+  }
+
+  void set_watch( uint32_t r, Glucose::Var w )
+  {
+    if ( _watch[r] != w )
+    {
+      _watch[r] = w;
+      if ( w != var_Undef )
+      {
+        _watches[w].emplace_back( r );
+      }
+    }
+  }
+
+  /* creates the explanation of row r; enqueues `implied` or returns the conflict */
+  Glucose::CRef explain( uint32_t r, Glucose::Var implied )
+  {
+    if ( implied != var_Undef && decisionLevel() == 0 )
+    {
+      /* level-0 assignments need no reason */
+      ++_num_propagations;
+      uncheckedEnqueue( Glucose::mkLit( implied, assigned_parity( r ) == bool( _parities[r] ) ) );
+      return Glucose::CRef_Undef;
+    }
+
+    _lits.clear();
+    if ( implied != var_Undef )
+    {
+      auto const val = assigned_parity( r ) != bool( _parities[r] );
+      _lits.push( Glucose::mkLit( implied, !val ) );
+    }
+    for_each_var( r, [&]( Glucose::Var v ) {
+      if ( v != implied )
+      {
+        _lits.push( Glucose::mkLit( v, value( v ) == Glucose::l_True ) );
+      }
+      return true;
+    } );
+
+    /* conflict analysis expects the false literal of the highest level next to the implied literal */
+    for ( auto k = ( implied == var_Undef ? 0 : 1 ); k < std::min( 2, _lits.size() ); ++k )
+    {
+      auto best = k;
+      for ( auto i = k + 1; i < _lits.size(); ++i )
+      {
+        if ( level( Glucose::var( _lits[i] ) ) > level( Glucose::var( _lits[best] ) ) )
+        {
+          best = i;
+        }
+      }
+      std::swap( _lits[k], _lits[best] );
+    }
+
+    auto const cr = ca.alloc( _lits, false );
+    _reasons.emplace_back( cr, decisionLevel() );
+
+    if ( implied != var_Undef )
+    {
+      ++_num_propagations;
+      uncheckedEnqueue( _lits[0], cr );
+      return Glucose::CRef_Undef;
+    }
+
+    ++_num_conflicts;
+    return cr;
+  }
+
+  /* dummy conflict for an inconsistent system at level 0 */
+  Glucose::CRef unsat_reason()
+  {
+    _lits.clear();
+    _lits.push( Glucose::mkLit( 0 ) );
+    return ca.alloc( _lits, true );
+  }
+
+  bool assigned_parity( uint32_t r ) const
+  {
+    bool p = false;
+    for_each_var( r, [&]( Glucose::Var v ) {
+      p ^= ( value( v ) == Glucose::l_True );
+      return true;
+    } );
+    return p;
+  }
+
+  Glucose::Var highest_level_var_except( uint32_t r, Glucose::Var except ) const
+  {
+    Glucose::Var best = var_Undef;
+    for_each_var( r, [&]( Glucose::Var v ) {
+      if ( v != except && ( best == var_Undef || level( v ) > level( best ) ) )
+      {
+        best = v;
+      }
+      return true;
+    } );
+    return best;
+  }
+
+  Glucose::Var first_unassigned_except( uint32_t r, Glucose::Var except ) const
+  {
+    Glucose::Var found = var_Undef;
+    for_each_var( r, [&]( Glucose::Var v ) {
+      if ( v != except && value( v ) == Glucose::l_Undef )
+      {
+        found = v;
+        return false;
+      }
+      return true;
+    } );
+    return found;
+  }
+
+  Glucose::Var first_var_except( uint32_t r, Glucose::Var except ) const
+  {
+    Glucose::Var found = var_Undef;
+    for_each_var( r, [&]( Glucose::Var v ) {
+      if ( v != except )
+      {
+        found = v;
+        return false;
+      }
+      return true;
+    } );
+    return found;
+  }
+
+  Glucose::Var first_var( uint32_t r ) const
+  {
+    return first_var_except( r, var_Undef );
+  }
+
+  /* calls fn( var ) for all variables of row r until fn returns false */
+  template<typename Fn>
+  void for_each_var( uint32_t r, Fn&& fn ) const
+  {
+    auto const* row = &_bits[uint64_t( r ) * _num_words];
+    for ( auto w = 0u; w < _num_words; ++w )
+    {
+      auto word = row[w];
+      while ( word )
+      {
+        auto const v = Glucose::Var( ( w << 6u ) + __builtin_ctzll( word ) );
+        word &= word - 1u;
+        if ( !fn( v ) )
+        {
+          return;
+        }
+      }
+    }
+  }
+
+  bool test( uint32_t r, Glucose::Var v ) const
+  {
+    return ( _bits[uint64_t( r ) * _num_words + ( v >> 6u )] >> ( v & 63u ) ) & 1u;
+  }
+
+  void toggle( uint32_t r, Glucose::Var v )
+  {
+    _bits[uint64_t( r ) * _num_words + ( v >> 6u )] ^= uint64_t( 1 ) << ( v & 63u );
+  }
+
+  /* row[to] ^= row[from] */
+  void add_row( uint32_t to, uint32_t from )
+  {
+    auto* dst = &_bits[uint64_t( to ) * _num_words];
+    auto const* src = &_bits[uint64_t( from ) * _num_words];
+    for ( auto w = 0u; w < _num_words; ++w )
+    {
+      dst[w] ^= src[w];
+    }
+    _parities[to] ^= _parities[from];
+  }
+
+  void copy_row( uint32_t to, uint32_t from )
+  {
+    if ( to != from )
+    {
+      std::copy( _bits.begin() + uint64_t( from ) * _num_words, _bits.begin() + uint64_t( from + 1 ) * _num_words, _bits.begin() + uint64_t( to ) * _num_words );
+      _parities[to] = _parities[from];
+    }
+  }
+
+private:
+  std::vector<std::vector<Glucose::Var>> _pending_rows;
+  std::vector<bool> _pending_parities;
+  bool _dirty{false};
+
+  uint32_t _num_words{0u};
+  std::vector<uint64_t> _bits;
+  std::vector<uint8_t> _parities;
+  std::vector<Glucose::Var> _basic;
+  std::vector<Glucose::Var> _watch;
+  std::vector<std::vector<uint32_t>> _watches;
+  int _qhead{0};
+
+  std::vector<uint32_t> _worklist;
+  Glucose::vec<Glucose::Lit> _lits;
+  std::vector<std::pair<Glucose::CRef, int>> _reasons; /* transient reason clauses with their decision level */
+
+  uint64_t _num_propagations{0u};
+  uint64_t _num_conflicts{0u};
+
+  utils::cancellation_token const* _token{nullptr};
+}; /* gauss_jordan_solver */
+
+} /* namespace detail */
+
+} /* namespace easy::sat2 */
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -33,6 +33,7 @@
 #pragma once
 
 #include <easy/sat2/sat_solver.hpp>
+#include <easy/sat2/portfolio_sat_solver.hpp>
 #include <easy/sat2/core_utils.hpp>
 #include <easy/sat2/cardinality.hpp>
 #include <map>
@@ -42,7 +43,13 @@ namespace easy::sat2
 
 struct maxsat_linear {};
 struct maxsat_uc {};
-struct maxsat_rc2 {};
+
+/*! \brief RC2 on top of a SAT-solver back-end */
+template<typename SatSolver = sat_solver>
+struct basic_maxsat_rc2 {};
+
+using maxsat_rc2 = basic_maxsat_rc2<sat_solver>;
+using maxsat_rc2_portfolio = basic_maxsat_rc2<portfolio_sat_solver>;
 
 template<typename Algorithm>
 class maxsat_solver;
@@ -82,12 +89,60 @@ protected:
 
 struct maxsat_solver_statistics
 {
+  uint32_t num_cores{0u}; /*!< Number of processed UNSAT cores */
+  uint32_t num_levels{0u}; /*!< Number of weight levels that have been activated */
+  int64_t cost{0}; /*!< Lower bound on the optimum derived from the cores */
 }; /* maxsat_solver_statistics */
 
 struct maxsat_solver_params
 {
+  double time_budget{-1}; /*!< Wall-clock budget in seconds for portfolio back-ends (a value < 0 denotes an unconstrained budget) */
+  uint32_t num_threads{0u}; /*!< Number of threads for portfolio back-ends (0 uses the hardware concurrency) */
+  bool stratify{true}; /*!< Activate soft clauses level by level in decreasing order of their weights (RC2) */
+  bool exhaust{true}; /*!< Increase the bound of new cardinality constraints as far as possible (RC2) */
+  bool minimize{true}; /*!< Minimize UNSAT cores that required conflicts to be found before relaxing them (RC2) */
+  int64_t minimize_budget{1000}; /*!< Conflict budget for core minimization */
+  utils::cancellation_token const* token{nullptr}; /*!< Token that stops the solver with the best solution found so far once it is canceled (RC2) */
 }; /* maxsat_solver_params */
 
+namespace detail
+{
+
+template<typename SatSolver>
+struct sat_backend;
+
+template<>
+struct sat_backend<sat_solver>
+{
+  using statistics = sat_solver_statistics;
+  using params = sat_solver_params;
+
+  static params make_params( maxsat_solver_params const& ps )
+  {
+    params sat_ps;
+    sat_ps.token = ps.token;
+    return sat_ps;
+  }
+};
+
+template<>
+struct sat_backend<portfolio_sat_solver>
+{
+  using statistics = portfolio_sat_solver_statistics;
+  using params = portfolio_sat_solver_params;
+
+  static params make_params( maxsat_solver_params const& ps )
+  {
+    params sat_ps;
+    sat_ps.num_threads = ps.num_threads;
+    sat_ps.time_budget = ps.time_budget;
+    sat_ps.token = ps.token;
+    return sat_ps;
+  }
+};
+
+} /* namespace detail */
+
 template<>
 class maxsat_solver<maxsat_linear>
 {
@@ -97,6 +152,7 @@ public:
     fresh = 0,
     success = 1,
     fail = 2,
+    timeout = 3,
   }; /* state */
 
 public:
@@ -123,6 +179,15 @@ public:
     _solver.add_clause( clause );
   }
 
+  /* \brief Adds a hard XOR-clause to the solver
+   *
+   * \param clause XOR-clause to be added (the XOR of its literals is true)
+   */
+  void add_xor_clause( std::vector<int> const& clause )
+  {
+    _solver.add_xor_clause( clause );
+  }
+
   /* \brief Adds a soft clause to the solver
    *
    * \param clause Soft clause to be added
@@ -178,63 +243,39 @@ public:
       auto& cl = _soft_clauses[i];
       cl.emplace_back( -selector );
       _solver.add_clause( cl );
-      _disabled_clauses.push_back( i );
     }
 
+    if ( _solver.solve() != sat2::sat_solver::state::sat )
+    {
+      _state = state::fail;
+      return _state;
+    }
+    auto k = update_solution( _solver.get_model(), selector_to_clause_id );
+
+    /* the totalizer only needs to count up to the cost of the first solution */
     std::vector<std::vector<int>> clauses;
-    auto at_most_k = create_totalizer( clauses, _sid, _selectors, _selectors.size() );
+    auto at_most_k = create_totalizer( clauses, _sid, _selectors, k );
     for ( const auto& c : clauses )
     {
       add_clause( c );
     }
 
-    /* enforce that at most k soft clauses are satisfied */
-    uint32_t k = _selectors.size() - 1u;
-
     /* perform linear search */
-    for ( ;; )
+    while ( k > 0u )
     {
-      // std::cout << "[i] try with k = " << k << std::endl;
-
-      /* disable at-most k selectors */
-      std::vector<int> assumptions;
-      for ( auto i = 0u; i < at_most_k->vars.size(); ++i )
-      {
-        assumptions.emplace_back( i < k ? at_most_k->vars[i] : -at_most_k->vars[i] );
-      }
-
-      if ( _solver.solve( assumptions ) == sat2::sat_solver::state::unsat )
-      {
-        /* unsat */
-        _state = state::success;
-        return _state;
-      }
-
-      auto const m = _solver.get_model();
+      // std::cout << "[i] try with k = " << ( k - 1u ) << std::endl;
 
-      _enabled_clauses.clear();
-      _disabled_clauses.clear();
-      for ( const auto& s : _selectors )
+      /* enforce that less than k soft clauses are disabled */
+      if ( _solver.solve( { -at_most_k->vars[k - 1u] } ) == sat2::sat_solver::state::unsat )
       {
-        if ( m[s] )
-        {
-          _disabled_clauses.push_back( selector_to_clause_id.at( -s ) );
-        }
-        else if ( !m[s] )
-        {
-          _enabled_clauses.push_back( selector_to_clause_id.at( -s ) );
-        }
+        break;
       }
 
-      k = std::count_if( _selectors.begin(), _selectors.end(),
-                         [&m]( auto const& s ){ return m[s]; });
-      if ( k == 0 )
-      {
-        _state = state::fail;
-        return _state;
-      }
-      --k;
+      k = update_solution( _solver.get_model(), selector_to_clause_id );
     }
+
+    _state = state::success;
+    return _state;
   }
 
   std::vector<int> get_enabled_clauses() const
@@ -247,6 +288,26 @@ public:
     return _disabled_clauses;
   }
 
+protected:
+  /* updates the enabled and disabled soft clauses and returns the number of disabled ones */
+  uint32_t update_solution( model const& m, std::map<int,int> const& selector_to_clause_id )
+  {
+    _enabled_clauses.clear();
+    _disabled_clauses.clear();
+    for ( const auto& s : _selectors )
+    {
+      if ( m[s] )
+      {
+        _disabled_clauses.push_back( selector_to_clause_id.at( -s ) );
+      }
+      else
+      {
+        _enabled_clauses.push_back( selector_to_clause_id.at( -s ) );
+      }
+    }
+    return uint32_t( _disabled_clauses.size() );
+  }
+
 protected:
   state _state = state::fresh;
 
@@ -276,6 +337,7 @@ public:
     fresh = 0,
     success = 1,
     fail = 2,
+    timeout = 3,
   }; /* state */
 
 public:
@@ -302,6 +364,15 @@ public:
     _solver.add_clause( clause );
   }
 
+  /* \brief Adds a hard XOR-clause to the solver
+   *
+   * \param clause XOR-clause to be added (the XOR of its literals is true)
+   */
+  void add_xor_clause( std::vector<int> const& clause )
+  {
+    _solver.add_xor_clause( clause );
+  }
+
   /* \brief Adds a soft clause to the solver
    *
    * \param clause Soft clause to be added
@@ -496,8 +567,8 @@ protected:
   std::vector<int> _weights;
 }; /* maxsat_solver<maxsat_uc> */
 
-template<>
-class maxsat_solver<maxsat_rc2>
+template<typename SatSolver>
+class maxsat_solver<basic_maxsat_rc2<SatSolver>>
 {
 public:
   enum class state
@@ -505,6 +576,7 @@ public:
     fresh = 0,
     success = 1,
     fail = 2,
+    timeout = 3,
   }; /* state */
 
 public:
@@ -519,6 +591,7 @@ public:
     : _stats( stats )
     , _ps( ps )
     , _sid( sid )
+    , _sat_params( detail::sat_backend<SatSolver>::make_params( ps ) )
     , _solver( _sat_stats, _sat_params )
   {}
 
@@ -531,6 +604,15 @@ public:
     _solver.add_clause( clause );
   }
 
+  /* \brief Adds a hard XOR-clause to the solver
+   *
+   * \param clause XOR-clause to be added (the XOR of its literals is true)
+   */
+  void add_xor_clause( std::vector<int> const& clause )
+  {
+    _solver.add_xor_clause( clause );
+  }
+
   /* \brief Adds a soft clause to the solver
    *
    * \param clause Soft clause to be added
@@ -551,10 +633,15 @@ public:
    * The implementation is based on pysat's RC2 example [1].
    *
    * [1] https://github.com/pysathq/pysat/blob/master/examples/rc2.py
+   *
+   * If the SAT-solver runs out of its budget or the cancellation
+   * token is canceled, the procedure stops with state `timeout` and
+   * reports the best solution found so far.
    */
   state solve()
   {
-    if ( _solver.solve() == sat2::sat_solver::state::unsat )
+    auto const initial_state = _solver.solve();
+    if ( initial_state != sat2::sat_solver::state::sat )
     {
       /* it's not possible to satisfy the clauses even when ignoring all soft clauses */
       // std::cout << "[w] terminate: it's not possible to satisfy the hard clauses, even when all soft clauses are ignored" << std::endl;
@@ -571,12 +658,16 @@ public:
       return _state;
     }
 
+    /* the model of the hard clauses is the first solution */
+    _soft_weights.assign( std::begin( _weights ), std::begin( _weights ) + _soft_clauses.size() );
+    update_solution( _solver.get_model() );
+
     std::vector<int> sels;
     std::vector<int> sums;
     std::map<int,std::shared_ptr<totalizer_tree>> t_objects;
     std::map<int,int> bounds;
     std::map<int, int> selector_to_clause;
-    int costs = 0;
+    int64_t costs = 0;
 
     /* add the soft clauses */
     for ( auto i = 0u; i < _soft_clauses.size(); ++i )
@@ -600,24 +691,46 @@ public:
     /* make a copy of the selectors */
     _selectors = sels;
 
+    /* stratification: only soft clauses with a weight of at least `level` are assumed */
+    auto const weight_of = [&]( int l ){ return _weights.at( selector_to_clause.at( l ) ); };
+    auto level = _ps.stratify ? next_level( sels, weight_of, std::numeric_limits<int>::max() ) : std::numeric_limits<int>::min();
+    ++_stats.num_levels;
+
     auto iteration = 0;
     for ( ;; )
     {
-      /* assume all soft-clauses are enabled, which causes the problem to be UNSAT */
+      /* assume all active soft-clauses are enabled, which causes the problem to be UNSAT */
       std::vector<int> assumptions;
       for ( const auto& s : sels )
       {
-        assumptions.emplace_back( s );
+        if ( weight_of( s ) >= level )
+        {
+          assumptions.emplace_back( s );
+        }
       }
       for ( const auto& s : sums )
       {
         assumptions.emplace_back( s );
       }
 
+      auto const num_conflicts = _solver.get_num_conflicts();
       auto const state = _solver.solve( assumptions );
       if ( state == sat2::sat_solver::state::sat )
       {
         auto const model = _solver.get_model();
+
+        /* activate the next weight level */
+        auto const lower = _ps.stratify ? next_level( sels, weight_of, level ) : std::numeric_limits<int>::min();
+        if ( lower != std::numeric_limits<int>::min() )
+        {
+          update_solution( model );
+          level = lower;
+          ++_stats.num_levels;
+          continue;
+        }
+
+        _enabled_clauses.clear();
+        _disabled_clauses.clear();
         for ( auto i = 0u; i < _soft_clauses.size(); ++i )
         {
           if ( model[_selectors[i]] )
@@ -630,10 +743,23 @@ public:
           }
         }
         // assert( _disabled_clauses.size() <= costs );
-        return state::success;
+        _state = state::success;
+        return _state;
+      }
+      else if ( state == sat2::sat_solver::state::dirty )
+      {
+        /* budget exhausted: keep the best solution found so far */
+        _state = state::timeout;
+        return _state;
       }
 
-      auto const core = _solver.get_core();
+      /* cores that follow from unit propagation alone are not worth minimizing */
+      auto core = _solver.get_core();
+      if ( _ps.minimize && core.size() > 1u && _solver.get_num_conflicts() > num_conflicts )
+      {
+        minimize_core( _solver, core, _ps.minimize_budget );
+      }
+      ++_stats.num_cores;
       // std::cout << "[i] core: "; core.print(); std::cout << std::endl;
 
       /* divide core into sels and sums */
@@ -768,17 +894,18 @@ public:
             add_clause( c );
           }
 
-          /* TODO: exhaust core */
-          auto b = 1;
-          /* invoke set bound */
+          auto const b = _ps.exhaust ? exhaust_core( totalizer_tree, uint32_t( rels.size() ), w_min, costs ) : 1u;
 
           /* save the info about this sum and add its assumption literal */
-          t_objects.emplace( -totalizer_tree->vars[b], totalizer_tree );
-          bounds.emplace( -totalizer_tree->vars[b], b );
-          selector_to_clause.emplace( -totalizer_tree->vars[b], _weights.size() );
-          _weights.push_back( w_min );
+          if ( b < rels.size() )
+          {
+            t_objects.emplace( -totalizer_tree->vars[b], totalizer_tree );
+            bounds.emplace( -totalizer_tree->vars[b], b );
+            selector_to_clause.emplace( -totalizer_tree->vars[b], _weights.size() );
+            _weights.push_back( w_min );
 
-          sums.push_back( -totalizer_tree->vars[b] );
+            sums.push_back( -totalizer_tree->vars[b] );
+          }
         }
       }
       else
@@ -789,6 +916,14 @@ public:
         add_clause( { -core_sels[0] } );
         garbage.push_back( core_sels[0] );
       }
+      _stats.cost = costs;
+
+      /* the best solution found so far meets the lower bound */
+      if ( costs >= _best_cost )
+      {
+        _state = state::success;
+        return _state;
+      }
 
       /* cleanup garbage */
       sels.erase( std::remove_if( std::begin( sels ), std::end( sels ),
@@ -822,6 +957,89 @@ public:
     return _disabled_clauses;
   }
 
+protected:
+  /* returns the largest weight of a selector below `level` (the minimum int if there is none) */
+  template<typename WeightFn>
+  static int next_level( std::vector<int> const& sels, WeightFn&& weight_of, int level )
+  {
+    auto lower = std::numeric_limits<int>::min();
+    for ( const auto& s : sels )
+    {
+      auto const w = weight_of( s );
+      if ( w < level && w > lower )
+      {
+        lower = w;
+      }
+    }
+    return lower;
+  }
+
+  /* increases the bound of a new totalizer while the core stays UNSAT; returns the first satisfiable bound */
+  uint32_t exhaust_core( std::shared_ptr<totalizer_tree>& t, uint32_t num_inputs, int w_min, int64_t& costs )
+  {
+    auto b = 1u;
+    while ( b < num_inputs )
+    {
+      std::vector<std::vector<int>> clauses;
+      increase_totalizer( clauses, _sid, t, b );
+      for ( const auto& c : clauses )
+      {
+        add_clause( c );
+      }
+
+      auto const state = _solver.solve( { -t->vars[b] } );
+      if ( state == sat2::sat_solver::state::sat )
+      {
+        update_solution( _solver.get_model() );
+      }
+      if ( state != sat2::sat_solver::state::unsat )
+      {
+        break;
+      }
+
+      /* at least b + 1 clauses of the core are relaxed */
+      costs += w_min;
+      ++b;
+    }
+    return b;
+  }
+
+  /* keeps the enabled and disabled soft clauses of a model of the hard clauses if it improves the best solution */
+  void update_solution( model const& m )
+  {
+    std::vector<uint8_t> satisfied( _soft_clauses.size() );
+    int64_t cost = 0;
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
+    {
+      satisfied[i] = std::any_of( std::begin( _soft_clauses[i] ), std::end( _soft_clauses[i] ),
+                                  [&m]( int l ){ return uint64_t( std::abs( l ) ) <= m.size() && m[l]; } );
+      if ( !satisfied[i] )
+      {
+        cost += _soft_weights[i];
+      }
+    }
+
+    if ( cost >= _best_cost )
+    {
+      return;
+    }
+    _best_cost = cost;
+
+    _enabled_clauses.clear();
+    _disabled_clauses.clear();
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
+    {
+      if ( satisfied[i] )
+      {
+        _enabled_clauses.push_back( i );
+      }
+      else
+      {
+        _disabled_clauses.push_back( i );
+      }
+    }
+  }
+
 protected:
   state _state = state::fresh;
 
@@ -829,9 +1047,9 @@ protected:
   maxsat_solver_params const& _ps;
   int& _sid;
 
-  sat_solver_statistics _sat_stats;
-  sat_solver_params _sat_params;
-  sat_solver _solver;
+  typename detail::sat_backend<SatSolver>::statistics _sat_stats;
+  typename detail::sat_backend<SatSolver>::params _sat_params;
+  SatSolver _solver;
 
   std::vector<int> _selectors;
 
@@ -840,6 +1058,9 @@ protected:
 
   std::vector<std::vector<int>> _soft_clauses;
   std::vector<int> _weights;
-}; /* maxsat_solver<maxsat_rc2> */
+
+  std::vector<int> _soft_weights; /* original weights of the soft clauses */
+  int64_t _best_cost = std::numeric_limits<int64_t>::max();
+}; /* maxsat_solver<basic_maxsat_rc2> */
 
 } /* easy::sat2 */
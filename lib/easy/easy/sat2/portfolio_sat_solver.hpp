@@ -0,0 +1,695 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file portfolio_sat_solver.hpp
+  \brief Multi-threaded portfolio SAT-solver with clause sharing
+
+  \author Heinz Riener
+
+  A number of diversified Glucose instances solve the same problem in
+  parallel.  The first instance that terminates decides the result
+  and interrupts all other instances.  Short learned clauses are
+  exchanged between the instances through a lock-free broadcast
+  buffer, which is based on the clause sharing scheme of
+  Glucose-Syrup [1].
+
+  [1] Gilles Audemard, Laurent Simon: Lazy Clause Exchange Policy for
+      Parallel SAT Solvers. SAT 2014: 197-205
+*/
+
+#pragma once
+
+#include <easy/sat2/sat_solver.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace easy::sat2
+{
+
+namespace detail
+{
+
+/*! \brief Lock-free broadcast buffer for learned clauses
+ *
+ * Every worker owns one ring buffer to which it is the only writer.
+ * All other workers read from the ring with a private cursor.  A slot
+ * is protected by a sequence stamp (seqlock): the writer marks the
+ * slot odd while writing and even afterwards, and readers discard a
+ * slot if the stamp changed while copying.  If a reader falls behind
+ * by more than the capacity of a ring, the overwritten clauses are
+ * lost, which is harmless for clause sharing.
+ */
+class clause_exchange
+{
+public:
+  explicit clause_exchange( uint32_t num_workers, uint32_t capacity, uint32_t max_size )
+    : _num_workers( num_workers )
+    , _capacity( capacity )
+    , _max_size( max_size )
+    , _heads( std::make_unique<std::atomic<uint64_t>[]>( num_workers ) )
+    , _stamps( std::make_unique<std::atomic<uint64_t>[]>( uint64_t( num_workers ) * capacity ) )
+    , _sizes( std::make_unique<std::atomic<uint32_t>[]>( uint64_t( num_workers ) * capacity ) )
+    , _lits( std::make_unique<std::atomic<int32_t>[]>( uint64_t( num_workers ) * capacity * max_size ) )
+  {
+    for ( auto i = 0u; i < num_workers; ++i )
+    {
+      _heads[i].store( 0u, std::memory_order_relaxed );
+    }
+    for ( auto i = 0ul; i < uint64_t( num_workers ) * capacity; ++i )
+    {
+      _stamps[i].store( 0u, std::memory_order_relaxed );
+      _sizes[i].store( 0u, std::memory_order_relaxed );
+    }
+    for ( auto i = 0ul; i < uint64_t( num_workers ) * capacity * max_size; ++i )
+    {
+      _lits[i].store( 0, std::memory_order_relaxed );
+    }
+  }
+
+  uint32_t num_workers() const
+  {
+    return _num_workers;
+  }
+
+  uint32_t max_size() const
+  {
+    return _max_size;
+  }
+
+  /*! \brief Publishes a clause in the ring of worker `id` */
+  template<typename Clause>
+  void push( uint32_t id, Clause const& c, uint32_t size )
+  {
+    assert( size <= _max_size );
+    auto const k = _heads[id].load( std::memory_order_relaxed );
+    auto const slot = uint64_t( id ) * _capacity + k % _capacity;
+
+    _stamps[slot].store( 2u * k + 1u, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    _sizes[slot].store( size, std::memory_order_relaxed );
+    for ( auto i = 0u; i < size; ++i )
+    {
+      _lits[slot * _max_size + i].store( Glucose::toInt( c[i] ), std::memory_order_relaxed );
+    }
+    _stamps[slot].store( 2u * k + 2u, std::memory_order_release );
+    _heads[id].store( k + 1u, std::memory_order_release );
+  }
+
+  /*! \brief Reads all clauses of worker `id` published after `cursor`
+   *
+   * Calls `fn( lits )` for each clause, where `lits` is a vector of
+   * Glucose literals, and advances `cursor`.
+   */
+  template<typename Fn>
+  void pull( uint32_t id, uint64_t& cursor, Glucose::vec<Glucose::Lit>& lits, Fn&& fn ) const
+  {
+    auto const head = _heads[id].load( std::memory_order_acquire );
+    if ( head > cursor + _capacity )
+    {
+      cursor = head - _capacity;
+    }
+
+    for ( ; cursor < head; ++cursor )
+    {
+      auto const slot = uint64_t( id ) * _capacity + cursor % _capacity;
+      auto const stamp = _stamps[slot].load( std::memory_order_acquire );
+      if ( stamp != 2u * cursor + 2u )
+      {
+        continue;
+      }
+
+      lits.clear();
+      auto const size = _sizes[slot].load( std::memory_order_relaxed );
+      for ( auto i = 0u; i < size && i < _max_size; ++i )
+      {
+        lits.push( Glucose::toLit( _lits[slot * _max_size + i].load( std::memory_order_relaxed ) ) );
+      }
+
+      std::atomic_thread_fence( std::memory_order_acquire );
+      if ( _stamps[slot].load( std::memory_order_relaxed ) != stamp )
+      {
+        continue;
+      }
+
+      fn( lits );
+    }
+  }
+
+protected:
+  uint32_t _num_workers;
+  uint32_t _capacity;
+  uint32_t _max_size;
+
+  std::unique_ptr<std::atomic<uint64_t>[]> _heads;
+  std::unique_ptr<std::atomic<uint64_t>[]> _stamps;
+  std::unique_ptr<std::atomic<uint32_t>[]> _sizes;
+  std::unique_ptr<std::atomic<int32_t>[]> _lits;
+}; /* clause_exchange */
+
+/*! \brief Glucose instance taking part in a portfolio
+ *
+ * Overrides the parallel hooks of Glucose to export short learned
+ * clauses, to import the clauses learned by the other workers at
+ * decision level 0, and to stop as soon as another worker has
+ * finished or the deadline has passed.
+ */
+class portfolio_worker : public gauss_jordan_solver
+{
+public:
+  explicit portfolio_worker( uint32_t id, clause_exchange& exchange, std::atomic<bool> const& stop, uint32_t max_lbd )
+    : _id( id )
+    , _exchange( exchange )
+    , _stop( stop )
+    , _max_lbd( max_lbd )
+    , _cursors( exchange.num_workers(), 0u )
+  {}
+
+  /*! \brief Diversifies the search strategy of the i-th worker */
+  void diversify( uint32_t seed )
+  {
+    if ( _id == 0u )
+    {
+      /* the first worker keeps the default configuration */
+      return;
+    }
+
+    random_seed = double( seed + 7919u * _id );
+    rnd_init_act = true;
+    random_var_freq = ( _id % 2u == 1u ) ? 0.02 : 0.0;
+    luby_restart = ( _id % 3u == 1u );
+    phase_saving = ( _id % 4u == 2u ) ? 1 : 2;
+    randomizeFirstDescent = ( _id % 4u == 3u );
+  }
+
+  void set_deadline( std::chrono::steady_clock::time_point const* deadline )
+  {
+    _deadline = deadline;
+  }
+
+  /*! \brief Resets the interruption flag after a parallel run */
+  void finish()
+  {
+    clearInterrupt();
+  }
+
+  uint64_t num_exported() const
+  {
+    return _num_exported;
+  }
+
+  uint64_t num_imported() const
+  {
+    return _num_imported;
+  }
+
+protected:
+  void parallelExportUnaryClause( Glucose::Lit p ) override
+  {
+    Glucose::Lit const lits[1] = {p};
+    _exchange.push( _id, lits, 1u );
+    ++_num_exported;
+  }
+
+  void parallelExportClauseDuringSearch( Glucose::Clause& c ) override
+  {
+    if ( uint32_t( c.size() ) > _exchange.max_size() || c.lbd() > _max_lbd )
+    {
+      return;
+    }
+    _exchange.push( _id, c, c.size() );
+    ++_num_exported;
+  }
+
+  bool parallelImportClauses() override
+  {
+    assert( decisionLevel() == 0 );
+
+    bool empty_clause = false;
+    for ( auto i = 0u; i < _exchange.num_workers() && !empty_clause; ++i )
+    {
+      if ( i == _id )
+      {
+        continue;
+      }
+
+      _exchange.pull( i, _cursors[i], _lits, [&]( Glucose::vec<Glucose::Lit>& lits ) {
+        if ( !empty_clause )
+        {
+          empty_clause = !import_clause( lits );
+        }
+      } );
+    }
+    return empty_clause;
+  }
+
+  bool parallelJobIsFinished() override
+  {
+    if ( _stop.load( std::memory_order_relaxed ) ||
+         ( _deadline && std::chrono::steady_clock::now() >= *_deadline ) )
+    {
+      /* the flag is only written from the thread that runs the worker */
+      interrupt();
+      return true;
+    }
+    return gauss_jordan_solver::parallelJobIsFinished();
+  }
+
+private:
+  /* adds a clause learned by another worker; returns false if the clause is empty at level 0 */
+  bool import_clause( Glucose::vec<Glucose::Lit>& lits )
+  {
+    auto j = 0;
+    for ( auto i = 0; i < lits.size(); ++i )
+    {
+      if ( Glucose::var( lits[i] ) >= nVars() )
+      {
+        /* the clause refers to a variable that is not yet known (cannot happen for clauses of the same round) */
+        return true;
+      }
+
+      auto const v = value( lits[i] );
+      if ( v == Glucose::l_True )
+      {
+        return true;
+      }
+      else if ( v == Glucose::l_Undef )
+      {
+        lits[j++] = lits[i];
+      }
+    }
+    lits.shrink( lits.size() - j );
+
+    ++_num_imported;
+    if ( lits.size() == 0 )
+    {
+      return false;
+    }
+    else if ( lits.size() == 1 )
+    {
+      uncheckedEnqueue( lits[0] );
+      return true;
+    }
+
+    Glucose::CRef const cr = ca.alloc( lits, true );
+    ca[cr].setLBD( lits.size() );
+    ca[cr].setOneWatched( false );
+    learnts.push( cr );
+    attachClause( cr );
+    return true;
+  }
+
+private:
+  uint32_t _id;
+  clause_exchange& _exchange;
+  std::atomic<bool> const& _stop;
+  uint32_t _max_lbd;
+  std::chrono::steady_clock::time_point const* _deadline{nullptr};
+
+  std::vector<uint64_t> _cursors;
+  Glucose::vec<Glucose::Lit> _lits;
+
+  uint64_t _num_exported{0};
+  uint64_t _num_imported{0};
+}; /* portfolio_worker */
+
+} /* namespace detail */
+
+struct portfolio_sat_solver_statistics
+{
+  uint64_t num_exported{0}; /*!< Number of exported learned clauses */
+  uint64_t num_imported{0}; /*!< Number of imported learned clauses */
+  uint64_t num_timeouts{0}; /*!< Number of calls interrupted by the wall-clock budget */
+};
+
+struct portfolio_sat_solver_params
+{
+  uint32_t num_threads{0u};        /*!< Number of solver instances (0 uses the hardware concurrency) */
+  uint32_t seed{0x5eed};           /*!< Seed used to diversify the solver instances */
+  uint32_t max_shared_size{8u};    /*!< Maximum size of shared learned clauses */
+  uint32_t max_shared_lbd{3u};     /*!< Maximum LBD of shared learned clauses */
+  uint32_t exchange_capacity{1024u}; /*!< Number of clauses buffered per solver instance */
+  mutable int64_t budget{-1};      /*!< Conflict budget per instance (a value < 0 denotes an unconstrained budget) */
+  mutable double time_budget{-1};  /*!< Wall-clock budget in seconds (a value < 0 denotes an unconstrained budget) */
+  utils::cancellation_token const* token{nullptr}; /*!< Token that interrupts all instances once it is canceled */
+};
+
+class portfolio_sat_solver
+{
+public:
+  using state = sat_solver::state;
+
+public:
+  /* \brief Constructor
+   *
+   * Constructs a portfolio SAT-solver
+   *
+   * \param stats Statistics
+   * \param ps Parameters
+   */
+  explicit portfolio_sat_solver( portfolio_sat_solver_statistics& stats, portfolio_sat_solver_params& ps )
+    : _stats( stats )
+    , _ps( ps )
+    , _num_workers( ps.num_threads > 0u ? ps.num_threads : std::max( 1u, std::thread::hardware_concurrency() ) )
+    , _exchange( _num_workers, ps.exchange_capacity, ps.max_shared_size )
+  {
+    for ( auto i = 0u; i < _num_workers; ++i )
+    {
+      _workers.emplace_back( std::make_unique<detail::portfolio_worker>( i, _exchange, _stop, ps.max_shared_lbd ) );
+      _workers.back()->diversify( ps.seed );
+      _workers.back()->set_cancellation_token( ps.token );
+    }
+  }
+
+  /* \brief Set conflict budget */
+  void set_budget( int64_t budget )
+  {
+    _ps.budget = budget;
+  }
+
+  /* \brief Reset conflict budget */
+  void reset_budget()
+  {
+    _ps.budget = -1;
+  }
+
+  /* \brief Returns the conflict budget (a value < 0 denotes an unconstrained budget) */
+  int64_t get_budget() const
+  {
+    return _ps.budget;
+  }
+
+  /* \brief Set wall-clock budget in seconds
+   *
+   * The budget is shared by all subsequent calls to solve and starts
+   * with the next call.
+   */
+  void set_time_budget( double seconds )
+  {
+    _ps.time_budget = seconds;
+    _deadline_started = false;
+  }
+
+  /* \brief Reset wall-clock budget */
+  void reset_time_budget()
+  {
+    _ps.time_budget = -1;
+    _deadline_started = false;
+  }
+
+  /*! \brief Returns true if and only if the wall-clock budget is exhausted */
+  bool is_timeout() const
+  {
+    return _deadline_started && std::chrono::steady_clock::now() >= _deadline;
+  }
+
+  /*! \brief Return the current state of the SAT-solver */
+  state get_state() const
+  {
+    return _state;
+  }
+
+  /*! \brief Returns the number of variables */
+  uint32_t get_num_variables() const
+  {
+    return _num_variables;
+  }
+
+  /*! \brief Returns the number of conflicts of all solver instances */
+  uint64_t get_num_conflicts() const
+  {
+    uint64_t num_conflicts = 0u;
+    for ( const auto& w : _workers )
+    {
+      num_conflicts += w->conflicts;
+    }
+    return num_conflicts;
+  }
+
+  /*! \brief Returns the number of solver instances */
+  uint32_t get_num_threads() const
+  {
+    return _num_workers;
+  }
+
+  /*! \brief Check satisfiability under assumptions with respect to the budgets
+   *
+   * All solver instances run in parallel; the first one that
+   * terminates determines the result.  If a budget is exhausted, the
+   * SAT-solver is in state UNKNOWN.
+   *
+   * \param assumption A vector of assumption literals assumed to be true
+   *
+   * Returns the current state of the SAT-solver
+   */
+  state solve( std::vector<int> const& assumptions = {} )
+  {
+    Glucose::vec<Glucose::Lit> ass;
+    for ( const auto& l : assumptions )
+    {
+      const uint32_t v = abs( l ) - 1;
+      ensure_variable( v );
+      ass.push( Glucose::mkLit( v, l < 0 ) );
+    }
+
+    std::chrono::steady_clock::time_point const* deadline = nullptr;
+    if ( _ps.time_budget >= 0 )
+    {
+      if ( !_deadline_started )
+      {
+        _deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( _ps.time_budget ) );
+        _deadline_started = true;
+      }
+      if ( std::chrono::steady_clock::now() >= _deadline )
+      {
+        ++_stats.num_timeouts;
+        return ( _state = state::dirty );
+      }
+      deadline = &_deadline;
+    }
+
+    _stop.store( false, std::memory_order_relaxed );
+    _winner.store( -1, std::memory_order_relaxed );
+    std::vector<Glucose::lbool> results( _num_workers, Glucose::l_Undef );
+
+    auto const run = [&]( uint32_t i ) {
+      auto& w = *_workers[i];
+      w.set_deadline( deadline );
+      if ( _ps.budget > -1 )
+      {
+        w.setConfBudget( _ps.budget );
+      }
+      else
+      {
+        w.budgetOff();
+      }
+
+      results[i] = w.solveLimited( ass );
+      if ( results[i] != Glucose::l_Undef )
+      {
+        int expected = -1;
+        _winner.compare_exchange_strong( expected, int( i ) );
+        _stop.store( true, std::memory_order_relaxed );
+      }
+    };
+
+    /* the calling thread runs the first instance */
+    std::vector<std::thread> threads;
+    for ( auto i = 1u; i < _num_workers; ++i )
+    {
+      threads.emplace_back( run, i );
+    }
+    run( 0u );
+    for ( auto& t : threads )
+    {
+      t.join();
+    }
+
+    _stats.num_exported = 0u;
+    _stats.num_imported = 0u;
+    for ( auto& w : _workers )
+    {
+      w->finish();
+      _stats.num_exported += w->num_exported();
+      _stats.num_imported += w->num_imported();
+    }
+
+    auto const winner = _winner.load( std::memory_order_relaxed );
+    if ( winner < 0 )
+    {
+      if ( is_timeout() )
+      {
+        ++_stats.num_timeouts;
+      }
+      return ( _state = state::dirty );
+    }
+
+    _last_winner = winner;
+    if ( results[winner] == Glucose::l_True )
+    {
+      return ( _state = state::sat );
+    }
+    else
+    {
+      return ( _state = state::unsat );
+    }
+  }
+
+  /*! \brief Add a clause to the SAT-solver */
+  void add_clause( std::vector<int> const& clause )
+  {
+    /* update state */
+    _state = state::dirty;
+
+    Glucose::vec<Glucose::Lit> cl;
+    for ( const auto& l : clause )
+    {
+      const uint32_t v = abs( l ) - 1;
+      ensure_variable( v );
+      cl.push( Glucose::mkLit( v, l < 0 ) );
+    }
+
+    for ( auto& w : _workers )
+    {
+      Glucose::vec<Glucose::Lit> copy;
+      cl.copyTo( copy );
+      w->addClause( copy );
+    }
+  }
+
+  /*! \brief Add an XOR-clause to the SAT-solver
+   *
+   * The XOR of the literals is constrained to be true.
+   */
+  void add_xor_clause( std::vector<int> const& clause )
+  {
+    /* update state */
+    _state = state::dirty;
+
+    Glucose::vec<Glucose::Lit> cl;
+    for ( const auto& l : clause )
+    {
+      const uint32_t v = abs( l ) - 1;
+      ensure_variable( v );
+      cl.push( Glucose::mkLit( v, l < 0 ) );
+    }
+
+    for ( auto& w : _workers )
+    {
+      w->add_xor_clause( cl );
+    }
+  }
+
+  /*! \brief Returns model if solver is in state SAT */
+  model get_model() const
+  {
+    assert( is_sat() );
+
+    auto const& w = *_workers[_last_winner];
+    const uint32_t size = w.model.size();
+    utils::dynamic_bitset<> m;
+    for ( auto i = 0u; i < size; ++i )
+    {
+      m.push_back( w.model[i] == Glucose::l_True );
+    }
+    return model( m );
+  }
+
+  /*! \brief Return core if solver is in UNSAT state */
+  core<> get_core() const
+  {
+    assert( is_unsat() );
+
+    auto const& w = *_workers[_last_winner];
+    const uint32_t size = w.conflict.size();
+    std::vector<int> lits( size );
+    for ( auto i = 0u; i < size; ++i )
+    {
+      lits[i] = Glucose::sign( w.conflict[i] ) ? ( ( Glucose::var( w.conflict[i] )+1 ) ) : -( Glucose::var( w.conflict[i] )+1 );
+    }
+    return core( lits );
+  }
+
+  /*! \brief Returns true if and only if SAT-solver is in state UNKNOWN. */
+  bool is_unknown() const
+  {
+    return _state == state::dirty;
+  }
+
+  /*! \brief Returns true if and only if SAT-solver state is in state SAT. */
+  bool is_sat() const
+  {
+    return _state == state::sat;
+  }
+
+  /*! \brief Returns true if and only if SAT-solver is in state UNSAT. */
+  bool is_unsat() const
+  {
+    return _state == state::unsat;
+  }
+
+protected:
+  void ensure_variable( uint32_t v )
+  {
+    while ( _num_variables <= v )
+    {
+      for ( auto& w : _workers )
+      {
+        w->newVar();
+      }
+      ++_num_variables;
+    }
+  }
+
+protected:
+  portfolio_sat_solver_statistics& _stats;
+  portfolio_sat_solver_params const& _ps;
+
+  uint32_t _num_workers;
+  detail::clause_exchange _exchange;
+  std::vector<std::unique_ptr<detail::portfolio_worker>> _workers;
+
+  std::atomic<bool> _stop{false};
+  std::atomic<int> _winner{-1};
+  int _last_winner{0};
+
+  bool _deadline_started{false};
+  std::chrono::steady_clock::time_point _deadline;
+
+  state _state{state::fresh};
+  uint32_t _num_variables{0};
+}; /* portfolio_sat_solver */
+
+} /* namespace easy::sat2 */
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
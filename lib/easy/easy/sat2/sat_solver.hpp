@@ -48,6 +48,7 @@
 #include <glucose/glucose.hpp>
 #endif
 
+#include <easy/sat2/gauss_jordan.hpp>
 #include <easy/utils/dynamic_bitset.hpp>
 #include <algorithm>
 #include <iostream>
@@ -216,6 +217,7 @@ struct sat_solver_statistics
 struct sat_solver_params
 {
   mutable int64_t budget{-1}; /*>! Conflict budget (a value < 0 denotes an unconstrained budget) */
+  utils::cancellation_token const* token{nullptr}; /*!< Token that interrupts the search at the next conflict once it is canceled */
 };
 
 class sat_solver
@@ -238,10 +240,12 @@ public:
    * \param ps Parameters
    */
   explicit sat_solver( sat_solver_statistics& stats, sat_solver_params& ps )
-    : _glucose( std::make_unique<Glucose::Solver>() )
+    : _glucose( std::make_unique<detail::gauss_jordan_solver>() )
     , _stats( stats )
     , _ps( ps )
-  {}
+  {
+    _glucose->set_cancellation_token( ps.token );
+  }
 
   /* \brief Set conflict budget */
   void set_budget( int64_t budget )
@@ -257,6 +261,12 @@ public:
     _glucose->budgetOff();
   }
 
+  /* \brief Returns the conflict budget (a value < 0 denotes an unconstrained budget) */
+  int64_t get_budget() const
+  {
+    return _ps.budget;
+  }
+
   /*! \brief Return the current state of the SAT-solver */
   state get_state() const
   {
@@ -269,7 +279,16 @@ public:
     return _num_variables;
   }
 
+  /*! \brief Returns the number of conflicts of all calls to solve */
+  uint64_t get_num_conflicts() const
+  {
+    return _glucose->conflicts;
+  }
+
   /*! \brief Check satisfiability under assumptions with respect to the conflict budget
+   *
+   * If the conflict budget is exhausted or the cancellation token is
+   * canceled, the SAT-solver is in state UNKNOWN.
    *
    * \param assumption A vector of assumption literals assumed to be true
    *
@@ -277,7 +296,7 @@ public:
    */
   state solve( std::vector<int> const& assumptions = {} )
   {
-    if ( _ps.budget > -1 )
+    if ( _ps.budget > -1 || _ps.token )
     {
       return solve_limited( assumptions );
     }
@@ -347,7 +366,8 @@ public:
     }
 
     auto const result = _glucose->solveLimited( ass );
-    if ( result == Glucose::l_Undef || int32_t(_glucose->conflicts) >= _ps.budget )
+    _glucose->clearInterrupt();
+    if ( result == Glucose::l_Undef )
     {
       return ( _state = state::dirty );
     }
@@ -382,6 +402,30 @@ public:
     _glucose->addClause( cl );
   }
 
+  /*! \brief Add an XOR-clause to the SAT-solver
+   *
+   * The XOR of the literals is constrained to be true.  XOR-clauses
+   * are propagated natively by Gauss-Jordan elimination.
+   */
+  void add_xor_clause( std::vector<int> const& clause )
+  {
+    /* update state */
+    _state = state::dirty;
+
+    Glucose::vec<Glucose::Lit> cl;
+    for ( const auto& l : clause )
+    {
+      const uint32_t v = abs( l ) - 1;
+      while ( _num_variables <= v )
+      {
+        _glucose->newVar();
+        ++_num_variables;
+      }
+      cl.push( Glucose::mkLit( v, l < 0 ) );
+    }
+    _glucose->add_xor_clause( cl );
+  }
+
   /*! \brief Returns model if solver is in state SAT */
   model get_model() const
   {
@@ -429,7 +473,7 @@ public:
   }
 
 protected:
-  std::unique_ptr<Glucose::Solver> _glucose;
+  std::unique_ptr<detail::gauss_jordan_solver> _glucose;
   sat_solver_statistics& _stats;
   sat_solver_params const& _ps;
   state _state{state::fresh};
@@ -0,0 +1,229 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file cancellation.hpp
+  \brief Cooperative cancellation
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace easy::utils
+{
+
+/*! \brief Cancellation token with an optional deadline
+ *
+ * Long-running algorithms poll the token at safe points and stop as
+ * soon as it is canceled, either explicitly with `cancel`, which may
+ * be called from any thread, or because its deadline has passed.
+ * Algorithms that can stop with a valid result return the best result
+ * found so far.
+ *
+ * The token also keeps an integer flag that can be handed to SAT
+ * solvers which poll an `int*` stop flag (`stop_flag`).  Such solvers
+ * do not observe the deadline by themselves: the flag is raised by the
+ * first call to `is_canceled` after the deadline, or in time by a
+ * `deadline_watcher`.
+ *
+ * The deadline must be set before the token is shared with other
+ * threads.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      cancellation_token token( 10.0 ); // expires in 10 seconds
+
+      tbs_params ps;
+      ps.token = &token;
+      auto network = tbs<netlist<mcst_gate>>( permutation, ps );
+      if ( token.is_canceled() ) { ... }
+   \endverbatim
+ */
+class cancellation_token
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  /*! \brief Constructs a token without deadline */
+  cancellation_token() = default;
+
+  /*! \brief Constructs a token that expires after `seconds` (a value < 0 denotes no deadline) */
+  explicit cancellation_token( double seconds )
+  {
+    set_time_budget( seconds );
+  }
+
+  cancellation_token( cancellation_token const& ) = delete;
+  cancellation_token& operator=( cancellation_token const& ) = delete;
+
+  /*! \brief Cancels the token */
+  void cancel()
+  {
+    _flag.store( true, std::memory_order_relaxed );
+    raise_stop_flag();
+  }
+
+  /*! \brief Sets the deadline */
+  void set_deadline( clock::time_point deadline )
+  {
+    _deadline = deadline;
+    _has_deadline = true;
+  }
+
+  /*! \brief Sets the deadline to `seconds` from now (a value < 0 removes the deadline)
+   *
+   * A budget of 0 cancels the token right away, so that the first poll
+   * stops independently of the clock.
+   */
+  void set_time_budget( double seconds )
+  {
+    if ( seconds < 0 )
+    {
+      _has_deadline = false;
+      return;
+    }
+    set_deadline( clock::now() + std::chrono::duration_cast<clock::duration>( std::chrono::duration<double>( seconds ) ) );
+    if ( seconds == 0 )
+    {
+      cancel();
+    }
+  }
+
+  bool has_deadline() const
+  {
+    return _has_deadline;
+  }
+
+  clock::time_point deadline() const
+  {
+    return _deadline;
+  }
+
+  /*! \brief Returns true if and only if the token is canceled or its deadline has passed */
+  bool is_canceled() const
+  {
+    if ( _flag.load( std::memory_order_relaxed ) )
+    {
+      return true;
+    }
+    if ( _has_deadline && clock::now() >= _deadline )
+    {
+      _flag.store( true, std::memory_order_relaxed );
+      raise_stop_flag();
+      return true;
+    }
+    return false;
+  }
+
+  /*! \brief Stop flag for SAT solvers that poll an `int*` (non-zero once canceled)
+   *
+   * The flag is a plain integer that is only written with atomic
+   * builtins, in the same way as ABC's solvers read it.
+   */
+  int* stop_flag() const
+  {
+    return &_stop;
+  }
+
+private:
+  void raise_stop_flag() const
+  {
+#if defined( __GNUC__ ) || defined( __clang__ )
+    __atomic_store_n( &_stop, 1, __ATOMIC_RELAXED );
+#else
+    *static_cast<int volatile*>( &_stop ) = 1;
+#endif
+  }
+
+  mutable std::atomic<bool> _flag{false};
+  mutable int _stop{0};
+  clock::time_point _deadline{};
+  bool _has_deadline{false};
+};
+
+/*! \brief Raises the stop flag of a token at its deadline
+ *
+ * Starts a thread that waits until the deadline of the token, such
+ * that SAT solvers that only poll `stop_flag` stop in time.  The
+ * thread ends when the watcher is destroyed.  Nothing is started for
+ * a null token or a token without deadline.
+ */
+class deadline_watcher
+{
+public:
+  explicit deadline_watcher( cancellation_token const* token )
+  {
+    if ( token == nullptr || !token->has_deadline() )
+    {
+      return;
+    }
+
+    _thread = std::thread( [this, token]() {
+      std::unique_lock<std::mutex> lock( _mutex );
+      if ( !_cv.wait_until( lock, token->deadline(), [this]() { return _done; } ) )
+      {
+        /* polling after the deadline raises the flag */
+        token->is_canceled();
+      }
+    } );
+  }
+
+  deadline_watcher( deadline_watcher const& ) = delete;
+  deadline_watcher& operator=( deadline_watcher const& ) = delete;
+
+  ~deadline_watcher()
+  {
+    if ( !_thread.joinable() )
+    {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      _done = true;
+    }
+    _cv.notify_one();
+    _thread.join();
+  }
+
+private:
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  bool _done{false};
+  std::thread _thread;
+};
+
+} // namespace easy::utils
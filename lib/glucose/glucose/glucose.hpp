@@ -2916,6 +2916,11 @@ public:
     virtual void parallelExportClauseDuringSearch(Clause &c);
     virtual bool parallelJobIsFinished();
     virtual bool panicModeIsEnabled();
+
+    // Functions useful for theory propagation (e.g. XOR constraints)
+    // Useless in the plain CDCL case
+    virtual CRef extensionPropagate(); // Called at a unit propagation fixpoint; may enqueue literals (with reasons) or return a conflict
+    virtual void extensionCancelUntil(int level); // Called before backtracking to 'level'
     
     
     double luby(double y, int x);
@@ -3964,6 +3969,7 @@ inline void Solver::minimisationWithBinaryResolution(vec <Lit> &out_learnt) {
 
 inline void Solver::cancelUntil(int level) {
     if(decisionLevel() > level) {
+        extensionCancelUntil(level);
         for(int c = trail.size() - 1; c >= trail_lim[level]; c--) {
             Var x = var(trail[c]);
             assigns[x] = l_Undef;
@@ -4786,6 +4792,12 @@ inline lbool Solver::search(int nof_conflicts) {
 
         }
         CRef confl = propagate();
+        while(confl == CRef_Undef) {
+            int const trail_size = trail.size();
+            confl = extensionPropagate();
+            if(confl != CRef_Undef || trail.size() == trail_size) break;
+            confl = propagate();
+        }
 
         if(confl != CRef_Undef) {
             newDescent = false;
@@ -4895,7 +4907,8 @@ inline lbool Solver::search(int nof_conflicts) {
         } else {
             // Our dynamic restart, see the SAT09 competition compagnion paper
             if((luby_restart && nof_conflicts <= conflictC) ||
-               (!luby_restart && (lbdQueue.isvalid() && ((lbdQueue.getavg() * K) > (sumLBD / conflictsRestarts))))) {
+               (!luby_restart && (lbdQueue.isvalid() && ((lbdQueue.getavg() * K) > (sumLBD / conflictsRestarts)))) ||
+               !withinBudget()) {
                 lbdQueue.fastclear();
                 progress_estimate = progressEstimate();
                 int bt = 0;
@@ -5321,4 +5334,13 @@ inline bool Solver::parallelJobIsFinished() {
 
 inline void Solver::parallelImportClauseDuringConflictAnalysis(Clause &c, CRef confl) {
 }
+
+
+inline CRef Solver::extensionPropagate() {
+    return CRef_Undef;
+}
+
+
+inline void Solver::extensionCancelUntil(int level) {
+}
 } // using namespace Glucose
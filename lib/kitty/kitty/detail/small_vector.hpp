@@ -0,0 +1,231 @@
+/* kitty: C++ truth table library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file small_vector.hpp
+  \brief Vector with inline storage for a small number of elements
+
+  \author Mathias Soeken
+*/
+
+/*! \cond PRIVATE */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace kitty
+{
+
+namespace detail
+{
+
+/* A vector of trivially copyable elements that keeps up to `N` elements in
+   inline storage and only allocates on the heap if more elements are
+   requested.  It implements the subset of the `std::vector` interface that is
+   used by the truth table implementations. */
+template<typename T, std::size_t N>
+class small_vector
+{
+  static_assert( std::is_trivially_copyable_v<T>, "small_vector requires trivially copyable elements" );
+  static_assert( N > 0u, "small_vector requires inline storage" );
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using reference = T&;
+  using const_reference = T const&;
+  using iterator = T*;
+  using const_iterator = T const*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static constexpr size_type inline_capacity = N;
+
+  small_vector() noexcept = default;
+
+  explicit small_vector( size_type count, T const& value = T() )
+  {
+    resize( count, value );
+  }
+
+  small_vector( small_vector const& other )
+  {
+    assign( other.begin(), other.end() );
+  }
+
+  small_vector( small_vector&& other ) noexcept
+  {
+    steal( other );
+  }
+
+  ~small_vector()
+  {
+    release();
+  }
+
+  small_vector& operator=( small_vector const& other )
+  {
+    if ( this != &other )
+    {
+      assign( other.begin(), other.end() );
+    }
+    return *this;
+  }
+
+  small_vector& operator=( small_vector&& other ) noexcept
+  {
+    if ( this != &other )
+    {
+      release();
+      steal( other );
+    }
+    return *this;
+  }
+
+  template<typename InputIt>
+  void assign( InputIt first, InputIt last )
+  {
+    const auto count = static_cast<size_type>( std::distance( first, last ) );
+    reserve_discard( count );
+    std::copy( first, last, _data );
+    _size = static_cast<uint32_t>( count );
+  }
+
+  void resize( size_type count, T const& value = T() )
+  {
+    if ( count > _capacity )
+    {
+      auto* data = new T[count];
+      std::copy( _data, _data + _size, data );
+      release();
+      _data = data;
+      _capacity = static_cast<uint32_t>( count );
+    }
+    if ( count > _size )
+    {
+      std::fill( _data + _size, _data + count, value );
+    }
+    _size = static_cast<uint32_t>( count );
+  }
+
+  inline size_type size() const noexcept { return _size; }
+  inline size_type capacity() const noexcept { return _capacity; }
+  inline bool empty() const noexcept { return _size == 0u; }
+  inline bool is_inline() const noexcept { return _data == _inline; }
+
+  inline T* data() noexcept { return _data; }
+  inline T const* data() const noexcept { return _data; }
+
+  inline reference operator[]( size_type pos ) noexcept { return _data[pos]; }
+  inline const_reference operator[]( size_type pos ) const noexcept { return _data[pos]; }
+
+  inline reference front() noexcept { return _data[0u]; }
+  inline const_reference front() const noexcept { return _data[0u]; }
+  inline reference back() noexcept { return _data[_size - 1u]; }
+  inline const_reference back() const noexcept { return _data[_size - 1u]; }
+
+  inline iterator begin() noexcept { return _data; }
+  inline iterator end() noexcept { return _data + _size; }
+  inline const_iterator begin() const noexcept { return _data; }
+  inline const_iterator end() const noexcept { return _data + _size; }
+  inline const_iterator cbegin() const noexcept { return _data; }
+  inline const_iterator cend() const noexcept { return _data + _size; }
+
+  inline reverse_iterator rbegin() noexcept { return reverse_iterator( end() ); }
+  inline reverse_iterator rend() noexcept { return reverse_iterator( begin() ); }
+  inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator( end() ); }
+  inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator( begin() ); }
+  inline const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator( cend() ); }
+  inline const_reverse_iterator crend() const noexcept { return const_reverse_iterator( cbegin() ); }
+
+  friend inline bool operator==( small_vector const& first, small_vector const& second )
+  {
+    return first._size == second._size && std::equal( first.begin(), first.end(), second.begin() );
+  }
+
+  friend inline bool operator!=( small_vector const& first, small_vector const& second )
+  {
+    return !( first == second );
+  }
+
+  friend inline bool operator<( small_vector const& first, small_vector const& second )
+  {
+    return std::lexicographical_compare( first.begin(), first.end(), second.begin(), second.end() );
+  }
+
+private:
+  /* makes room for `count` elements without preserving the current contents */
+  void reserve_discard( size_type count )
+  {
+    if ( count > _capacity )
+    {
+      release();
+      _data = new T[count];
+      _capacity = static_cast<uint32_t>( count );
+    }
+  }
+
+  void release() noexcept
+  {
+    if ( _data != _inline )
+    {
+      delete[] _data;
+      _data = _inline;
+      _capacity = static_cast<uint32_t>( N );
+    }
+  }
+
+  /* expects `this` to use inline storage */
+  void steal( small_vector& other ) noexcept
+  {
+    if ( other.is_inline() )
+    {
+      std::copy( other._inline, other._inline + other._size, _inline );
+    }
+    else
+    {
+      _data = other._data;
+      _capacity = other._capacity;
+      other._data = other._inline;
+      other._capacity = static_cast<uint32_t>( N );
+    }
+    _size = other._size;
+    other._size = 0u;
+  }
+
+private:
+  T* _data{_inline};
+  uint32_t _size{0u};
+  uint32_t _capacity{static_cast<uint32_t>( N )};
+  T _inline[N];
+};
+
+} /* namespace detail */
+} /* namespace kitty */
+/*! \endcond */
@@ -34,11 +34,20 @@
 
 #include <cstdint>
 #include <type_traits>
-#include <vector>
 
 #include "detail/constants.hpp"
+#include "detail/small_vector.hpp"
 #include "traits.hpp"
 
+/*! \brief Number of blocks that are stored inline in a dynamic truth table.
+
+  Truth tables with at most this many blocks do not allocate heap memory.  The
+  default of 4 blocks covers all functions with up to 8 variables.
+*/
+#ifndef KITTY_DYNAMIC_TRUTH_TABLE_INLINE_BLOCKS
+#define KITTY_DYNAMIC_TRUTH_TABLE_INLINE_BLOCKS 4
+#endif
+
 namespace kitty
 {
 
@@ -46,6 +55,9 @@ namespace kitty
 */
 struct dynamic_truth_table
 {
+  /*! Number of blocks that are stored without heap allocation. */
+  static constexpr std::size_t inline_blocks = KITTY_DYNAMIC_TRUTH_TABLE_INLINE_BLOCKS;
+
   /*! Standard constructor.
 
     The number of variables provided to the truth table can be
@@ -53,7 +65,9 @@ struct dynamic_truth_table
     its number of variables cannot change anymore.
 
     The constructor computes the number of blocks and resizes the
-    vector accordingly.
+    vector accordingly.  Up to `inline_blocks` blocks are stored
+    inside the truth table; larger truth tables allocate their blocks
+    on the heap.
 
     \param num_vars Number of variables
   */
@@ -168,7 +182,7 @@ struct dynamic_truth_table
 
   /*! \cond PRIVATE */
 public: /* fields */
-  std::vector<uint64_t> _bits;
+  detail::small_vector<uint64_t, inline_blocks> _bits;
   int _num_vars;
   /*! \endcond */
 };
@@ -53,7 +53,7 @@ TT isop_rec( const TT& tt, const TT& dc, uint8_t var_index, std::vector<cube>& c
     return tt;
   }
 
-  if ( is_const0( ~dc ) )
+  if ( is_const1( dc ) )
   {
     cubes.emplace_back(); /* add empty cube */
     return dc;
@@ -32,10 +32,18 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <numeric>
+#include <tuple>
+#include <vector>
 
+#include "bit_operations.hpp"
 #include "detail/constants.hpp"
+#include "operations.hpp"
 #include "operators.hpp"
+#include "static_truth_table.hpp"
 
 namespace kitty
 {
@@ -433,4 +441,345 @@ TT create_from_npn_config( const std::tuple<TT, uint32_t, std::vector<uint8_t>>&
   return res;
 }
 
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* NPN configuration of a function with up to 4 variables, the permutation is
+   packed with 2 bits per variable */
+struct npn_lookup_entry
+{
+  uint16_t repr;
+  uint8_t phase;
+  uint8_t perm;
+};
+
+/* Maps every function over NumVars variables to its exact NPN representative
+   together with one transformation that leads to it.  The table is computed
+   once from exact_npn_canonization by enumerating all transformations of each
+   class representative. */
+template<int NumVars>
+std::vector<npn_lookup_entry> build_npn_lookup_table()
+{
+  static_assert( NumVars >= 2 && NumVars <= 4, "lookup tables are only available for 2 to 4 variables" );
+
+  std::vector<npn_lookup_entry> table( 1u << ( 1u << NumVars ) );
+  std::vector<bool> visited( table.size(), false );
+
+  for ( auto index = 0u; index < table.size(); ++index )
+  {
+    if ( visited[index] )
+    {
+      continue;
+    }
+
+    static_truth_table<NumVars> tt;
+    *tt.begin() = index;
+    const auto repr = std::get<0>( exact_npn_canonization( tt ) );
+
+    for ( auto phase = 0u; phase < ( 1u << ( NumVars + 1 ) ); ++phase )
+    {
+      std::array<uint8_t, NumVars> perm;
+      std::iota( perm.begin(), perm.end(), 0u );
+
+      do
+      {
+        /* same as create_from_npn_config, without allocating the permutation */
+        auto func = ( ( phase >> NumVars ) & 1 ) ? ~repr : repr;
+        auto p = perm;
+        for ( auto i = 0; i < NumVars; ++i )
+        {
+          for ( auto k = i + 1; k < NumVars && p[i] != i; ++k )
+          {
+            if ( p[k] == i )
+            {
+              swap_inplace( func, i, k );
+              std::swap( p[i], p[k] );
+            }
+          }
+        }
+        for ( auto i = 0; i < NumVars; ++i )
+        {
+          if ( ( phase >> i ) & 1 )
+          {
+            flip_inplace( func, i );
+          }
+        }
+
+        const auto word = static_cast<uint32_t>( *func.cbegin() );
+        if ( visited[word] )
+        {
+          continue;
+        }
+        visited[word] = true;
+
+        uint8_t packed_perm{0u};
+        for ( auto i = 0; i < NumVars; ++i )
+        {
+          packed_perm |= perm[i] << ( 2 * i );
+        }
+        table[word] = {static_cast<uint16_t>( *repr.cbegin() ), static_cast<uint8_t>( phase ), packed_perm};
+      } while ( std::next_permutation( perm.begin(), perm.end() ) );
+    }
+  }
+
+  return table;
+}
+
+template<int NumVars>
+std::vector<npn_lookup_entry> const& npn_lookup_table()
+{
+  /* initialization of function-local statics is thread-safe */
+  static const auto table = build_npn_lookup_table<NumVars>();
+  return table;
+}
+
+/* applies an NPN configuration in the reverse direction of
+   create_from_npn_config, i.e., computes the representative from the original
+   function; expects all transformations to be stored in `phase` and `perm` */
+template<typename TT>
+void apply_npn_transformation_inplace( TT& tt, uint32_t phase, std::vector<uint8_t> const& perm )
+{
+  const auto num_vars = tt.num_vars();
+
+  if ( ( phase >> num_vars ) & 1 )
+  {
+    tt = ~tt;
+  }
+  for ( auto i = 0; i < num_vars; ++i )
+  {
+    if ( ( phase >> i ) & 1 )
+    {
+      flip_inplace( tt, i );
+    }
+  }
+
+  /* move original variable perm[k] to position k */
+  std::array<uint8_t, 6> position, variable;
+  std::iota( position.begin(), position.end(), 0u );
+  std::iota( variable.begin(), variable.end(), 0u );
+  for ( auto k = 0; k < num_vars; ++k )
+  {
+    const auto pos = position[perm[k]];
+    if ( pos == k )
+    {
+      continue;
+    }
+    swap_inplace( tt, k, pos );
+    std::swap( variable[k], variable[pos] );
+    position[variable[k]] = k;
+    position[variable[pos]] = pos;
+  }
+}
+
+inline uint32_t count_ones_in_word( uint64_t word )
+{
+  return __builtin_popcount( word & 0xffffffff ) + __builtin_popcount( word >> 32 );
+}
+
+} /* namespace detail */
+/*! \endcond */
+
+/*! \brief Exact NPN canonization based on a pre-computed lookup table
+
+  Returns the same NPN representative as `exact_npn_canonization` for
+  functions with up to 4 variables, but looks it up in a table that maps each
+  function to its NPN configuration.  The tables for 2, 3, and 4 variables
+  are computed on first use and shared by all callers.  The table for 4
+  variables has \f$2^{16}\f$ entries.
+
+  The returned input negations and permutation lead to the representative,
+  but need not be the same as the ones returned by `exact_npn_canonization`
+  if there are several such transformations.
+
+  \param tt The truth table (with at most 4 variables)
+  \return NPN configuration
+*/
+template<typename TT>
+std::tuple<TT, uint32_t, std::vector<uint8_t>> exact_npn_canonization_lookup( const TT& tt )
+{
+  const auto num_vars = tt.num_vars();
+  assert( num_vars <= 4 );
+
+  if ( num_vars < 2 )
+  {
+    return exact_npn_canonization( tt );
+  }
+
+  const auto index = *tt.cbegin();
+  const auto& entry = num_vars == 2 ? detail::npn_lookup_table<2>()[index] : ( num_vars == 3 ? detail::npn_lookup_table<3>()[index] : detail::npn_lookup_table<4>()[index] );
+
+  auto repr = tt.construct();
+  *repr.begin() = entry.repr;
+
+  std::vector<uint8_t> perm( num_vars );
+  for ( auto i = 0; i < num_vars; ++i )
+  {
+    perm[i] = ( entry.perm >> ( 2 * i ) ) & 3;
+  }
+
+  return std::make_tuple( repr, uint32_t( entry.phase ), perm );
+}
+
+/*! \brief Exact NPN canonization with signature-based pruning
+
+  This algorithm computes an exact NPN representative for functions with up to
+  6 variables, but does not enumerate all \f$2^{n+1}n!\f$ transformations.
+  Instead, it only considers functions in the NPN class that satisfy the
+  following signature constraints:
+
+  - the function has at most \f$2^{n-1}\f$ ones
+  - for each variable, the positive cofactor has at most as many ones as the
+    negative cofactor
+  - the number of ones in the positive cofactors is non-increasing with the
+    variable index
+
+  The ones counts are computed word-parallel using population count on the
+  projection masks.  Transformations are enumerated only where these
+  constraints leave a choice, i.e., for output and input polarities that
+  lead to balanced counts and for permutations of variables with equal
+  counts, unless the function is totally symmetric in these variables.  The
+  representative is the smallest of these functions.
+
+  Since the set of functions that satisfy the constraints is the same for all
+  functions in an NPN class, the result is canonical.  However, the
+  representative can differ from the one computed by
+  `exact_npn_canonization`, and both should not be mixed.
+
+  The function returns a NPN configuration in the same format as
+  `exact_npn_canonization`.
+
+  \param tt The truth table (with at most 6 variables)
+  \return NPN configuration
+*/
+template<typename TT>
+std::tuple<TT, uint32_t, std::vector<uint8_t>> exact_npn_canonization_signature( const TT& tt )
+{
+  const auto num_vars = tt.num_vars();
+  assert( num_vars <= 6 );
+
+  if ( num_vars < 2 )
+  {
+    return exact_npn_canonization( tt );
+  }
+
+  auto best = tt;
+  uint32_t best_phase{0u};
+  std::vector<uint8_t> best_perm( num_vars );
+  bool found{false};
+
+  const auto ones = detail::count_ones_in_word( *tt.cbegin() );
+  const auto half = 1u << ( num_vars - 1 );
+
+  std::vector<uint8_t> order( num_vars ), identity( num_vars ), ties;
+  std::vector<std::pair<uint8_t, uint8_t>> groups, active_groups;
+  std::iota( identity.begin(), identity.end(), 0u );
+  std::array<uint32_t, 6> weights;
+
+  for ( auto out = 0u; out < 2u; ++out )
+  {
+    /* output polarity must lead to at most half of the bits set */
+    if ( ( out == 0u && ones > half ) || ( out == 1u && ones < half ) )
+    {
+      continue;
+    }
+
+    const auto word = out ? ( ~*tt.cbegin() & detail::masks[num_vars] ) : *tt.cbegin();
+    const auto count = out ? ( ( 1u << num_vars ) - ones ) : ones;
+
+    /* input polarities from the positive cofactor weights */
+    uint32_t phase = out << num_vars;
+    ties.clear();
+    for ( auto i = 0; i < num_vars; ++i )
+    {
+      const auto positive = detail::count_ones_in_word( word & detail::projections[i] );
+      const auto negative = count - positive;
+      if ( positive > negative )
+      {
+        phase |= 1 << i;
+      }
+      else if ( positive == negative )
+      {
+        ties.push_back( i );
+      }
+      weights[i] = std::min( positive, negative );
+    }
+
+    /* sort variables by non-increasing weight, enumerate groups of equal weight */
+    std::iota( order.begin(), order.end(), 0u );
+    std::stable_sort( order.begin(), order.end(), [&]( auto a, auto b ) { return weights[a] > weights[b]; } );
+    groups.clear();
+    for ( auto i = 0; i < num_vars; )
+    {
+      auto j = i + 1;
+      while ( j < num_vars && weights[order[j]] == weights[order[i]] )
+      {
+        ++j;
+      }
+      if ( j - i > 1 )
+      {
+        groups.emplace_back( i, j );
+      }
+      i = j;
+    }
+
+    for ( auto tie_mask = 0u; tie_mask < ( 1u << ties.size() ); ++tie_mask )
+    {
+      auto tie_phase = phase;
+      for ( auto t = 0u; t < ties.size(); ++t )
+      {
+        if ( ( tie_mask >> t ) & 1 )
+        {
+          tie_phase |= 1 << ties[t];
+        }
+      }
+
+      /* permuting variables in which the function is totally symmetric does not change it */
+      auto phased = tt;
+      detail::apply_npn_transformation_inplace( phased, tie_phase, identity );
+      active_groups.clear();
+      for ( auto const& group : groups )
+      {
+        for ( auto i = group.first; i + 1 < group.second; ++i )
+        {
+          if ( phased != swap( phased, order[i], order[i + 1] ) )
+          {
+            active_groups.push_back( group );
+            break;
+          }
+        }
+      }
+
+      /* odometer over the permutations of all groups */
+      while ( true )
+      {
+        auto candidate = tt;
+        detail::apply_npn_transformation_inplace( candidate, tie_phase, order );
+        if ( !found || candidate < best )
+        {
+          best = candidate;
+          best_phase = tie_phase;
+          best_perm = order;
+          found = true;
+        }
+
+        auto g = 0u;
+        for ( ; g < active_groups.size(); ++g )
+        {
+          if ( std::next_permutation( order.begin() + active_groups[g].first, order.begin() + active_groups[g].second ) )
+          {
+            break;
+          }
+        }
+        if ( g == active_groups.size() )
+        {
+          break;
+        }
+      }
+    }
+  }
+
+  return std::make_tuple( best, best_phase, best_perm );
+}
+
 } /* namespace kitty */
@@ -176,6 +176,32 @@ inline bool is_const0( const static_truth_table<NumVars, true>& tt )
 }
 /*! \endcond */
 
+/*! \brief Checks whether truth table is contant 1
+
+  Other than `is_const0( ~tt )`, this function does not construct the
+  complement of the truth table.
+
+  \param tt Truth table
+*/
+template<typename TT>
+inline bool is_const1( const TT& tt )
+{
+  if ( tt.num_vars() < 6 )
+  {
+    return tt._bits[0] == detail::masks[tt.num_vars()];
+  }
+
+  return std::all_of( std::begin( tt._bits ), std::end( tt._bits ), []( uint64_t word ) { return word == UINT64_C( 0xffffffffffffffff ); } );
+}
+
+/*! \cond PRIVATE */
+template<int NumVars>
+inline bool is_const1( const static_truth_table<NumVars, true>& tt )
+{
+  return tt._bits == detail::masks[NumVars];
+}
+/*! \endcond */
+
 /*! \brief Checks whether truth table depends on given variable index
 
   \param tt Truth table
@@ -369,6 +395,139 @@ TT cofactor1( const TT& tt, uint8_t var_index )
   return copy;
 }
 
+/*! \brief Computes co-factor with respect to 0 into an existing truth table
+
+  Same as `cofactor0`, but the result is written into `result`, which
+  must have the same number of variables as `tt`.  This allows to reuse
+  scratch truth tables in recursive algorithms.
+
+  \param tt Truth table
+  \param var_index Variable index
+  \param result Truth table to store the co-factor
+*/
+template<typename TT>
+void cofactor0_into( const TT& tt, uint8_t var_index, TT& result )
+{
+  assert( tt.num_vars() == result.num_vars() );
+
+  if ( tt.num_vars() <= 6 || var_index < 6 )
+  {
+    std::transform( std::begin( tt._bits ), std::end( tt._bits ),
+                    std::begin( result._bits ),
+                    [var_index]( uint64_t word ) { return ( ( word & detail::projections_neg[var_index] ) << ( 1 << var_index ) ) |
+                                                          ( word & detail::projections_neg[var_index] ); } );
+  }
+  else
+  {
+    const auto step = 1 << ( var_index - 6 );
+    for ( auto i = 0u; i < tt.num_blocks(); i += 2 * step )
+    {
+      for ( auto j = 0; j < step; ++j )
+      {
+        result._bits[i + j] = result._bits[i + j + step] = tt._bits[i + j];
+      }
+    }
+  }
+}
+
+/*! \cond PRIVATE */
+template<int NumVars>
+void cofactor0_into( const static_truth_table<NumVars, true>& tt, uint8_t var_index, static_truth_table<NumVars, true>& result )
+{
+  result._bits = ( ( tt._bits & detail::projections_neg[var_index] ) << ( 1 << var_index ) ) |
+                 ( tt._bits & detail::projections_neg[var_index] );
+}
+/*! \endcond */
+
+/*! \brief Computes co-factor with respect to 1 into an existing truth table
+
+  Same as `cofactor1`, but the result is written into `result`, which
+  must have the same number of variables as `tt`.
+
+  \param tt Truth table
+  \param var_index Variable index
+  \param result Truth table to store the co-factor
+*/
+template<typename TT>
+void cofactor1_into( const TT& tt, uint8_t var_index, TT& result )
+{
+  assert( tt.num_vars() == result.num_vars() );
+
+  if ( tt.num_vars() <= 6 || var_index < 6 )
+  {
+    std::transform( std::begin( tt._bits ), std::end( tt._bits ),
+                    std::begin( result._bits ),
+                    [var_index]( uint64_t word ) { return ( word & detail::projections[var_index] ) |
+                                                          ( ( word & detail::projections[var_index] ) >> ( 1 << var_index ) ); } );
+  }
+  else
+  {
+    const auto step = 1 << ( var_index - 6 );
+    for ( auto i = 0u; i < tt.num_blocks(); i += 2 * step )
+    {
+      for ( auto j = 0; j < step; ++j )
+      {
+        result._bits[i + j] = result._bits[i + j + step] = tt._bits[i + j + step];
+      }
+    }
+  }
+}
+
+/*! \cond PRIVATE */
+template<int NumVars>
+void cofactor1_into( const static_truth_table<NumVars, true>& tt, uint8_t var_index, static_truth_table<NumVars, true>& result )
+{
+  result._bits = ( tt._bits & detail::projections[var_index] ) | ( ( tt._bits & detail::projections[var_index] ) >> ( 1 << var_index ) );
+}
+/*! \endcond */
+
+/*! \brief Computes XOR of both co-factors into an existing truth table
+
+  Computes `cofactor0( tt, var_index ) ^ cofactor1( tt, var_index )`,
+  i.e., the Boolean difference of `tt` with respect to `var_index`,
+  without constructing the co-factors.  The result is written into
+  `result`, which must have the same number of variables as `tt`.
+
+  \param tt Truth table
+  \param var_index Variable index
+  \param result Truth table to store the Boolean difference
+*/
+template<typename TT>
+void cofactor_xor_into( const TT& tt, uint8_t var_index, TT& result )
+{
+  assert( tt.num_vars() == result.num_vars() );
+
+  if ( tt.num_vars() <= 6 || var_index < 6 )
+  {
+    std::transform( std::begin( tt._bits ), std::end( tt._bits ),
+                    std::begin( result._bits ),
+                    [var_index]( uint64_t word ) {
+                      const auto diff = ( word ^ ( word >> ( 1 << var_index ) ) ) & detail::projections_neg[var_index];
+                      return diff | ( diff << ( 1 << var_index ) );
+                    } );
+  }
+  else
+  {
+    const auto step = 1 << ( var_index - 6 );
+    for ( auto i = 0u; i < tt.num_blocks(); i += 2 * step )
+    {
+      for ( auto j = 0; j < step; ++j )
+      {
+        result._bits[i + j] = result._bits[i + j + step] = tt._bits[i + j] ^ tt._bits[i + j + step];
+      }
+    }
+  }
+}
+
+/*! \cond PRIVATE */
+template<int NumVars>
+void cofactor_xor_into( const static_truth_table<NumVars, true>& tt, uint8_t var_index, static_truth_table<NumVars, true>& result )
+{
+  const auto diff = ( tt._bits ^ ( tt._bits >> ( 1 << var_index ) ) ) & detail::projections_neg[var_index];
+  result._bits = diff | ( diff << ( 1 << var_index ) );
+}
+/*! \endcond */
+
 /*! \brief Swaps two adjacent variables in a truth table
 
   The function swaps variable `var_index` with `var_index + 1`.  The
@@ -32,7 +32,8 @@
 
 #pragma once
 
-#include <mockturtle/algorithms/resubstitution.hpp>
+#include "../networks/aig.hpp"
+#include "resubstitution.hpp"
 
 namespace mockturtle
 {
@@ -32,9 +32,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include <kitty/constructors.hpp>
@@ -67,6 +72,13 @@ struct cut_enumeration_params
   /*! \brief Prune cuts by removing don't cares. */
   bool minimize_truth_table{false};
 
+  /*! \brief Number of threads.
+   *
+   * If larger than 1, nodes of the same logic level are processed
+   * concurrently (at most 255 threads are used).
+   */
+  uint32_t num_threads{1u};
+
   /*! \brief Be verbose. */
   bool verbose{false};
 
@@ -179,7 +191,7 @@ public:
   template<bool enabled = ComputeTruth, typename = std::enable_if_t<std::is_same_v<Ntk, Ntk> && enabled>>
   auto truth_table( cut_t const& cut ) const
   {
-    return _truth_tables[cut->func_id];
+    return lookup_truth_table( cut->func_id );
   }
 
   /*! \brief Returns the total number of tuples that were tried to be merged */
@@ -242,6 +254,43 @@ private:
   friend network_cuts<_Ntk, _ComputeTruth, _CutData> cut_enumeration( _Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst );
 
 private:
+  /* During parallel cut enumeration, each thread inserts truth tables into
+   * its own shard, and the shard (starting from 1) is stored in the upper bits
+   * of the function id.  Shards are merged into the truth table cache after
+   * each level, such that function ids of completed cuts refer to the cache. */
+  static constexpr uint32_t shard_shift = 24u;
+  static constexpr uint32_t shard_mask = ( 1u << shard_shift ) - 1u;
+
+  kitty::dynamic_truth_table lookup_truth_table( uint32_t func_id ) const
+  {
+    if ( const auto shard = func_id >> shard_shift; shard != 0u )
+    {
+      return _shards[shard - 1u][func_id & shard_mask];
+    }
+    return _truth_tables[func_id];
+  }
+
+  uint32_t insert_truth_table( uint32_t shard, kitty::dynamic_truth_table const& tt )
+  {
+    if ( shard == 0u )
+    {
+      return _truth_tables.insert( tt );
+    }
+    return ( shard << shard_shift ) | _shards[shard - 1u].insert( tt );
+  }
+
+  /* moves truth tables of a node's cuts from the shards into the cache */
+  void commit_truth_tables( uint32_t index )
+  {
+    for ( auto* cut : _cuts[index] )
+    {
+      if ( ( *cut )->func_id >> shard_shift )
+      {
+        ( *cut )->func_id = _truth_tables.insert( lookup_truth_table( ( *cut )->func_id ) );
+      }
+    }
+  }
+
   void add_zero_cut( uint32_t index )
   {
     auto& cut = _cuts[index].add_cut( &index, &index ); /* fake iterator for emptyness */
@@ -269,6 +318,9 @@ private:
   /* cut truth tables */
   truth_table_cache<kitty::dynamic_truth_table> _truth_tables;
 
+  /* per-thread truth tables of the current level in parallel enumeration */
+  std::vector<truth_table_cache<kitty::dynamic_truth_table>> _shards;
+
   /* statistics */
   uint32_t _total_tuples{};
   std::size_t _total_cuts{};
@@ -285,6 +337,17 @@ public:
   using cut_t = typename network_cuts<Ntk, ComputeTruth, CutData>::cut_t;
   using cut_set_t = typename network_cuts<Ntk, ComputeTruth, CutData>::cut_set_t;
 
+  /* state that is private to a thread */
+  struct worker_state
+  {
+    uint32_t shard{0u};
+    uint32_t total_tuples{0u};
+    std::size_t total_cuts{0u};
+    stopwatch<>::duration time_truth_table{0};
+
+    std::array<cut_set_t*, Ntk::max_fanin_size + 1> lcuts;
+  };
+
   explicit cut_enumeration_impl( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats& st, network_cuts<Ntk, ComputeTruth, CutData>& cuts )
       : ntk( ntk ),
         ps( ps ),
@@ -295,43 +358,198 @@ public:
 
 public:
   void run()
+  {
+    if ( ps.num_threads > 1u )
+    {
+      run_parallel();
+      return;
+    }
+
+    stopwatch t( st.time_total );
+
+    worker_state worker;
+    ntk.foreach_node( [&]( auto node ) {
+      compute_node( node, worker );
+    } );
+    collect_stats( worker );
+  }
+
+private:
+  void run_parallel()
   {
     stopwatch t( st.time_total );
 
-    ntk.foreach_node( [this]( auto node ) {
+    /* group nodes by level, each level is enumerated in parallel */
+    std::vector<std::vector<node<Ntk>>> levels;
+    std::vector<uint32_t> node_level( ntk.size(), 0u );
+    ntk.foreach_node( [&]( auto node ) {
       const auto index = ntk.node_to_index( node );
+      uint32_t level{0u};
+      if ( !ntk.is_constant( node ) && !ntk.is_pi( node ) )
+      {
+        ntk.foreach_fanin( node, [&]( auto const& f ) {
+          level = std::max( level, node_level[ntk.node_to_index( ntk.get_node( f ) )] + 1u );
+        } );
+      }
+      node_level[index] = level;
 
-      if ( ps.very_verbose )
+      if ( level >= levels.size() )
       {
-        std::cout << fmt::format( "[i] compute cut for node {} (index = {})\n", node, index );
+        levels.resize( level + 1u );
       }
+      levels[level].push_back( node );
+    } );
 
-      if ( ntk.is_constant( node ) )
+    const auto num_threads = std::min( ps.num_threads, 255u );
+    std::vector<worker_state> workers( num_threads );
+    for ( auto i = 0u; i < num_threads; ++i )
+    {
+      workers[i].shard = i + 1u;
+    }
+    cuts._shards.resize( num_threads );
+
+    std::mutex mutex;
+    std::condition_variable cv_start, cv_done;
+    std::vector<node<Ntk>> const* current{nullptr};
+    std::atomic<std::size_t> next{0u};
+    uint64_t generation{0u};
+    uint32_t busy{0u};
+    bool stop{false};
+
+    const auto process = [&]( worker_state& worker ) {
+      auto const& level = *current;
+      for ( auto i = next.fetch_add( 1u ); i < level.size(); i = next.fetch_add( 1u ) )
       {
-        cuts.add_zero_cut( index );
+        compute_node( level[i], worker );
       }
-      else if ( ntk.is_pi( node ) )
+    };
+
+    std::vector<std::thread> threads;
+    for ( auto i = 1u; i < num_threads; ++i )
+    {
+      threads.emplace_back( [&, i]() {
+        uint64_t seen{0u};
+        while ( true )
+        {
+          {
+            std::unique_lock<std::mutex> lock( mutex );
+            cv_start.wait( lock, [&]() { return stop || generation != seen; } );
+            if ( stop )
+            {
+              return;
+            }
+            seen = generation;
+          }
+
+          process( workers[i] );
+
+          std::lock_guard<std::mutex> lock( mutex );
+          if ( --busy == 0u )
+          {
+            cv_done.notify_one();
+          }
+        }
+      } );
+    }
+
+    for ( auto const& level : levels )
+    {
+      current = &level;
+      next = 0u;
+
+      if ( level.size() < 2u * num_threads )
       {
-        cuts.add_unit_cut( index );
+        process( workers[0u] );
       }
       else
       {
-        if constexpr ( Ntk::min_fanin_size == 2 && Ntk::max_fanin_size == 2 )
         {
-          merge_cuts2( index );
+          std::lock_guard<std::mutex> lock( mutex );
+          busy = num_threads - 1u;
+          ++generation;
         }
-        else
+        cv_start.notify_all();
+
+        process( workers[0u] );
+
+        std::unique_lock<std::mutex> lock( mutex );
+        cv_done.wait( lock, [&]() { return busy == 0u; } );
+      }
+
+      /* batch insertion of the level's truth tables into the cache */
+      if constexpr ( ComputeTruth )
+      {
+        for ( auto const& node : level )
+        {
+          cuts.commit_truth_tables( ntk.node_to_index( node ) );
+        }
+        for ( auto& shard : cuts._shards )
         {
-          merge_cuts( index );
+          if ( shard.size() != 0u )
+          {
+            shard = truth_table_cache<kitty::dynamic_truth_table>();
+          }
         }
       }
-    } );
+    }
+
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      stop = true;
+    }
+    cv_start.notify_all();
+    for ( auto& thread : threads )
+    {
+      thread.join();
+    }
+
+    cuts._shards.clear();
+    for ( auto const& worker : workers )
+    {
+      collect_stats( worker );
+    }
   }
 
-private:
-  uint32_t compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res )
+  void compute_node( node<Ntk> const& node, worker_state& worker )
   {
-    stopwatch t( st.time_truth_table );
+    const auto index = ntk.node_to_index( node );
+
+    if ( ps.very_verbose )
+    {
+      std::cout << fmt::format( "[i] compute cut for node {} (index = {})\n", node, index );
+    }
+
+    if ( ntk.is_constant( node ) )
+    {
+      cuts.add_zero_cut( index );
+    }
+    else if ( ntk.is_pi( node ) )
+    {
+      cuts.add_unit_cut( index );
+    }
+    else
+    {
+      if constexpr ( Ntk::min_fanin_size == 2 && Ntk::max_fanin_size == 2 )
+      {
+        merge_cuts2( index, worker );
+      }
+      else
+      {
+        merge_cuts( index, worker );
+      }
+    }
+  }
+
+  void collect_stats( worker_state const& worker )
+  {
+    cuts._total_tuples += worker.total_tuples;
+    cuts._total_cuts += worker.total_cuts;
+    st.time_truth_table += worker.time_truth_table;
+  }
+
+  uint32_t compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res, worker_state& worker )
+  {
+    stopwatch t( worker.time_truth_table );
 
     std::vector<kitty::dynamic_truth_table> tt( vcuts.size() );
     auto i = 0;
@@ -343,7 +561,7 @@ private:
       ++i;
     }
 
-    auto tt_res = ntk.compute( index, tt.begin(), tt.end() );
+    auto tt_res = ntk.compute( ntk.index_to_node( index ), tt.begin(), tt.end() );
 
     if ( ps.minimize_truth_table )
     {
@@ -361,19 +579,20 @@ private:
           *it_leaves++ = leaves_before[*it_support++];
         }
         res.set_leaves( leaves_after.begin(), leaves_after.end() );
-        return cuts._truth_tables.insert( tt_res_shrink );
+        return cuts.insert_truth_table( worker.shard, tt_res_shrink );
       }
     }
 
-    return cuts._truth_tables.insert( tt_res );
+    return cuts.insert_truth_table( worker.shard, tt_res );
   }
 
-  void merge_cuts2( uint32_t index )
+  void merge_cuts2( uint32_t index, worker_state& worker )
   {
     const auto fanin = 2;
+    auto& lcuts = worker.lcuts;
 
     uint32_t pairs{1};
-    ntk.foreach_fanin( ntk.index_to_node( index ), [this, &pairs]( auto child, auto i ) {
+    ntk.foreach_fanin( ntk.index_to_node( index ), [this, &lcuts, &pairs]( auto child, auto i ) {
       lcuts[i] = &cuts.cuts( ntk.node_to_index( ntk.get_node( child ) ) );
       pairs *= static_cast<uint32_t>( lcuts[i]->size() );
     } );
@@ -385,7 +604,7 @@ private:
 
     std::vector<cut_t const*> vcuts( fanin );
 
-    cuts._total_tuples += pairs;
+    worker.total_tuples += pairs;
     for ( auto const& c1 : *lcuts[0] )
     {
       for ( auto const& c2 : *lcuts[1] )
@@ -404,10 +623,10 @@ private:
         {
           vcuts[0] = c1;
           vcuts[1] = c2;
-          new_cut->func_id = compute_truth_table( index, vcuts, new_cut );
+          new_cut->func_id = compute_truth_table( index, vcuts, new_cut, worker );
         }
 
-        cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, index );
+        cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, ntk.index_to_node( index ) );
 
         rcuts.insert( new_cut );
       }
@@ -416,7 +635,7 @@ private:
     /* limit the maximum number of cuts */
     rcuts.limit( ps.cut_limit - 1 );
 
-    cuts._total_cuts += rcuts.size();
+    worker.total_cuts += rcuts.size();
 
     if ( rcuts.size() > 1 || ( *rcuts.begin() )->size() > 1 )
     {
@@ -424,11 +643,13 @@ private:
     }
   }
 
-  void merge_cuts( uint32_t index )
+  void merge_cuts( uint32_t index, worker_state& worker )
   {
+    auto& lcuts = worker.lcuts;
+
     uint32_t pairs{1};
     std::vector<uint32_t> cut_sizes;
-    ntk.foreach_fanin( index, [this, &pairs, &cut_sizes]( auto child, auto i ) {
+    ntk.foreach_fanin( ntk.index_to_node( index ), [this, &lcuts, &pairs, &cut_sizes]( auto child, auto i ) {
       lcuts[i] = &cuts.cuts( ntk.node_to_index( ntk.get_node( child ) ) );
       cut_sizes.push_back( lcuts[i]->size() );
       pairs *= cut_sizes.back();
@@ -447,7 +668,7 @@ private:
 
       std::vector<cut_t const*> vcuts( fanin );
 
-      cuts._total_tuples += pairs;
+      worker.total_tuples += pairs;
       foreach_mixed_radix_tuple( cut_sizes.begin(), cut_sizes.end(), [&]( auto begin, auto end ) {
         auto it = vcuts.begin();
         auto i = 0u;
@@ -477,10 +698,10 @@ private:
 
         if constexpr ( ComputeTruth )
         {
-          new_cut->func_id = compute_truth_table( index, vcuts, new_cut );
+          new_cut->func_id = compute_truth_table( index, vcuts, new_cut, worker );
         }
 
-        cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, index );
+        cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, ntk.index_to_node( index ) );
 
         rcuts.insert( new_cut );
 
@@ -491,7 +712,7 @@ private:
       rcuts.limit( ps.cut_limit - 1 );
     }
 
-    cuts._total_cuts += static_cast<uint32_t>( rcuts.size() );
+    worker.total_cuts += static_cast<uint32_t>( rcuts.size() );
 
     if ( rcuts.size() > 1 || ( *rcuts.begin() )->size() > 1 )
     {
@@ -504,8 +725,6 @@ private:
   cut_enumeration_params const& ps;
   cut_enumeration_stats& st;
   network_cuts<Ntk, ComputeTruth, CutData>& cuts;
-
-  std::array<cut_set_t*, Ntk::max_fanin_size + 1> lcuts;
 };
 } /* namespace detail */
 /*! \endcond */
@@ -521,6 +740,12 @@ private:
  * be computed for each cut.  Computing truth tables slows down the execution
  * time of the algorithm.
  *
+ * If `num_threads` is larger than 1, nodes are grouped by their logic level
+ * and the cut sets of all nodes in a level are computed concurrently.  Truth
+ * tables of a level are first collected per thread and inserted into the
+ * shared truth table cache once the level is complete.  The resulting cut sets
+ * are the same as with a single thread.
+ *
  * The number of computed cuts is controlled via the `cut_limit` parameter.
  * To decide which cuts are collected in each node's cut set, cuts are sorted.
  * Unit cuts do not participate in the sorting and are always added to the end
@@ -32,7 +32,8 @@
 
 #pragma once
 
-#include <mockturtle/algorithms/resubstitution.hpp>
+#include "../networks/mig.hpp"
+#include "resubstitution.hpp"
 
 namespace kitty
 {
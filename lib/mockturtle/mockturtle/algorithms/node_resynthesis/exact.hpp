@@ -56,6 +56,13 @@ struct exact_resynthesis_params
 
   cache_t cache;
 
+  /*! \brief Persistent chain store, shared across runs (optional).
+   *
+   * Chains are looked up and stored by NPN class; the store is only used for
+   * functions without don't cares.
+   */
+  std::shared_ptr<percy::chain_store> store;
+
   bool add_alonce_clauses{true};
   bool add_colex_clauses{true};
   bool add_lex_clauses{false};
@@ -112,6 +119,14 @@ struct exact_resynthesis_params
       cut_rewriting( klut, resyn );
       klut = cleanup_dangling( klut );
 
+   Optimum networks can also be kept across runs in a persistent store, which
+   is shared by all functions in the same NPN class:
+
+   .. code-block:: c++
+
+      exact_resynthesis_params ps;
+      ps.store = std::make_shared<percy::chain_store>( "chains.db" );
+
    The underlying engine for this resynthesis function is percy_.
 
    .. _percy: https://github.com/whaaswijk/percy
@@ -172,9 +187,13 @@ public:
       }
 
       percy::chain c;
-      if ( const auto result = percy::synthesize( spec, c, _ps.solver_type,
-                                                  _ps.encoder_type,
-                                                  _ps.synthesis_method );
+      if ( const auto result = !with_dont_cares && _ps.store
+                                   ? percy::synthesize( spec, c, *_ps.store, _ps.solver_type,
+                                                        _ps.encoder_type,
+                                                        _ps.synthesis_method )
+                                   : percy::synthesize( spec, c, _ps.solver_type,
+                                                        _ps.encoder_type,
+                                                        _ps.synthesis_method );
            result != percy::success )
       {
         return std::nullopt;
@@ -306,9 +325,13 @@ public:
       }
 
       percy::chain c;
-      if ( const auto result = percy::synthesize( spec, c, _ps.solver_type,
-                                                  _ps.encoder_type,
-                                                  _ps.synthesis_method );
+      if ( const auto result = !with_dont_cares && _ps.store
+                                   ? percy::synthesize( spec, c, *_ps.store, _ps.solver_type,
+                                                        _ps.encoder_type,
+                                                        _ps.synthesis_method )
+                                   : percy::synthesize( spec, c, _ps.solver_type,
+                                                        _ps.encoder_type,
+                                                        _ps.synthesis_method );
            result != percy::success )
       {
         return std::nullopt;
@@ -35,6 +35,8 @@
 #include <array>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -122,6 +124,115 @@ struct xag_minmc_resynthesis_stats
   }
 };
 
+/*! \brief Cache for spectral classifications of 6-input functions.
+ *
+ * The spectral classification is the most expensive step in
+ * `xag_minmc_resynthesis`.  The cache can be shared among several resynthesis
+ * instances (e.g., across several optimization runs), and it can be saved to
+ * and loaded from a file.  A cache file stores one entry per line as
+ *
+ *     <function> <success> <representative> <#operations> [<kind> <var1> <var2>]*
+ *
+ * where functions are given in hexadecimal notation.  A cache is not
+ * thread-safe.
+ */
+class xag_minmc_classify_cache
+{
+public:
+  /*! \brief Entry with success flag, representative, and transformations. */
+  using entry_type = std::tuple<bool, kitty::static_truth_table<6>, std::vector<kitty::detail::spectral_operation>>;
+
+  /*! \brief Returns the cache entry for a function or `nullptr`. */
+  entry_type const* find( kitty::static_truth_table<6> const& function ) const
+  {
+    const auto it = _entries.find( function );
+    return it == _entries.end() ? nullptr : &it->second;
+  }
+
+  /*! \brief Adds an entry for a function. */
+  void insert( kitty::static_truth_table<6> const& function, entry_type const& entry )
+  {
+    _entries.insert( {function, entry} );
+  }
+
+  /*! \brief Number of cached functions. */
+  std::size_t size() const
+  {
+    return _entries.size();
+  }
+
+  /*! \brief Adds all entries from a stream; returns false on a malformed entry. */
+  bool load( std::istream& in )
+  {
+    std::string line;
+    while ( std::getline( in, line ) )
+    {
+      if ( line.empty() )
+      {
+        continue;
+      }
+
+      std::istringstream entry( line );
+      std::string function_str, repr_str;
+      bool success;
+      uint32_t num_operations;
+      if ( !( entry >> function_str >> success >> repr_str >> num_operations ) || function_str.size() != 16u || repr_str.size() != 16u )
+      {
+        return false;
+      }
+
+      kitty::static_truth_table<6> function, repr;
+      kitty::create_from_hex_string( function, function_str );
+      kitty::create_from_hex_string( repr, repr_str );
+
+      std::vector<kitty::detail::spectral_operation> operations;
+      for ( auto i = 0u; i < num_operations; ++i )
+      {
+        uint32_t kind, var1, var2;
+        if ( !( entry >> kind >> var1 >> var2 ) )
+        {
+          return false;
+        }
+        operations.emplace_back( static_cast<kitty::detail::spectral_operation::kind>( kind ), static_cast<uint16_t>( var1 ), static_cast<uint16_t>( var2 ) );
+      }
+
+      insert( function, {success, repr, operations} );
+    }
+    return true;
+  }
+
+  /*! \brief Writes all entries to a stream. */
+  void save( std::ostream& os ) const
+  {
+    for ( auto const& [function, entry] : _entries )
+    {
+      os << kitty::to_hex( function ) << " " << std::get<0>( entry ) << " " << kitty::to_hex( std::get<1>( entry ) ) << " " << std::get<2>( entry ).size();
+      for ( auto const& op : std::get<2>( entry ) )
+      {
+        os << " " << static_cast<uint32_t>( op._kind ) << " " << op._var1 << " " << op._var2;
+      }
+      os << "\n";
+    }
+  }
+
+  /*! \brief Adds all entries from a file; returns false if it cannot be read. */
+  bool load( std::string const& filename )
+  {
+    std::ifstream in( filename.c_str(), std::ifstream::in );
+    return in.is_open() && load( in );
+  }
+
+  /*! \brief Writes all entries to a file. */
+  void save( std::string const& filename ) const
+  {
+    std::ofstream os( filename.c_str(), std::ofstream::out );
+    save( os );
+  }
+
+private:
+  std::unordered_map<kitty::static_truth_table<6>, entry_type, kitty::hash<kitty::static_truth_table<6>>> _entries;
+};
+
 /*! \brief Resynthesis function based on pre-computed size-optimum MIGs.
  *
  * This resynthesis function can be passed to ``cut_rewriting`` with a cut size
@@ -149,12 +260,24 @@ public:
    * \param pst Statistics
    */
   xag_minmc_resynthesis( std::string const& filename, xag_minmc_resynthesis_params const& ps = {}, xag_minmc_resynthesis_stats* pst = nullptr )
+      : xag_minmc_resynthesis( filename, std::make_shared<xag_minmc_classify_cache>(), ps, pst )
+  {
+  }
+
+  /*! \brief Constructor with shared classification cache.
+   *
+   * \param filename Database file with precomputed functions
+   * \param classify_cache Classification cache, which may be shared with other instances
+   * \param ps Parameters
+   * \param pst Statistics
+   */
+  xag_minmc_resynthesis( std::string const& filename, std::shared_ptr<xag_minmc_classify_cache> const& classify_cache, xag_minmc_resynthesis_params const& ps = {}, xag_minmc_resynthesis_stats* pst = nullptr )
       : ps( ps ),
         pst( pst ),
         db( std::make_shared<xag_network>() ),
         db_pis( std::make_shared<decltype( db_pis )::element_type>( 6u ) ),
         func_mc( std::make_shared<decltype( func_mc )::element_type>() ),
-        classify_cache( std::make_shared<decltype( classify_cache )::element_type>() )
+        classify_cache( classify_cache )
   {
     build_db( filename );
   }
@@ -229,17 +352,15 @@ public:
     std::vector<kitty::detail::spectral_operation> trans;
     kitty::static_truth_table<6> tt_ext;
 
-    const auto cache_it = classify_cache->find( func_ext );
-
-    if ( cache_it != classify_cache->end() )
+    if ( const auto entry = classify_cache->find( func_ext ); entry )
     {
       st.cache_hits++;
-      if ( !std::get<0>( cache_it->second ) )
+      if ( !std::get<0>( *entry ) )
       {
         return; /* quit */
       }
-      tt_ext = std::get<1>( cache_it->second );
-      trans = std::get<2>( cache_it->second );
+      tt_ext = std::get<1>( *entry );
+      trans = std::get<2>( *entry );
     }
     else
     {
@@ -250,7 +371,7 @@ public:
                                                                                                             std::copy( ops.begin(), ops.end(),
                                                                                                                        std::back_inserter( trans ) );
                                                                                                           } ); } );
-      classify_cache->insert( {func_ext, {spectral.second, spectral.first, trans}} );
+      classify_cache->insert( func_ext, {spectral.second, spectral.first, trans} );
       if ( !spectral.second )
       {
         st.classify_aborts++;
@@ -470,7 +591,7 @@ private:
   std::shared_ptr<xag_network> db;
   std::shared_ptr<std::vector<xag_network::signal>> db_pis;
   std::shared_ptr<std::unordered_map<std::string, std::tuple<std::string, unsigned, xag_network::signal>>> func_mc;
-  std::shared_ptr<std::unordered_map<kitty::static_truth_table<6>, std::tuple<bool, kitty::static_truth_table<6>, std::vector<kitty::detail::spectral_operation>>, kitty::hash<kitty::static_truth_table<6>>>> classify_cache;
+  std::shared_ptr<xag_minmc_classify_cache> classify_cache;
 };
 
 } // namespace mockturtle
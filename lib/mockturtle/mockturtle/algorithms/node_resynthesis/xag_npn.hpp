@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 #include <fmt/format.h>
@@ -60,7 +61,10 @@ struct xag_npn_resynthesis_params
 
 struct xag_npn_resynthesis_stats
 {
+  /*! \brief Time to build the NPN classes (once per process). */
   stopwatch<>::duration time_classes{0};
+
+  /*! \brief Time to build the database (once per process). */
   stopwatch<>::duration time_db{0};
 
   uint32_t db_size;
@@ -73,148 +77,38 @@ struct xag_npn_resynthesis_stats
   }
 };
 
-/*! \brief Resynthesis function based on pre-computed AIGs.
- *
- * This resynthesis function can be passed to ``cut_rewriting``.  It will
- * produce a network based on pre-computed XAGs with up to at most 4 variables.
- * Consequently, the nodes' fan-in sizes in the input network must not exceed
- * 4.
- *
-   \verbatim embed:rst
-  
-   Example
-   
-   .. code-block:: c++
-   
-      const aig_network aig = ...;
-      xag_npn_resynthesis<aig_network> resyn;
-      cut_rewriting( aig, resyn );
-
-   .. note::
+namespace detail
+{
 
-      The implementation of this algorithm was heavily inspired buy the rewrite
-      command in AIG.  It uses the same underlying database of subcircuits.
-   \endverbatim
- */
-template<class Ntk, class DatabaseNtk = xag_network>
-class xag_npn_resynthesis
+/* Database of size-optimum subgraphs for all NPN classes of 4-input functions.
+   The database only depends on `DatabaseNtk` and is shared by all instances of
+   `xag_npn_resynthesis` in the process; it is built once on first use. */
+template<class DatabaseNtk>
+class xag_npn_database
 {
 public:
-  xag_npn_resynthesis( xag_npn_resynthesis_params const& ps = {}, xag_npn_resynthesis_stats* pst = nullptr )
-      : ps( ps ),
-        pst( pst ),
-        _classes( 1 << 16 )
+  static xag_npn_database const& get()
   {
-    static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
-    static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
-    static_assert( has_create_and_v<Ntk>, "Ntk does not implement the create_and method" );
-    static_assert( has_create_xor_v<Ntk>, "Ntk does not implement the create_xor method" );
-
-    static_assert( is_network_type_v<DatabaseNtk>, "DatabaseNtk is not a network type" );
-    static_assert( has_get_node_v<DatabaseNtk>, "DatabaseNtk does not implement the get_node method" );
-    static_assert( has_is_complemented_v<DatabaseNtk>, "DatabaseNtk does not implement the is_complemented method" );
-    static_assert( has_is_xor_v<DatabaseNtk>, "DatabaseNtk does not implement the is_xor method" );
-    static_assert( has_size_v<DatabaseNtk>, "DatabaseNtk does not implement the size method" );
-    static_assert( has_create_pi_v<DatabaseNtk>, "DatabaseNtk does not implement the create_pi method" );
-    static_assert( has_create_and_v<DatabaseNtk>, "DatabaseNtk does not implement the create_and method" );
-    static_assert( has_create_xor_v<DatabaseNtk>, "DatabaseNtk does not implement the create_xor method" );
-    static_assert( has_foreach_fanin_v<DatabaseNtk>, "DatabaseNtk does not implement the foreach_fanin method" );
-    static_assert( has_foreach_node_v<DatabaseNtk>, "DatabaseNtk does not implement the foreach_node method" );
-    static_assert( has_make_signal_v<DatabaseNtk>, "DatabaseNtk does not implement the make_signal method" );
-
-    _repr.reserve( 222u );
-    build_classes();
-    build_db();
+    /* initialization of function-local statics is thread-safe */
+    static const xag_npn_database database;
+    return database;
   }
 
-  virtual ~xag_npn_resynthesis()
-  {
-    if ( ps.verbose )
-    {
-      st.report();
-    }
-
-    if ( pst )
-    {
-      *pst = st;
-    }
-  }
-
-  template<typename LeavesIterator, typename Fn>
-  void operator()( Ntk& ntk, kitty::dynamic_truth_table const& function, LeavesIterator begin, LeavesIterator end, Fn&& fn )
-  {
-    kitty::static_truth_table<4> tt = kitty::extend_to<4>( function );
-
-    /* get representative of function */
-    const auto repr = _repr[_classes[*tt.cbegin()]];
-
-    /* check if representative has circuits */
-    const auto it = _repr_to_signal.find( repr );
-    if ( it == _repr_to_signal.end() )
-    {
-      return;
-    }
-
-    const auto config = kitty::exact_npn_canonization( tt );
-
-    assert( repr == std::get<0>( config ) );
-
-    std::vector<signal<Ntk>> pis( 4, ntk.get_constant( false ) );
-    std::copy( begin, end, pis.begin() );
-
-    std::vector<signal<Ntk>> pis_perm( 4 );
-    auto perm = std::get<2>( config );
-    for ( auto i = 0; i < 4; ++i )
-    {
-      pis_perm[i] = pis[perm[i]];
-    }
-
-    const auto& phase = std::get<1>( config );
-    for ( auto i = 0; i < 4; ++i )
-    {
-      if ( ( phase >> perm[i] ) & 1 )
-      {
-        pis_perm[i] = !pis_perm[i];
-      }
-    }
-
-    for ( auto const& cand : it->second )
-    {
-      std::unordered_map<node<DatabaseNtk>, signal<Ntk>> db_to_ntk;
-      db_to_ntk[0] = ntk.get_constant( false );
-      for ( auto i = 0; i < 4; ++i )
-      {
-        db_to_ntk[i + 1] = pis_perm[i];
-      }
-      const auto f = copy_db_entry( ntk, _db.get_node( cand ), db_to_ntk ) ^ _db.is_complemented( cand );
-      if ( !fn( ( ( phase >> 4 ) & 1 ) ? !f : f ) )
-      {
-        return;
-      }
-    }
-  }
+  xag_npn_database( xag_npn_database const& ) = delete;
+  xag_npn_database& operator=( xag_npn_database const& ) = delete;
 
 private:
-  signal<Ntk>
-  copy_db_entry( Ntk& ntk, node<DatabaseNtk> const& n, std::unordered_map<node<DatabaseNtk>, signal<Ntk>>& db_to_ntk ) const
+  xag_npn_database()
+      : classes( 1 << 16 )
   {
-    if ( const auto it = db_to_ntk.find( n ); it != db_to_ntk.end() )
-    {
-      return it->second;
-    }
-
-    std::array<signal<Ntk>, 2> fanin;
-    _db.foreach_fanin( n, [&]( auto const& f, auto i ) {
-      fanin[i] = copy_db_entry( ntk, _db.get_node( f ), db_to_ntk ) ^ _db.is_complemented( f );
-    } );
-
-    const auto f = _db.is_xor( n ) ? ntk.create_xor( fanin[0], fanin[1] ) : ntk.create_and( fanin[0], fanin[1] );
-    return db_to_ntk[n] = f;
+    repr.reserve( 222u );
+    build_classes();
+    build_db();
   }
 
   void build_classes()
   {
-    stopwatch t( st.time_classes );
+    stopwatch t( time_classes );
 
     kitty::dynamic_truth_table map( 16u );
     std::transform( map.cbegin(), map.cend(), map.begin(), []( auto word ) { return ~word; } );
@@ -225,10 +119,10 @@ private:
     {
       kitty::create_from_words( tt, &index, &index + 1 );
       const auto res = kitty::exact_npn_canonization( tt, [&]( const auto& tt ) {
-        _classes[*tt.cbegin()] = _repr.size();
+        classes[*tt.cbegin()] = repr.size();
         kitty::clear_bit( map, *tt.cbegin() );
       } );
-      _repr.push_back( std::get<0>( res ) );
+      repr.push_back( std::get<0>( res ) );
 
       /* find next non-classified truth table */
       index = find_first_one_bit( map );
@@ -237,13 +131,13 @@ private:
 
   void build_db()
   {
-    stopwatch t( st.time_db );
+    stopwatch t( time_db );
 
     /* four primary inputs */
-    _db.create_pi();
-    _db.create_pi();
-    _db.create_pi();
-    _db.create_pi();
+    db.create_pi();
+    db.create_pi();
+    db.create_pi();
+    db.create_pi();
 
     auto* p = subgraphs;
     while ( true )
@@ -257,64 +151,62 @@ private:
       auto is_xor = entry0 & 1;
       entry0 >>= 1;
 
-      const auto child0 = _db.make_signal( entry0 >> 1 ) ^ ( entry0 & 1 );
-      const auto child1 = _db.make_signal( entry1 >> 1 ) ^ ( entry1 & 1 );
+      const auto child0 = db.make_signal( entry0 >> 1 ) ^ ( entry0 & 1 );
+      const auto child1 = db.make_signal( entry1 >> 1 ) ^ ( entry1 & 1 );
 
       if ( is_xor )
       {
-        _db.create_xor( child0, child1 );
+        db.create_xor( child0, child1 );
       }
       else
       {
-        _db.create_and( child0, child1 );
+        db.create_and( child0, child1 );
       }
     }
 
-    const auto sim_res = simulate_nodes<kitty::static_truth_table<4>>( _db );
+    const auto sim_res = simulate_nodes<kitty::static_truth_table<4>>( db );
 
-    _db.foreach_node( [&]( auto n ) {
-      if ( _repr[_classes[*sim_res[n].cbegin()]] == sim_res[n] )
+    db.foreach_node( [&]( auto n ) {
+      if ( repr[classes[*sim_res[n].cbegin()]] == sim_res[n] )
       {
-        if ( _repr_to_signal.count( sim_res[n] ) == 0 )
+        if ( repr_to_signal.count( sim_res[n] ) == 0 )
         {
-          _repr_to_signal.insert( {sim_res[n], {_db.make_signal( n )}} );
+          repr_to_signal.insert( {sim_res[n], {db.make_signal( n )}} );
         }
         else
         {
-          _repr_to_signal[sim_res[n]].push_back( _db.make_signal( n ) );
+          repr_to_signal[sim_res[n]].push_back( db.make_signal( n ) );
         }
       }
       else
       {
         const auto f = ~sim_res[n];
-        if ( _repr[_classes[*f.cbegin()]] == f )
+        if ( repr[classes[*f.cbegin()]] == f )
         {
-          if ( _repr_to_signal.count( f ) == 0 )
+          if ( repr_to_signal.count( f ) == 0 )
           {
-            _repr_to_signal.insert( {f, {!_db.make_signal( n )}} );
+            repr_to_signal.insert( {f, {!db.make_signal( n )}} );
           }
           else
           {
-            _repr_to_signal[f].push_back( !_db.make_signal( n ) );
+            repr_to_signal[f].push_back( !db.make_signal( n ) );
           }
         }
       }
     } );
-
-    st.db_size = _db.size();
-    st.covered_classes = _repr_to_signal.size();
   }
 
-  xag_npn_resynthesis_params ps;
-  xag_npn_resynthesis_stats st;
-  xag_npn_resynthesis_stats* pst{nullptr};
+public:
+  stopwatch<>::duration time_classes{0};
+  stopwatch<>::duration time_db{0};
 
-  std::vector<kitty::static_truth_table<4>> _repr;
-  std::vector<uint8_t> _classes;
-  std::unordered_map<kitty::static_truth_table<4>, std::vector<signal<DatabaseNtk>>, kitty::hash<kitty::static_truth_table<4>>> _repr_to_signal;
+  std::vector<kitty::static_truth_table<4>> repr;
+  std::vector<uint8_t> classes;
+  std::unordered_map<kitty::static_truth_table<4>, std::vector<signal<DatabaseNtk>>, kitty::hash<kitty::static_truth_table<4>>> repr_to_signal;
 
-  DatabaseNtk _db;
+  DatabaseNtk db;
 
+private:
   // clang-format off
   inline static const uint16_t subgraphs[]
   {
@@ -677,6 +569,155 @@ private:
     0x0000,0x0000
   };
   // clang-format on
-}; // namespace mockturtle
+};
+
+} /* namespace detail */
+
+/*! \brief Resynthesis function based on pre-computed AIGs.
+ *
+ * This resynthesis function can be passed to ``cut_rewriting``.  It will
+ * produce a network based on pre-computed XAGs with up to at most 4 variables.
+ * Consequently, the nodes' fan-in sizes in the input network must not exceed
+ * 4.
+ *
+   \verbatim embed:rst
+  
+   Example
+   
+   .. code-block:: c++
+   
+      const aig_network aig = ...;
+      xag_npn_resynthesis<aig_network> resyn;
+      cut_rewriting( aig, resyn );
+
+   .. note::
+
+      The implementation of this algorithm was heavily inspired buy the rewrite
+      command in AIG.  It uses the same underlying database of subcircuits.
+   \endverbatim
+ */
+template<class Ntk, class DatabaseNtk = xag_network>
+class xag_npn_resynthesis
+{
+public:
+  xag_npn_resynthesis( xag_npn_resynthesis_params const& ps = {}, xag_npn_resynthesis_stats* pst = nullptr )
+      : ps( ps ),
+        pst( pst ),
+        _database( &detail::xag_npn_database<DatabaseNtk>::get() )
+  {
+    static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+    static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
+    static_assert( has_create_and_v<Ntk>, "Ntk does not implement the create_and method" );
+    static_assert( has_create_xor_v<Ntk>, "Ntk does not implement the create_xor method" );
+
+    static_assert( is_network_type_v<DatabaseNtk>, "DatabaseNtk is not a network type" );
+    static_assert( has_get_node_v<DatabaseNtk>, "DatabaseNtk does not implement the get_node method" );
+    static_assert( has_is_complemented_v<DatabaseNtk>, "DatabaseNtk does not implement the is_complemented method" );
+    static_assert( has_is_xor_v<DatabaseNtk>, "DatabaseNtk does not implement the is_xor method" );
+    static_assert( has_size_v<DatabaseNtk>, "DatabaseNtk does not implement the size method" );
+    static_assert( has_create_pi_v<DatabaseNtk>, "DatabaseNtk does not implement the create_pi method" );
+    static_assert( has_create_and_v<DatabaseNtk>, "DatabaseNtk does not implement the create_and method" );
+    static_assert( has_create_xor_v<DatabaseNtk>, "DatabaseNtk does not implement the create_xor method" );
+    static_assert( has_foreach_fanin_v<DatabaseNtk>, "DatabaseNtk does not implement the foreach_fanin method" );
+    static_assert( has_foreach_node_v<DatabaseNtk>, "DatabaseNtk does not implement the foreach_node method" );
+    static_assert( has_make_signal_v<DatabaseNtk>, "DatabaseNtk does not implement the make_signal method" );
+
+    st.time_classes = _database->time_classes;
+    st.time_db = _database->time_db;
+    st.db_size = _database->db.size();
+    st.covered_classes = static_cast<uint32_t>( _database->repr_to_signal.size() );
+  }
+
+  virtual ~xag_npn_resynthesis()
+  {
+    if ( ps.verbose )
+    {
+      st.report();
+    }
+
+    if ( pst )
+    {
+      *pst = st;
+    }
+  }
+
+  template<typename LeavesIterator, typename Fn>
+  void operator()( Ntk& ntk, kitty::dynamic_truth_table const& function, LeavesIterator begin, LeavesIterator end, Fn&& fn )
+  {
+    kitty::static_truth_table<4> tt = kitty::extend_to<4>( function );
+
+    /* get representative of function */
+    const auto repr = _database->repr[_database->classes[*tt.cbegin()]];
+
+    /* check if representative has circuits */
+    const auto it = _database->repr_to_signal.find( repr );
+    if ( it == _database->repr_to_signal.end() )
+    {
+      return;
+    }
+
+    const auto config = kitty::exact_npn_canonization_lookup( tt );
+
+    assert( repr == std::get<0>( config ) );
+
+    std::vector<signal<Ntk>> pis( 4, ntk.get_constant( false ) );
+    std::copy( begin, end, pis.begin() );
+
+    std::vector<signal<Ntk>> pis_perm( 4 );
+    auto perm = std::get<2>( config );
+    for ( auto i = 0; i < 4; ++i )
+    {
+      pis_perm[i] = pis[perm[i]];
+    }
+
+    const auto& phase = std::get<1>( config );
+    for ( auto i = 0; i < 4; ++i )
+    {
+      if ( ( phase >> perm[i] ) & 1 )
+      {
+        pis_perm[i] = !pis_perm[i];
+      }
+    }
+
+    for ( auto const& cand : it->second )
+    {
+      std::unordered_map<node<DatabaseNtk>, signal<Ntk>> db_to_ntk;
+      db_to_ntk[0] = ntk.get_constant( false );
+      for ( auto i = 0; i < 4; ++i )
+      {
+        db_to_ntk[i + 1] = pis_perm[i];
+      }
+      const auto f = copy_db_entry( ntk, _database->db.get_node( cand ), db_to_ntk ) ^ _database->db.is_complemented( cand );
+      if ( !fn( ( ( phase >> 4 ) & 1 ) ? !f : f ) )
+      {
+        return;
+      }
+    }
+  }
+
+private:
+  signal<Ntk>
+  copy_db_entry( Ntk& ntk, node<DatabaseNtk> const& n, std::unordered_map<node<DatabaseNtk>, signal<Ntk>>& db_to_ntk ) const
+  {
+    if ( const auto it = db_to_ntk.find( n ); it != db_to_ntk.end() )
+    {
+      return it->second;
+    }
+
+    std::array<signal<Ntk>, 2> fanin;
+    _database->db.foreach_fanin( n, [&]( auto const& f, auto i ) {
+      fanin[i] = copy_db_entry( ntk, _database->db.get_node( f ), db_to_ntk ) ^ _database->db.is_complemented( f );
+    } );
+
+    const auto f = _database->db.is_xor( n ) ? ntk.create_xor( fanin[0], fanin[1] ) : ntk.create_and( fanin[0], fanin[1] );
+    return db_to_ntk[n] = f;
+  }
+
+  xag_npn_resynthesis_params ps;
+  xag_npn_resynthesis_stats st;
+  xag_npn_resynthesis_stats* pst{nullptr};
+
+  detail::xag_npn_database<DatabaseNtk> const* _database;
+};
 
 } /* namespace mockturtle */
@@ -86,7 +86,7 @@ public:
   {
     assert( function.num_vars() <= 4 );
     const auto fe = kitty::extend_to( function, 4 );
-    const auto config = kitty::exact_npn_canonization( fe );
+    const auto config = kitty::exact_npn_canonization_lookup( fe );
 
     auto func_str = "0x" + kitty::to_hex( std::get<0>( config ) );
     const auto it = class2signal.find( func_str );
@@ -0,0 +1,350 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file partial_simulation.hpp
+  \brief Bit-parallel simulation with a subset of input patterns
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../traits.hpp"
+
+#include <kitty/static_truth_table.hpp>
+
+namespace mockturtle
+{
+
+/*! \brief Parameters for partial_simulator.
+ *
+ * The data structure `partial_simulator_params` holds configurable parameters
+ * with default arguments for `partial_simulator`.
+ */
+struct partial_simulator_params
+{
+  /*! \brief Seed for the random input patterns. */
+  uint64_t seed{0xcafeaffe};
+
+  /*! \brief Number of threads to simulate pattern blocks concurrently. */
+  uint32_t num_threads{1u};
+};
+
+/*! \brief Bit-parallel simulation of a network with a subset of input patterns.
+ *
+ * Unlike `simulate_nodes` with complete truth tables, whose memory grows
+ * exponentially with the number of primary inputs, this simulator stores a
+ * fixed number of 64-bit words of patterns per node.  The simulation values of
+ * all nodes are kept in one contiguous arena, in which the words of a node are
+ * stored consecutively.  The simulator is initialized with random patterns and
+ * further patterns (e.g., counter-examples) can be added incrementally.
+ *
+ * Simulation values of gates are computed with the network's `compute`
+ * method for 6-variable static truth tables, i.e., one 64-bit word at a time.
+ * The words are split into blocks that are simulated concurrently if
+ * `num_threads` is larger than 1.
+ *
+ * **Required network functions:**
+ * - `size`
+ * - `get_node`
+ * - `node_to_index`
+ * - `get_constant`
+ * - `constant_value`
+ * - `is_complemented`
+ * - `num_pis`
+ * - `foreach_pi`
+ * - `foreach_gate`
+ * - `foreach_fanin`
+ * - `compute` for `kitty::static_truth_table<6>`
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      const aig_network aig = ...;
+      partial_simulator sim( aig, 16u ); // 1024 random patterns
+
+      // add counter-example
+      std::vector<bool> pattern( aig.num_pis() );
+      ...
+      sim.add_pattern( pattern );
+
+      if ( sim.equal( f, g ) )
+      {
+        // f and g are candidates for being functionally equivalent
+      }
+   \endverbatim
+ */
+template<class Ntk>
+class partial_simulator
+{
+public:
+  using node = typename Ntk::node;
+  using signal = typename Ntk::signal;
+
+  /*! \brief Creates simulator with random patterns.
+   *
+   * \param ntk Network (its structure must not change while simulating)
+   * \param num_words Number of 64-bit words of random patterns per node
+   * \param ps Parameters
+   */
+  explicit partial_simulator( Ntk const& ntk, uint32_t num_words, partial_simulator_params const& ps = {} )
+      : ntk( ntk ),
+        ps( ps ),
+        _num_words( num_words ),
+        _num_patterns( 64u * num_words ),
+        _capacity( std::max( num_words, 1u ) ),
+        _arena( static_cast<std::size_t>( ntk.size() ) * _capacity, 0u )
+  {
+    static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+    static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
+    static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+    static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+    static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
+    static_assert( has_constant_value_v<Ntk>, "Ntk does not implement the constant_value method" );
+    static_assert( has_is_complemented_v<Ntk>, "Ntk does not implement the is_complemented method" );
+    static_assert( has_num_pis_v<Ntk>, "Ntk does not implement the num_pis method" );
+    static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
+    static_assert( has_foreach_gate_v<Ntk>, "Ntk does not implement the foreach_gate method" );
+    static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+    static_assert( has_compute_v<Ntk, kitty::static_truth_table<6>>, "Ntk does not implement the compute method for kitty::static_truth_table<6>" );
+
+    /* flatten gates and their fanins in topological order */
+    ntk.foreach_gate( [&]( auto const& n ) {
+      _gates.push_back( n );
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        _fanins.push_back( ntk.node_to_index( ntk.get_node( f ) ) );
+      } );
+      _fanin_offsets.push_back( static_cast<uint32_t>( _fanins.size() ) );
+    } );
+
+    ntk.foreach_pi( [&]( auto const& n ) {
+      _pis.push_back( ntk.node_to_index( n ) );
+    } );
+
+    std::mt19937_64 rng( ps.seed );
+    for ( auto pi : _pis )
+    {
+      std::generate( row( pi ), row( pi ) + _num_words, std::ref( rng ) );
+    }
+
+    simulate();
+  }
+
+  /*! \brief Number of simulated patterns. */
+  uint32_t num_patterns() const
+  {
+    return _num_patterns;
+  }
+
+  /*! \brief Number of words per node (the last one may be used partially). */
+  uint32_t num_words() const
+  {
+    return _num_words;
+  }
+
+  /*! \brief Returns the simulation words of a node. */
+  uint64_t const* words( node const& n ) const
+  {
+    return row( ntk.node_to_index( n ) );
+  }
+
+  /*! \brief Returns the value of a signal for a pattern. */
+  bool get_bit( signal const& f, uint32_t pattern ) const
+  {
+    return ( ( words( ntk.get_node( f ) )[pattern >> 6] >> ( pattern & 63 ) ) & 1 ) != ntk.is_complemented( f );
+  }
+
+  /*! \brief Checks whether two signals agree on all patterns. */
+  bool equal( signal const& f, signal const& g ) const
+  {
+    const auto* wf = words( ntk.get_node( f ) );
+    const auto* wg = words( ntk.get_node( g ) );
+    const uint64_t flip = ntk.is_complemented( f ) != ntk.is_complemented( g ) ? ~UINT64_C( 0 ) : UINT64_C( 0 );
+
+    for ( auto w = 0u; w < _num_words; ++w )
+    {
+      if ( ( ( wf[w] ^ wg[w] ^ flip ) & mask( w ) ) != 0u )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief Adds a pattern and simulates it.
+   *
+   * Only the word that contains the new pattern is re-simulated.
+   *
+   * \param pattern Value for each primary input
+   */
+  void add_pattern( std::vector<bool> const& pattern )
+  {
+    assert( pattern.size() == _pis.size() );
+
+    const auto word = _num_patterns >> 6;
+    const auto bit = _num_patterns & 63;
+    if ( bit == 0u )
+    {
+      if ( word == _capacity )
+      {
+        reserve( 2u * _capacity );
+      }
+      ++_num_words;
+    }
+
+    for ( auto i = 0u; i < _pis.size(); ++i )
+    {
+      if ( pattern[i] )
+      {
+        row( _pis[i] )[word] |= UINT64_C( 1 ) << bit;
+      }
+    }
+    ++_num_patterns;
+
+    std::vector<kitty::static_truth_table<6>> fanin_values;
+    simulate_words( word, word + 1u, fanin_values );
+  }
+
+  /*! \brief Simulates all patterns. */
+  void simulate()
+  {
+    fill_constants();
+
+    const auto num_threads = std::max( 1u, std::min( ps.num_threads, _num_words ) );
+    if ( num_threads == 1u )
+    {
+      std::vector<kitty::static_truth_table<6>> fanin_values;
+      simulate_words( 0u, _num_words, fanin_values );
+      return;
+    }
+
+    /* each thread simulates a block of words for all nodes */
+    std::vector<std::thread> threads;
+    const auto block_size = ( _num_words + num_threads - 1u ) / num_threads;
+    for ( auto begin = 0u; begin < _num_words; begin += block_size )
+    {
+      threads.emplace_back( [this, begin, block_size]() {
+        std::vector<kitty::static_truth_table<6>> fanin_values;
+        simulate_words( begin, std::min( begin + block_size, _num_words ), fanin_values );
+      } );
+    }
+    for ( auto& thread : threads )
+    {
+      thread.join();
+    }
+  }
+
+private:
+  uint64_t* row( uint32_t index )
+  {
+    return _arena.data() + static_cast<std::size_t>( index ) * _capacity;
+  }
+
+  uint64_t const* row( uint32_t index ) const
+  {
+    return _arena.data() + static_cast<std::size_t>( index ) * _capacity;
+  }
+
+  /* mask of valid patterns in a word */
+  uint64_t mask( uint32_t word ) const
+  {
+    const auto bits = _num_patterns - 64u * word;
+    return bits >= 64u ? ~UINT64_C( 0 ) : ( ( UINT64_C( 1 ) << bits ) - 1u );
+  }
+
+  void reserve( uint32_t capacity )
+  {
+    std::vector<uint64_t> arena( static_cast<std::size_t>( ntk.size() ) * capacity, 0u );
+    for ( auto i = 0u; i < ntk.size(); ++i )
+    {
+      std::copy( row( i ), row( i ) + _num_words, arena.data() + static_cast<std::size_t>( i ) * capacity );
+    }
+    _arena.swap( arena );
+    _capacity = capacity;
+
+    fill_constants();
+  }
+
+  /* constant rows are filled for the whole capacity */
+  void fill_constants()
+  {
+    for ( auto value : {false, true} )
+    {
+      const auto n = ntk.get_node( ntk.get_constant( value ) );
+      auto* words = row( ntk.node_to_index( n ) );
+      std::fill( words, words + _capacity, ntk.constant_value( n ) ? ~UINT64_C( 0 ) : UINT64_C( 0 ) );
+    }
+  }
+
+  void simulate_words( uint32_t begin, uint32_t end, std::vector<kitty::static_truth_table<6>>& fanin_values )
+  {
+    auto offset = 0u;
+    for ( auto i = 0u; i < _gates.size(); ++i )
+    {
+      const auto fanin_begin = offset;
+      offset = _fanin_offsets[i];
+      auto* result = row( ntk.node_to_index( _gates[i] ) );
+
+      fanin_values.resize( offset - fanin_begin );
+      for ( auto w = begin; w < end; ++w )
+      {
+        for ( auto j = fanin_begin; j < offset; ++j )
+        {
+          fanin_values[j - fanin_begin]._bits = row( _fanins[j] )[w];
+        }
+        result[w] = ntk.compute( _gates[i], fanin_values.begin(), fanin_values.end() )._bits;
+      }
+    }
+  }
+
+private:
+  Ntk const& ntk;
+  partial_simulator_params ps;
+
+  uint32_t _num_words;
+  uint32_t _num_patterns;
+  uint32_t _capacity;
+
+  /* simulation words, `_capacity` words for each node index */
+  std::vector<uint64_t> _arena;
+
+  std::vector<node> _gates;
+  std::vector<uint32_t> _fanin_offsets;
+  std::vector<uint32_t> _fanins;
+  std::vector<uint32_t> _pis;
+};
+
+} // namespace mockturtle
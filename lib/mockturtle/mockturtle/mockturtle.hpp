@@ -45,6 +45,7 @@
 #include "algorithms/node_resynthesis.hpp"
 #include "algorithms/node_resynthesis/akers.hpp"
 #include "algorithms/node_resynthesis/mig_npn.hpp"
+#include "algorithms/partial_simulation.hpp"
 #include "algorithms/reconv_cut.hpp"
 #include "algorithms/refactoring.hpp"
 #include "algorithms/resubstitution.hpp"
@@ -59,6 +60,7 @@
 #include "networks/mig.hpp"
 #include "networks/xag.hpp"
 #include "networks/xmg.hpp"
+#include "utils/concurrent_truth_table_cache.hpp"
 #include "utils/cuts.hpp"
 #include "utils/mixed_radix.hpp"
 #include "utils/node_map.hpp"
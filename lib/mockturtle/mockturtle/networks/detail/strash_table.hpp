@@ -0,0 +1,248 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file strash_table.hpp
+  \brief Open-addressing hash table for structural hashing
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace mockturtle::detail
+{
+
+/* Structural hash table for nodes with a fixed number of complementable
+   children.  Keys are the children literals (2 * index + complement) packed as
+   32-bit integers, i.e., a 2-input node uses a single 64-bit key, and they are
+   stored next to the node index in one flat array of slots.  Collisions are
+   resolved with linear probing and deleted entries are removed with backward
+   shifting, such that no tombstones are needed.
+
+   The interface is the subset of `sparse_hash_map` that the networks use for
+   structural hashing. */
+template<int Fanin>
+class strash_table
+{
+public:
+  using key_type = std::array<uint32_t, Fanin>;
+
+  struct entry
+  {
+    key_type first;
+    uint32_t second;
+  };
+
+  using iterator = entry*;
+  using const_iterator = entry const*;
+
+  strash_table()
+  {
+    rehash( 16u );
+  }
+
+  template<class Node>
+  iterator find( Node const& n )
+  {
+    const auto key = make_key( n );
+    const auto slot = find_slot( key );
+    return is_empty( _slots[slot] ) ? end() : &_slots[slot];
+  }
+
+  template<class Node>
+  const_iterator find( Node const& n ) const
+  {
+    return const_cast<strash_table*>( this )->find( n );
+  }
+
+  iterator end()
+  {
+    return _slots.data() + _slots.size();
+  }
+
+  const_iterator end() const
+  {
+    return _slots.data() + _slots.size();
+  }
+
+  /* returns the node index of `n`, inserts `n` if it is not contained */
+  template<class Node>
+  uint32_t& operator[]( Node const& n )
+  {
+    const auto key = make_key( n );
+    auto slot = find_slot( key );
+    if ( !is_empty( _slots[slot] ) )
+    {
+      return _slots[slot].second;
+    }
+
+    if ( 10u * ( _size + 1u ) > 7u * _slots.size() )
+    {
+      rehash( 2u * _slots.size() );
+      slot = find_slot( key );
+    }
+
+    ++_size;
+    _slots[slot].first = key;
+    _slots[slot].second = 0u;
+    return _slots[slot].second;
+  }
+
+  template<class Node>
+  std::size_t erase( Node const& n )
+  {
+    auto hole = find_slot( make_key( n ) );
+    if ( is_empty( _slots[hole] ) )
+    {
+      return 0u;
+    }
+
+    /* shift back entries of the probing sequence into the hole */
+    for ( auto next = ( hole + 1u ) & _mask; !is_empty( _slots[next] ); next = ( next + 1u ) & _mask )
+    {
+      const auto home = hash( _slots[next].first ) & _mask;
+      if ( ( ( next - home ) & _mask ) >= ( ( next - hole ) & _mask ) )
+      {
+        _slots[hole] = _slots[next];
+        hole = next;
+      }
+    }
+
+    _slots[hole].first[0] = empty_literal;
+    --_size;
+    return 1u;
+  }
+
+  /* makes room for `count` entries without rehashing */
+  void reserve( std::size_t count )
+  {
+    auto capacity = _slots.size();
+    while ( 7u * capacity < 10u * count )
+    {
+      capacity <<= 1u;
+    }
+    if ( capacity != _slots.size() )
+    {
+      rehash( capacity );
+    }
+  }
+
+  std::size_t size() const
+  {
+    return _size;
+  }
+
+private:
+  static constexpr uint32_t empty_literal = UINT32_MAX;
+
+  template<class Node>
+  static key_type make_key( Node const& n )
+  {
+    key_type key;
+    for ( auto i = 0u; i < key.size(); ++i )
+    {
+      assert( n.children[i].data < empty_literal );
+      key[i] = static_cast<uint32_t>( n.children[i].data );
+    }
+    return key;
+  }
+
+  static bool is_empty( entry const& e )
+  {
+    return e.first[0] == empty_literal;
+  }
+
+  static uint64_t hash( key_type const& key )
+  {
+    uint64_t h{0};
+    for ( auto i = 0u; i < key.size(); i += 2u )
+    {
+      uint64_t word = key[i];
+      if ( i + 1u < key.size() )
+      {
+        word = ( word << 32u ) | key[i + 1u];
+      }
+      h = ( h ^ word ) * UINT64_C( 0x9e3779b97f4a7c15 );
+    }
+    return h ^ ( h >> 29u );
+  }
+
+  std::size_t find_slot( key_type const& key ) const
+  {
+    auto slot = hash( key ) & _mask;
+    while ( !is_empty( _slots[slot] ) && _slots[slot].first != key )
+    {
+      slot = ( slot + 1u ) & _mask;
+    }
+    return slot;
+  }
+
+  /* capacity must be a power of two */
+  void rehash( std::size_t capacity )
+  {
+    entry empty;
+    empty.first.fill( empty_literal );
+    empty.second = 0u;
+
+    std::vector<entry> slots( capacity, empty );
+    std::swap( _slots, slots );
+    _mask = capacity - 1u;
+
+    /* bulk insertion: prefetch the home slots of upcoming entries */
+    constexpr std::size_t distance = 8u;
+    for ( auto i = 0u; i < slots.size(); ++i )
+    {
+#if defined( __GNUC__ ) || defined( __clang__ )
+      if ( i + distance < slots.size() && !is_empty( slots[i + distance] ) )
+      {
+        __builtin_prefetch( &_slots[hash( slots[i + distance].first ) & _mask], 1 );
+      }
+#endif
+      if ( is_empty( slots[i] ) )
+      {
+        continue;
+      }
+      auto slot = hash( slots[i].first ) & _mask;
+      while ( !is_empty( _slots[slot] ) )
+      {
+        slot = ( slot + 1u ) & _mask;
+      }
+      _slots[slot] = slots[i];
+    }
+  }
+
+private:
+  std::vector<entry> _slots;
+  std::size_t _mask{0u};
+  std::size_t _size{0u};
+};
+
+} /* namespace mockturtle::detail */
@@ -34,6 +34,7 @@
 #pragma once
 
 #include "../traits.hpp"
+#include "../utils/concurrent_truth_table_cache.hpp"
 #include "../utils/truth_table_cache.hpp"
 #include "detail/foreach.hpp"
 #include "events.hpp"
@@ -48,9 +49,22 @@
 namespace mockturtle
 {
 
+/*! \brief k-LUT storage data
+ *
+ * Node functions are stored in `cache`, unless `concurrent_cache` is set when
+ * the storage is passed to a `klut_network`.  The concurrent cache allows
+ * several threads to insert node functions at the same time, e.g.,
+ *
+ * \code{.cpp}
+ * auto storage = std::make_shared<klut_storage>();
+ * storage->data.concurrent_cache = std::make_shared<concurrent_truth_table_cache<kitty::dynamic_truth_table>>();
+ * klut_network klut( storage );
+ * \endcode
+ */
 struct klut_storage_data
 {
   truth_table_cache<kitty::dynamic_truth_table> cache;
+  std::shared_ptr<concurrent_truth_table_cache<kitty::dynamic_truth_table>> concurrent_cache;
   uint32_t trav_id = 0u;
 };
 
@@ -109,17 +123,17 @@ private:
 
     /* reserve some truth tables for nodes */
     kitty::dynamic_truth_table tt_zero( 0 );
-    _storage->data.cache.insert( tt_zero );
+    _insert_function( tt_zero );
 
     static uint64_t _not = 0x1;
     kitty::dynamic_truth_table tt_not( 1 );
     kitty::create_from_words( tt_not, &_not, &_not + 1 );
-    _storage->data.cache.insert( tt_not );
+    _insert_function( tt_not );
 
     static uint64_t _and = 0x8;
     kitty::dynamic_truth_table tt_and( 2 );
     kitty::create_from_words( tt_and, &_and, &_and + 1 );
-    _storage->data.cache.insert( tt_and );
+    _insert_function( tt_and );
 
     /* truth tables for constants */
     _storage->nodes[0].data[1].h1 = 0;
@@ -225,13 +239,13 @@ public:
 
   signal create_node( std::vector<signal> const& children, kitty::dynamic_truth_table const& function )
   {
-    return _create_node( children, _storage->data.cache.insert( function ) );
+    return _create_node( children, _insert_function( function ) );
   }
 
   signal clone_node( klut_network const& other, node const& source, std::vector<signal> const& children )
   {
     assert( !children.empty() );
-    const auto tt = other._storage->data.cache[other._storage->nodes[source].data[1].h1];
+    const auto tt = other._function( other._storage->nodes[source].data[1].h1 );
     return create_node( children, tt );
   }
 #pragma endregion
@@ -314,7 +328,7 @@ public:
 #pragma region Functional properties
   kitty::dynamic_truth_table node_function( const node& n ) const
   {
-    return _storage->data.cache[_storage->nodes[n].data[1].h1];
+    return _function( _storage->nodes[n].data[1].h1 );
   }
 #pragma endregion
 
@@ -399,7 +413,7 @@ public:
       index <<= 1;
       index ^= *begin++ ? 1 : 0;
     }
-    return kitty::get_bit( _storage->data.cache[_storage->nodes[n].data[1].h1], index );
+    return kitty::get_bit( _function( _storage->nodes[n].data[1].h1 ), index );
   }
 
   template<typename Iterator>
@@ -414,7 +428,7 @@ public:
 
     /* resulting truth table has the same size as any of the children */
     auto result = tts.front().construct();
-    const auto gate_tt = _storage->data.cache[_storage->nodes[n].data[1].h1];
+    const auto gate_tt = _function( _storage->nodes[n].data[1].h1 );
 
     for ( auto i = 0u; i < result.num_bits(); ++i )
     {
@@ -494,6 +508,17 @@ public:
   }
 #pragma endregion
 
+private:
+  uint32_t _insert_function( kitty::dynamic_truth_table const& function )
+  {
+    return _storage->data.concurrent_cache ? _storage->data.concurrent_cache->insert( function ) : _storage->data.cache.insert( function );
+  }
+
+  kitty::dynamic_truth_table _function( uint32_t literal ) const
+  {
+    return _storage->data.concurrent_cache ? ( *_storage->data.concurrent_cache )[literal] : _storage->data.cache[literal];
+  }
+
 public:
   std::shared_ptr<klut_storage> _storage;
   std::shared_ptr<network_events<base_type>> _events;
@@ -35,11 +35,14 @@
 
 #include <array>
 #include <iostream>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 #include <sparsepp/spp.h>
 
+#include "detail/strash_table.hpp"
+
 namespace mockturtle
 {
 
@@ -180,6 +183,28 @@ struct empty_storage_data
 {
 };
 
+namespace detail
+{
+
+/*! \brief Container for structural hashing
+ *
+ * Nodes with a fixed number of complementable children are hashed with the
+ * open-addressing `strash_table`, all other nodes with a sparse hash map.
+ */
+template<typename Node, typename NodeHasher>
+struct storage_hash_map
+{
+  using type = spp::sparse_hash_map<Node, uint64_t, NodeHasher>;
+};
+
+template<int Fanin, int Size, typename NodeHasher>
+struct storage_hash_map<regular_node<Fanin, Size, 1>, NodeHasher>
+{
+  using type = strash_table<Fanin>;
+};
+
+} /* namespace detail */
+
 template<typename Node, typename T = empty_storage_data, typename NodeHasher = node_hash<Node>>
 struct storage
 {
@@ -187,19 +212,23 @@ struct storage
   {
     nodes.reserve( 10000u );
     hash.reserve( 10000u );
-    hash.set_resizing_parameters( .4f, .95f );
+    if constexpr ( std::is_same_v<hash_map_type, spp::sparse_hash_map<Node, uint64_t, NodeHasher>> )
+    {
+      hash.set_resizing_parameters( .4f, .95f );
+    }
 
     /* we generally reserve the first node for a constant */
     nodes.emplace_back();
   }
 
   using node_type = Node;
+  using hash_map_type = typename detail::storage_hash_map<Node, NodeHasher>::type;
 
   std::vector<node_type> nodes;
   std::vector<uint64_t> inputs;
   std::vector<typename node_type::pointer_type> outputs;
 
-  spp::sparse_hash_map<node_type, uint64_t, NodeHasher> hash;
+  hash_map_type hash;
 
   T data;
 };
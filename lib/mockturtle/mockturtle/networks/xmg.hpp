@@ -278,7 +278,6 @@ public:
     if ( index >= .9 * _storage->nodes.capacity() )
     {
       _storage->nodes.reserve( static_cast<size_t>( 3.1415 * index ) );
-      _storage->hash.reserve( static_cast<size_t>( 3.1415 * index ) );
     }
 
     _storage->nodes.push_back( node );
@@ -349,7 +348,6 @@ public:
     if ( index >= .9 * _storage->nodes.capacity() )
     {
       _storage->nodes.reserve( static_cast<size_t>( 3.1415 * index ) );
-      _storage->hash.reserve( static_cast<size_t>( 3.1415 * index ) );
     }
 
     _storage->nodes.push_back( node );
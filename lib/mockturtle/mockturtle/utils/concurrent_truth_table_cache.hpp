@@ -0,0 +1,208 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file concurrent_truth_table_cache.hpp
+  \brief Thread-safe truth table cache
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <kitty/hash.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/operators.hpp>
+
+namespace mockturtle
+{
+
+/*! \brief Thread-safe truth table cache.
+ *
+ * This cache has the same interface and the same literal convention as
+ * `truth_table_cache`, but `insert` and `operator[]` can be called
+ * concurrently from several threads.
+ *
+ * The index of a truth table is split into lock-striped shards, each being a
+ * hash map protected by its own mutex, such that threads only contend if they
+ * insert truth tables that hash into the same shard.  The truth tables are
+ * stored in segments of geometrically growing size that are never moved.
+ * Hence, a literal returned by `insert` stays valid, and `operator[]` reads
+ * without locking.
+ *
+ * A literal may only be passed to `operator[]` by a thread that obtained it
+ * from `insert`, or that synchronized with such a thread.
+ */
+template<typename TT>
+class concurrent_truth_table_cache
+{
+public:
+  /*! \brief Creates a truth table cache and reserves memory.
+   *
+   * \param capacity Expected number of truth tables
+   * \param num_shards Number of lock stripes (rounded up to a power of 2)
+   */
+  explicit concurrent_truth_table_cache( uint32_t capacity = 1000u, uint32_t num_shards = 64u )
+      : _shards( std::size_t( 1 ) << shard_bits( num_shards ) ),
+        _shard_shift( 64u - shard_bits( num_shards ) )
+  {
+    for ( auto& s : _shards )
+    {
+      s.indexes.reserve( capacity / _shards.size() + 1u );
+    }
+    for ( auto& segment : _segments )
+    {
+      segment.store( nullptr, std::memory_order_relaxed );
+    }
+  }
+
+  ~concurrent_truth_table_cache()
+  {
+    for ( auto& segment : _segments )
+    {
+      delete[] segment.load( std::memory_order_relaxed );
+    }
+  }
+
+  concurrent_truth_table_cache( concurrent_truth_table_cache const& ) = delete;
+  concurrent_truth_table_cache& operator=( concurrent_truth_table_cache const& ) = delete;
+
+  /*! \brief Inserts a truth table and returns a literal.
+   *
+   * See `truth_table_cache::insert`.
+   *
+   * \param tt Truth table to insert
+   * \return Literal of position in cache
+   */
+  uint32_t insert( TT tt )
+  {
+    uint32_t is_compl{0};
+
+    if ( kitty::get_bit( tt, 0 ) )
+    {
+      is_compl = 1;
+      tt = ~tt;
+    }
+
+    const auto hash = static_cast<uint64_t>( kitty::hash<TT>()( tt ) );
+    auto& s = _shards[_shard_shift == 64u ? 0u : ( hash * UINT64_C( 0x9e3779b97f4a7c15 ) ) >> _shard_shift];
+
+    std::lock_guard<std::mutex> lock( s.mutex );
+
+    /* is truth table already in cache? */
+    if ( const auto it = s.indexes.find( tt ); it != s.indexes.end() )
+    {
+      return 2 * it->second + is_compl;
+    }
+
+    /* add truth table to the next free slot */
+    const auto index = _size.fetch_add( 1u, std::memory_order_relaxed );
+    allocate_entry( index ) = tt;
+    s.indexes.emplace( tt, index );
+    return 2 * index + is_compl;
+  }
+
+  /*! \brief Returns truth table for a given literal. */
+  TT operator[]( uint32_t lit ) const
+  {
+    auto const& tt = entry( lit >> 1 );
+    return ( lit & 1 ) ? ~tt : tt;
+  }
+
+  /*! \brief Returns number of normalized truth tables in the cache. */
+  auto size() const { return _size.load( std::memory_order_relaxed ); }
+
+private:
+  static constexpr uint32_t first_segment_bits = 10u;
+
+  static uint32_t shard_bits( uint32_t num_shards )
+  {
+    auto bits = 0u;
+    while ( ( 1u << bits ) < num_shards )
+    {
+      ++bits;
+    }
+    return bits;
+  }
+
+  /* segment `s` holds `2^(first_segment_bits + s)` entries */
+  static std::pair<uint32_t, uint64_t> locate( uint32_t index )
+  {
+    const auto position = static_cast<uint64_t>( index ) + ( UINT64_C( 1 ) << first_segment_bits );
+    auto msb = 63u;
+    while ( ( ( position >> msb ) & 1 ) == 0 )
+    {
+      --msb;
+    }
+    return {msb - first_segment_bits, position - ( UINT64_C( 1 ) << msb )};
+  }
+
+  TT& allocate_entry( uint32_t index )
+  {
+    const auto [segment, offset] = locate( index );
+
+    auto* data = _segments[segment].load( std::memory_order_acquire );
+    if ( data == nullptr )
+    {
+      auto* fresh = new TT[UINT64_C( 1 ) << ( segment + first_segment_bits )];
+      if ( _segments[segment].compare_exchange_strong( data, fresh, std::memory_order_acq_rel ) )
+      {
+        data = fresh;
+      }
+      else
+      {
+        delete[] fresh;
+      }
+    }
+    return data[offset];
+  }
+
+  TT const& entry( uint32_t index ) const
+  {
+    const auto [segment, offset] = locate( index );
+    return _segments[segment].load( std::memory_order_acquire )[offset];
+  }
+
+  struct alignas( 64 ) shard
+  {
+    std::mutex mutex;
+    std::unordered_map<TT, uint32_t, kitty::hash<TT>> indexes;
+  };
+
+  std::vector<shard> _shards;
+  uint32_t _shard_shift;
+  std::array<std::atomic<TT*>, 32u - first_segment_bits + 1u> _segments;
+  std::atomic<uint32_t> _size{0u};
+};
+
+} /* namespace mockturtle */
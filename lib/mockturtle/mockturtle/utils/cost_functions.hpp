@@ -0,0 +1,59 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file cost_functions.hpp
+  \brief Node cost functions
+
+  \author Mathias Soeken
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "../traits.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief Multiplicative complexity cost.
+ *
+ * Assigns cost 1 to AND gates and cost 0 to all other nodes.  This cost
+ * function can be passed to ``cut_rewriting`` to minimize the number of AND
+ * gates in XAGs, which corresponds to the T-count of the resulting quantum
+ * circuits.
+ */
+template<class Ntk>
+struct mc_cost
+{
+  uint32_t operator()( Ntk const& ntk, node<Ntk> const& n ) const
+  {
+    static_assert( has_is_and_v<Ntk>, "Ntk does not implement the is_and method" );
+    return ntk.is_and( n ) ? 1u : 0u;
+  }
+};
+
+} // namespace mockturtle
@@ -0,0 +1,531 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <kitty/npn.hpp>
+#include <kitty/operations.hpp>
+#include "chain.hpp"
+#include "spec.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PERCY_CHAIN_STORE_MMAP
+#endif
+
+/*******************************************************************************
+    A persistent store of optimum chains. Chains are stored for the NPN
+    representative of a function, together with the fanin, the primitive set,
+    the encoder, and the synthesis method they were computed with. A lookup
+    for a function in the same NPN class returns the stored chain with the
+    input permutation and input and output negations applied.
+
+    The store is an append-only binary file. It is memory-mapped when opened
+    (on POSIX systems), and new chains are appended to it with a single
+    write. Several processes can therefore read the same store while others
+    append to it. Chains appended by other processes become visible after
+    reopening the store. A file that is not a chain store, or that ends
+    with an incomplete or malformed record, is only read up to that point
+    and never appended to.
+*******************************************************************************/
+namespace percy
+{
+    /// Derives a chain with transformed inputs and output. Input i of `c`
+    /// is replaced by input `input_map[i] >> 1` of the result, which is
+    /// complemented if `input_map[i]` is odd. The outputs are complemented
+    /// if `invert_output` is true. Steps whose operators become non-normal
+    /// are complemented and their fanouts are adjusted, such that the
+    /// resulting chain is normal again.
+    inline chain
+    transform_chain(const chain& c, const std::vector<int>& input_map, bool invert_output)
+    {
+        const auto nr_in = c.get_nr_inputs();
+        const auto fanin = c.get_fanin();
+
+        chain result;
+        result.reset(nr_in, c.get_nr_outputs(), c.get_nr_steps(), fanin);
+
+        std::vector<bool> complemented(c.get_nr_steps(), false);
+        std::vector<int> fanins(fanin);
+        for (int i = 0; i < c.get_nr_steps(); i++) {
+            auto op = c.get_operator(i);
+            const auto& step = c.get_step(i);
+            for (int j = 0; j < fanin; j++) {
+                bool negated;
+                if (step[j] < nr_in) {
+                    fanins[j] = input_map[step[j]] >> 1;
+                    negated = input_map[step[j]] & 1;
+                } else {
+                    fanins[j] = step[j];
+                    negated = complemented[step[j] - nr_in];
+                }
+                if (negated) {
+                    kitty::flip_inplace(op, j);
+                }
+            }
+            if (kitty::get_bit(op, 0)) {
+                op = ~op;
+                complemented[i] = true;
+            }
+            result.set_step(i, fanins, op);
+        }
+
+        for (int h = 0; h < c.get_nr_outputs(); h++) {
+            const auto lit = c.get_outputs()[h];
+            auto var = lit >> 1;
+            auto invert = (lit & 1) ^ static_cast<int>(invert_output);
+            if (var >= 1 && var <= nr_in) {
+                invert ^= input_map[var - 1] & 1;
+                var = (input_map[var - 1] >> 1) + 1;
+            } else if (var > nr_in) {
+                invert ^= static_cast<int>(complemented[var - nr_in - 1]);
+            }
+            result.set_output(h, (var << 1) | invert);
+        }
+
+        return result;
+    }
+
+    class chain_store
+    {
+    private:
+        static constexpr char magic[8] = {'P', 'C', 'Y', 'S', 'T', 'O', 'R', '1'};
+        static constexpr int max_nr_in = 6;
+
+        struct record
+        {
+            const unsigned char* data;
+            uint32_t size;
+        };
+
+        std::string filename;
+        bool read_only = false; ///< The file is not a well-formed store
+        int fd = -1;
+        const unsigned char* mapping = nullptr;
+        std::size_t mapping_size = 0;
+        std::vector<unsigned char> buffer; ///< file contents without mmap
+        std::deque<std::string> local;     ///< chains inserted by this process
+        std::unordered_map<std::string, record> index;
+        mutable std::mutex mutex;
+        uint64_t nr_hits = 0;
+        uint64_t nr_misses = 0;
+
+        /// Input i of the representative corresponds to input
+        /// `input_map[i] >> 1` of the function (complemented if odd).
+        static std::vector<int>
+        input_map_from_config(int nr_in, uint32_t phase, std::vector<uint8_t> perm)
+        {
+            /* replay kitty::create_from_npn_config on the input literals */
+            std::vector<int> lits(nr_in);
+            for (int i = 0; i < nr_in; i++) {
+                lits[i] = 2 * i;
+            }
+            for (int i = 0; i < nr_in; i++) {
+                if (perm[i] == i) {
+                    continue;
+                }
+                int k = i;
+                while (perm[k] != i) {
+                    ++k;
+                }
+                for (auto& lit : lits) {
+                    if ((lit >> 1) == i) {
+                        lit = 2 * k + (lit & 1);
+                    } else if ((lit >> 1) == k) {
+                        lit = 2 * i + (lit & 1);
+                    }
+                }
+                std::swap(perm[i], perm[k]);
+            }
+            for (auto& lit : lits) {
+                lit ^= (phase >> (lit >> 1)) & 1;
+            }
+            return lits;
+        }
+
+        static bool
+        cacheable(const spec& spec)
+        {
+            return spec.get_nr_out() == 1 && !spec.has_dc_mask(0) &&
+                spec[0].num_vars() >= 1 && spec[0].num_vars() <= max_nr_in &&
+                spec.fanin <= max_nr_in;
+        }
+
+        /// True if complementing an input of a primitive gives a
+        /// primitive again (up to normalization). Otherwise, the operators
+        /// of a transformed chain depend on which inputs are complemented.
+        static bool
+        closed_under_input_negation(const spec& spec)
+        {
+            const auto& primitives = spec.get_compiled_primitives();
+            for (const auto& primitive : primitives) {
+                for (auto j = 0; j < primitive.num_vars(); j++) {
+                    auto flipped = kitty::flip(primitive, j);
+                    if (kitty::get_bit(flipped, 0)) {
+                        flipped = ~flipped;
+                    }
+                    if (std::find(primitives.begin(), primitives.end(), flipped) == primitives.end()) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /// The key contains the NPN representative and, for primitive
+        /// sets that are not closed under input negation, also the
+        /// representative inputs that are complemented in `input_map`.
+        /// Chains for such a primitive set are then only shared between
+        /// functions for which they use the same operators.
+        static std::string
+        make_key(const kitty::dynamic_truth_table& repr, const std::vector<int>& input_map,
+                 const spec& spec, EncoderType enc_type, SynthMethod method)
+        {
+            std::string key;
+            key.push_back(static_cast<char>(repr.num_vars()));
+            key.push_back(static_cast<char>(spec.fanin));
+            key.push_back(static_cast<char>(enc_type));
+            key.push_back(static_cast<char>(method));
+            for (const auto& primitive : spec.get_compiled_primitives()) {
+                append(key, *primitive.cbegin());
+            }
+            append(key, uint64_t(0xffffffffffffffff)); /* separator */
+            for (auto it = repr.cbegin(); it != repr.cend(); ++it) {
+                append(key, *it);
+            }
+            if (spec.is_primitive_set() && !closed_under_input_negation(spec)) {
+                uint32_t negations = 0;
+                for (auto i = 0u; i < input_map.size(); i++) {
+                    negations |= static_cast<uint32_t>(input_map[i] & 1) << i;
+                }
+                append(key, negations);
+            }
+            return key;
+        }
+
+        template<typename T>
+        static void
+        append(std::string& s, T value)
+        {
+            s.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T>
+        static T
+        read(const unsigned char*& p)
+        {
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+            return value;
+        }
+
+        /// Value layout: nr_in, fanin, nr_steps, then for each step its
+        /// fanins and operator, and finally the output literal.
+        static std::string
+        encode_chain(const chain& c)
+        {
+            std::string value;
+            append(value, static_cast<uint16_t>(c.get_nr_inputs()));
+            append(value, static_cast<uint16_t>(c.get_fanin()));
+            append(value, static_cast<uint16_t>(c.get_nr_steps()));
+            for (int i = 0; i < c.get_nr_steps(); i++) {
+                for (auto fanin : c.get_step(i)) {
+                    append(value, static_cast<uint16_t>(fanin));
+                }
+                append(value, *c.get_operator(i).cbegin());
+            }
+            append(value, static_cast<uint32_t>(c.get_outputs()[0]));
+            return value;
+        }
+
+        /// Checks that a value of `size` bytes is a chain as written by
+        /// `encode_chain`, whose steps and output only refer to inputs and
+        /// preceding steps.
+        static bool
+        check_chain(const unsigned char* p, uint32_t size)
+        {
+            if (size < 3 * sizeof(uint16_t)) {
+                return false;
+            }
+            const auto nr_in = read<uint16_t>(p);
+            const auto fanin = read<uint16_t>(p);
+            const auto nr_steps = read<uint16_t>(p);
+            if (nr_in < 1 || nr_in > max_nr_in || fanin < 1 || fanin > max_nr_in ||
+                size != 3 * sizeof(uint16_t) + nr_steps * (fanin * sizeof(uint16_t) + sizeof(uint64_t)) + sizeof(uint32_t)) {
+                return false;
+            }
+            for (int i = 0; i < nr_steps; i++) {
+                for (int j = 0; j < fanin; j++) {
+                    if (read<uint16_t>(p) >= nr_in + i) {
+                        return false;
+                    }
+                }
+                p += sizeof(uint64_t);
+            }
+            return (read<uint32_t>(p) >> 1) <= static_cast<uint32_t>(nr_in + nr_steps);
+        }
+
+        static chain
+        decode_chain(const unsigned char* p)
+        {
+            const auto nr_in = read<uint16_t>(p);
+            const auto fanin = read<uint16_t>(p);
+            const auto nr_steps = read<uint16_t>(p);
+
+            chain c;
+            c.reset(nr_in, 1, nr_steps, fanin);
+            std::vector<int> fanins(fanin);
+            kitty::dynamic_truth_table op(fanin);
+            for (int i = 0; i < nr_steps; i++) {
+                for (auto& f : fanins) {
+                    f = read<uint16_t>(p);
+                }
+                const auto bits = read<uint64_t>(p);
+                kitty::create_from_words(op, &bits, &bits + 1);
+                c.set_step(i, fanins, op);
+            }
+            c.set_output(0, read<uint32_t>(p));
+            return c;
+        }
+
+        /// Derives the chain for the function of `spec` from the chain of
+        /// its NPN representative, and checks that it realizes the
+        /// function with the primitives of `spec`.
+        static bool
+        chain_from_repr(const spec& spec, const chain& repr_chain, const std::vector<int>& input_map,
+                        bool invert_output, chain& c)
+        {
+            c.copy(transform_chain(repr_chain, input_map, invert_output));
+
+            if (c.simulate()[0] != spec[0]) {
+                return false;
+            }
+            if (spec.is_primitive_set()) {
+                const auto& primitives = spec.get_compiled_primitives();
+                for (int i = 0; i < c.get_nr_steps(); i++) {
+                    if (std::find(primitives.begin(), primitives.end(), c.get_operator(i)) == primitives.end()) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /// Indexes the records in [begin, end). Returns false if the data
+        /// is not a chain store or if it ends with an incomplete or
+        /// malformed record, which is ignored together with the rest.
+        bool
+        load(const unsigned char* begin, const unsigned char* end)
+        {
+            if (end - begin < static_cast<std::ptrdiff_t>(sizeof(magic)) ||
+                std::memcmp(begin, magic, sizeof(magic)) != 0) {
+                fprintf(stderr, "Error: %s is not a chain store\n", filename.c_str());
+                return false;
+            }
+
+            auto p = begin + sizeof(magic);
+            while (p != end) {
+                auto q = p;
+                if (end - q < 8) {
+                    break;
+                }
+                const auto key_size = read<uint32_t>(q);
+                const auto value_size = read<uint32_t>(q);
+                if (static_cast<std::size_t>(end - q) < std::size_t(key_size) + value_size ||
+                    !check_chain(q + key_size, value_size)) {
+                    break;
+                }
+                index.emplace(std::string(reinterpret_cast<const char*>(q), key_size),
+                              record{q + key_size, value_size});
+                p = q + key_size + value_size;
+            }
+            if (p != end) {
+                fprintf(stderr, "Error: %s ends with an incomplete or malformed record\n", filename.c_str());
+                return false;
+            }
+            return true;
+        }
+
+    public:
+        /// Opens the store in `filename` and creates it if it does not
+        /// exist. An empty file name creates a store in memory only.
+        explicit chain_store(const std::string& filename) : filename(filename)
+        {
+            if (filename.empty()) {
+                return;
+            }
+
+#ifdef PERCY_CHAIN_STORE_MMAP
+            fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+            if (fd == -1) {
+                fprintf(stderr, "Error: unable to open %s\n", filename.c_str());
+                return;
+            }
+            struct stat st;
+            if (::fstat(fd, &st) == 0 && st.st_size == 0) {
+                if (::write(fd, magic, sizeof(magic)) != static_cast<ssize_t>(sizeof(magic))) {
+                    fprintf(stderr, "Error: unable to write %s\n", filename.c_str());
+                }
+            } else if (st.st_size > 0) {
+                auto* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (data != MAP_FAILED) {
+                    mapping = static_cast<const unsigned char*>(data);
+                    mapping_size = st.st_size;
+                    read_only = !load(mapping, mapping + mapping_size);
+                } else {
+                    read_only = true;
+                }
+            }
+#else
+            std::ifstream in(filename, std::ios::binary);
+            buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            if (buffer.empty()) {
+                std::ofstream(filename, std::ios::binary).write(magic, sizeof(magic));
+            } else {
+                read_only = !load(buffer.data(), buffer.data() + buffer.size());
+            }
+#endif
+        }
+
+        ~chain_store()
+        {
+#ifdef PERCY_CHAIN_STORE_MMAP
+            if (mapping != nullptr) {
+                ::munmap(const_cast<unsigned char*>(mapping), mapping_size);
+            }
+            if (fd != -1) {
+                ::close(fd);
+            }
+#endif
+        }
+
+        chain_store(const chain_store&) = delete;
+        chain_store& operator=(const chain_store&) = delete;
+
+        /// Looks up a chain for the single-output specification `spec`.
+        /// Returns false if no chain is stored for its NPN class, or if
+        /// the transformed chain does not realize it with the primitives
+        /// of `spec`.
+        bool
+        lookup(const spec& spec, chain& c, EncoderType enc_type = ENC_SSV, SynthMethod method = SYNTH_STD)
+        {
+            if (!cacheable(spec)) {
+                return false;
+            }
+
+            const auto& function = spec[0];
+            const auto nr_in = function.num_vars();
+            const auto config = kitty::exact_npn_canonization_signature(function);
+            const auto phase = std::get<1>(config);
+            const auto input_map = input_map_from_config(nr_in, phase, std::get<2>(config));
+            const auto key = make_key(std::get<0>(config), input_map, spec, enc_type, method);
+
+            const auto stored = [&]() -> const unsigned char* {
+                std::lock_guard<std::mutex> lock(mutex);
+                const auto it = index.find(key);
+                return it == index.end() ? nullptr : it->second.data;
+            }();
+
+            chain candidate;
+            const auto found = stored != nullptr && chain_from_repr(spec, decode_chain(stored), input_map, (phase >> nr_in) & 1, candidate);
+            if (found) {
+                c.copy(candidate);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (found) {
+                ++nr_hits;
+            } else {
+                ++nr_misses;
+            }
+            return found;
+        }
+
+        /// Stores the chain `c` that realizes the single-output
+        /// specification `spec`.
+        void
+        insert(const spec& spec, const chain& c, EncoderType enc_type = ENC_SSV, SynthMethod method = SYNTH_STD)
+        {
+            if (!cacheable(spec) || c.get_nr_outputs() != 1 || c.get_nr_inputs() != spec[0].num_vars()) {
+                return;
+            }
+
+            const auto& function = spec[0];
+            const auto nr_in = function.num_vars();
+            const auto config = kitty::exact_npn_canonization_signature(function);
+            const auto phase = std::get<1>(config);
+
+            /* invert the transformation from the representative */
+            const auto from_repr = input_map_from_config(nr_in, phase, std::get<2>(config));
+            std::vector<int> to_repr(nr_in);
+            for (int i = 0; i < nr_in; i++) {
+                to_repr[from_repr[i] >> 1] = 2 * i + (from_repr[i] & 1);
+            }
+            const auto repr_chain = transform_chain(c, to_repr, (phase >> nr_in) & 1);
+            if (repr_chain.simulate()[0] != std::get<0>(config)) {
+                return;
+            }
+
+            const auto key = make_key(std::get<0>(config), from_repr, spec, enc_type, method);
+            const auto value = encode_chain(repr_chain);
+
+            std::string entry;
+            append(entry, static_cast<uint32_t>(key.size()));
+            append(entry, static_cast<uint32_t>(value.size()));
+            entry += key;
+            entry += value;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (index.count(key)) {
+                return;
+            }
+
+#ifdef PERCY_CHAIN_STORE_MMAP
+            if (fd != -1 && !read_only && ::write(fd, entry.data(), entry.size()) != static_cast<ssize_t>(entry.size())) {
+                fprintf(stderr, "Error: unable to write %s\n", filename.c_str());
+            }
+#else
+            if (!filename.empty() && !read_only) {
+                std::ofstream(filename, std::ios::binary | std::ios::app).write(entry.data(), entry.size());
+            }
+#endif
+
+            local.push_back(entry);
+            const auto* data = reinterpret_cast<const unsigned char*>(local.back().data());
+            index.emplace(key, record{data + 8 + key.size(), static_cast<uint32_t>(value.size())});
+        }
+
+        /// Number of stored NPN classes.
+        std::size_t
+        size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return index.size();
+        }
+
+        uint64_t
+        hits() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return nr_hits;
+        }
+
+        uint64_t
+        misses() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return nr_misses;
+        }
+    };
+}
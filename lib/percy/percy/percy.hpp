@@ -15,6 +15,8 @@
 #include "solvers.hpp"
 #include "encoders.hpp"
 #include "cnf.hpp"
+#include "worker_pool.hpp"
+#include "chain_store.hpp"
 #include <limits>
 
 /*******************************************************************************
@@ -86,6 +88,9 @@ namespace percy
 
         spec.nr_steps = spec.initial_steps;
         while (true) {
+            if (spec.is_stopped()) {
+                return timeout;
+            }
             solver.restart();
             if (!encoder.encode(spec)) {
                 spec.nr_steps++;
@@ -156,6 +161,9 @@ namespace percy
         spec.nr_rand_tt_assigns = 2 * spec.get_nr_in();
         spec.nr_steps = spec.initial_steps;
         while (true) {
+            if (spec.is_stopped()) {
+                return timeout;
+            }
             solver.restart();
             if (!encoder.cegar_encode(spec)) {
                 spec.nr_steps++;
@@ -234,6 +242,9 @@ namespace percy
             solver = new satoko_wrapper;
             break;
 #endif
+        case SLV_BMCG:
+            solver = new bmcg_wrapper;
+            break;
         default:
             fprintf(stderr, "Error: solver type %d not found", type);
             exit(1);
@@ -328,6 +339,9 @@ namespace percy
         int old_nnodes = 1;
         auto total_conflicts = 0;
         while (true) {
+            if (spec.is_stopped()) {
+                return timeout;
+            }
             g.next_fence(f);
             spec.nr_steps = f.nr_nodes();
 
@@ -700,12 +714,14 @@ namespace percy
         return failure;
     }
 
+    /// Synthesizes a chain from a set of partial DAGs, ordered by size,
+    /// using the threads of a worker pool.
     inline synth_result
     pd_synthesize_parallel(
         spec& spec, 
         chain& c, 
         const std::vector<partial_dag>& dags,
-        int num_threads = std::thread::hardware_concurrency())
+        pd_worker_pool& pool)
     {
         assert(spec.get_nr_in() >= spec.fanin);
         spec.preprocess();
@@ -721,79 +737,24 @@ namespace percy
             return success;
         }
 
-        std::vector<std::thread> threads(num_threads);
-
-        moodycamel::ConcurrentQueue<partial_dag> q(num_threads * 3);
-
-        bool finished_generating = false;
-        bool* pfinished = &finished_generating;
-        int size_found = PD_SIZE_CONST;
-        int* psize_found = &size_found;
-        std::mutex found_mutex;
-
-        for (int i = 0; i < num_threads; i++) {
-            threads[i] = std::thread([&spec, psize_found, pfinished, &found_mutex, &c, &q] {
-                percy::spec local_spec = spec;
-                bsat_wrapper solver;
-                partial_dag_encoder encoder(solver);
-                partial_dag dag;
-
-                while (*psize_found > local_spec.nr_steps) {
-                    if (!q.try_dequeue(dag)) {
-                        if (*pfinished) {
-                            std::this_thread::yield();
-                            if (!q.try_dequeue(dag)) {
-                                break;
-                            }
-                        } else {
-                            std::this_thread::yield();
-                            continue;
-                        }
-                    }
-                    local_spec.nr_steps = dag.nr_vertices();
-                    synth_result status;
-                    solver.restart();
-                    if (!encoder.encode(local_spec, dag)) {
-                        continue;
-                    }
-                    while (true) {
-                        status = solver.solve(10);
-                        if (status == failure) {
-                            break;
-                        } else if (status == success) {
-                            std::lock_guard<std::mutex> vlock(found_mutex);
-                            if (*psize_found > local_spec.nr_steps) {
-                                encoder.extract_chain(local_spec, dag, c);
-                                *psize_found = local_spec.nr_steps;
-                            }
-                            break;
-                        } else if (*psize_found <= local_spec.nr_steps) {
-                            // Another thread found a solution that's
-                            // better or equal to this one.
-                            break;
-                        }
-
-                    }
-                }
-            });
-        }
-        size_t dag_idx = 0;
-        while (size_found == PD_SIZE_CONST) {
-            while (!q.try_enqueue(dags.at(dag_idx))) {
-                if (size_found == PD_SIZE_CONST) {
-                    std::this_thread::yield();
-                } else {
+        return pool.synthesize(spec, c, [&dags](auto&& push) {
+            for (const auto& dag : dags) {
+                if (!push(dag)) {
                     break;
                 }
             }
-            dag_idx++;
-        }
-        finished_generating = true;
-        for (auto& thread : threads) {
-            thread.join();
-        }
+        });
+    }
 
-        return success;
+    inline synth_result
+    pd_synthesize_parallel(
+        spec& spec, 
+        chain& c, 
+        const std::vector<partial_dag>& dags,
+        int num_threads = std::thread::hardware_concurrency())
+    {
+        pd_worker_pool pool(num_threads);
+        return pd_synthesize_parallel(spec, c, dags, pool);
     }
 
 
@@ -867,12 +828,13 @@ namespace percy
         return failure;
     }
 
-    /// Same as pd_ser_synthesize, but parallel.  
+    /// Same as pd_ser_synthesize, but parallel using the threads of a
+    /// worker pool.
     inline synth_result pd_ser_synthesize_parallel(
         spec& spec,
         chain& c,
-        int num_threads = std::thread::hardware_concurrency(),
-        std::string file_prefix ="")
+        pd_worker_pool& pool,
+        std::string file_prefix = "")
     {
         assert(spec.get_nr_in() >= spec.fanin);
         spec.preprocess();
@@ -888,101 +850,46 @@ namespace percy
             return success;
         }
 
-        std::vector<std::thread> threads(num_threads);
-        moodycamel::ConcurrentQueue<partial_dag> q(num_threads * 3);
-        bool finished_generating = false;
-        bool* pfinished = &finished_generating;
-        int size_found = PD_SIZE_CONST;
-        int* psize_found = &size_found;
-        std::mutex found_mutex;
-
-        for (int i = 0; i < num_threads; i++) {
-            threads[i] = std::thread([&spec, psize_found, pfinished, &found_mutex, &c, &q] {
-                percy::spec local_spec = spec;
-                bsat_wrapper solver;
-                partial_dag_encoder encoder(solver);
-                partial_dag dag;
-
-                while (*psize_found > local_spec.nr_steps) {
-                    if (!q.try_dequeue(dag)) {
-                        if (*pfinished) {
-                            std::this_thread::yield();
-                            if (!q.try_dequeue(dag)) {
-                                break;
-                            }
-                        } else {
-                            std::this_thread::yield();
-                            continue;
-                        }
-                    }
-                    local_spec.nr_steps = dag.nr_vertices();
-                    synth_result status;
-                    solver.restart();
-                    if (!encoder.encode(local_spec, dag)) {
-                        continue;
-                    }
-                    while (true) {
-                        status = solver.solve(10);
-                        if (status == failure) {
-                            break;
-                        } else if (status == success) {
-                            std::lock_guard<std::mutex> vlock(found_mutex);
-                            if (*psize_found > local_spec.nr_steps) {
-                                encoder.extract_chain(local_spec, dag, c);
-                                *psize_found = local_spec.nr_steps;
-                            }
-                            break;
-                        } else if (*psize_found <= local_spec.nr_steps) {
-                            // Another thread found a solution that's
-                            // better or equal to this one.
-                            break;
-                        }
-                    }
+        const auto initial_steps = spec.initial_steps;
+        return pool.synthesize(spec, c, [&file_prefix, initial_steps](auto&& push) {
+            partial_dag g;
+            for (auto nr_steps = initial_steps; ; nr_steps++) {
+                g.reset(2, nr_steps);
+                const auto filename = file_prefix + "pd" + std::to_string(nr_steps) + ".bin";
+                auto fhandle = fopen(filename.c_str(), "rb");
+                if (fhandle == NULL) {
+                    fprintf(stderr, "Error: unable to open PD file\n");
+                    return;
                 }
-            });
-        }
 
-        partial_dag g;
-        spec.nr_steps = spec.initial_steps;
-        while (size_found == PD_SIZE_CONST) {
-            g.reset(2, spec.nr_steps);
-            const auto filename = file_prefix + "pd" + std::to_string(spec.nr_steps) + ".bin";
-            auto fhandle = fopen(filename.c_str(), "rb");
-            if (fhandle == NULL) {
-                fprintf(stderr, "Error: unable to open PD file\n");
-                break;
-            }
-
-            int buf;
-            while (fread(&buf, sizeof(int), 1, fhandle) != 0) {
-                for (int i = 0; i < spec.nr_steps; i++) {
-                    (void)fread(&buf, sizeof(int), 1, fhandle);
-                    auto fanin1 = buf;
-                    (void)fread(&buf, sizeof(int), 1, fhandle);
-                    auto fanin2 = buf;
-                    g.set_vertex(i, fanin1, fanin2);
-                }
-                while (!q.try_enqueue(g)) {
-                    if (size_found == PD_SIZE_CONST) {
-                        std::this_thread::yield();
-                    } else {
-                        break;
+                int buf;
+                while (fread(&buf, sizeof(int), 1, fhandle) != 0) {
+                    for (int i = 0; i < nr_steps; i++) {
+                        (void)fread(&buf, sizeof(int), 1, fhandle);
+                        auto fanin1 = buf;
+                        (void)fread(&buf, sizeof(int), 1, fhandle);
+                        auto fanin2 = buf;
+                        g.set_vertex(i, fanin1, fanin2);
+                    }
+                    if (!push(g)) {
+                        fclose(fhandle);
+                        return;
                     }
                 }
-                if (size_found != PD_SIZE_CONST) {
-                    break;
-                }
+                fclose(fhandle);
             }
-            fclose(fhandle);
-            spec.nr_steps++;
-        }
-        finished_generating = true;
-        for (auto& thread : threads) {
-            thread.join();
-        }
-        spec.nr_steps = size_found;
+        });
+    }
 
-        return size_found == PD_SIZE_CONST ? failure : success;
+    /// Same as pd_ser_synthesize, but parallel.  
+    inline synth_result pd_ser_synthesize_parallel(
+        spec& spec,
+        chain& c,
+        int num_threads = std::thread::hardware_concurrency(),
+        std::string file_prefix ="")
+    {
+        pd_worker_pool pool(num_threads);
+        return pd_ser_synthesize_parallel(spec, c, pool, file_prefix);
     }
             
     inline synth_result
@@ -1100,10 +1007,32 @@ namespace percy
         SynthMethod method = SYNTH_STD)
     {
         auto solver = get_solver(slv_type);
+        solver->set_stop(spec.stop);
         auto encoder = get_encoder(*solver, enc_type);
         return synthesize(spec, chain, *solver, *encoder, method);
     }
 
+    /// Same as synthesize, but looks up the chain in a chain store first,
+    /// and adds newly synthesized chains to it.
+    inline synth_result
+    synthesize(
+        spec& spec, 
+        chain& chain, 
+        chain_store& store,
+        SolverType slv_type = SLV_BSAT2, 
+        EncoderType enc_type = ENC_SSV, 
+        SynthMethod method = SYNTH_STD)
+    {
+        if (store.lookup(spec, chain, enc_type, method)) {
+            return success;
+        }
+        const auto result = synthesize(spec, chain, slv_type, enc_type, method);
+        if (result == success) {
+            store.insert(spec, chain, enc_type, method);
+        }
+        return result;
+    }
+
     inline synth_result
     next_solution(
         spec& spec, 
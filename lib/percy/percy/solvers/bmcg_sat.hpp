@@ -2,6 +2,9 @@
 
 #include "solver_wrapper.hpp"
 
+#include <algorithm>
+#include <vector>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wall"
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -11,13 +14,92 @@
 
 namespace percy
 {
+    /***************************************************************************
+        Wrapper around ABC's Glucose (SimpSolver in incremental mode).
+
+        With preprocessing enabled, bounded variable elimination and
+        subsumption are run on the clauses added since the last call before
+        every solve.  Assumption variables are frozen, so that incremental
+        encodings which extend the formula over the previously assumed
+        variables (e.g., one time step at a time) keep the benefit of
+        preprocessing.  Values of eliminated variables are recovered by
+        model extension.  If a clause or an assumption refers to a
+        variable that has already been eliminated, the solver is rebuilt
+        from a log of the original clauses and preprocessing is switched
+        off for the rest of the instance.
+    ***************************************************************************/
     class bmcg_wrapper : public solver_wrapper
     {
     private:
         pabc::bmcg_sat_solver * solver = NULL;
+        bool preprocess = true;
+        bool simplify = true;
+        bool eliminated = false;
+        std::vector<int> clause_log;
+        int* pstop = NULL;
+
+        void rebuild()
+        {
+            const auto nr_vars = pabc::bmcg_sat_solver_varnum(solver);
+            pabc::bmcg_sat_solver_stop(solver);
+            solver = pabc::bmcg_sat_solver_start();
+            pabc::bmcg_sat_solver_set_stop(solver, pstop);
+            pabc::bmcg_sat_solver_set_nvars(solver, nr_vars);
+            for (auto i = 0u; i < clause_log.size(); i += clause_log[i] + 1) {
+                pabc::bmcg_sat_solver_addclause(solver, &clause_log[i + 1], clause_log[i]);
+            }
+            simplify = false;
+            eliminated = false;
+        }
+
+        bool is_eliminated(pabc::lit* begin, pabc::lit* end)
+        {
+            if (!eliminated) {
+                return false;
+            }
+            for (auto it = begin; it != end; ++it) {
+                const auto var = pabc::Abc_Lit2Var(*it);
+                if (var < pabc::bmcg_sat_solver_varnum(solver) &&
+                        pabc::bmcg_sat_solver_var_is_elim(solver, var)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        synth_result solve_assumptions(pabc::lit* begin, pabc::lit* end, int cl)
+        {
+            if (simplify) {
+                if (is_eliminated(begin, end)) {
+                    rebuild();
+                } else {
+                    for (auto it = begin; it != end; ++it) {
+                        const auto var = pabc::Abc_Lit2Var(*it);
+                        pabc::bmcg_sat_solver_set_nvars(solver,
+                                std::max(var + 1, pabc::bmcg_sat_solver_varnum(solver)));
+                        pabc::bmcg_sat_solver_var_set_frozen(solver, var, 1);
+                    }
+                    if (!pabc::bmcg_sat_solver_eliminate(solver, 0)) {
+                        return failure;
+                    }
+                    eliminated = true;
+                }
+            }
+
+            pabc::bmcg_sat_solver_set_conflict_budget(solver, cl);
+            auto res = pabc::bmcg_sat_solver_solve(solver, begin, end - begin);
+            if (res == 1) {
+                return success;
+            } else if (res == -1) {
+                return failure;
+            } else {
+                return timeout;
+            }
+        }
 
     public:
-        bmcg_wrapper()
+        bmcg_wrapper(bool preprocess = true) :
+            preprocess(preprocess), simplify(preprocess)
         {
             solver = pabc::bmcg_sat_solver_start();
         }
@@ -30,7 +112,12 @@ namespace percy
 
         void restart()
         {
-            pabc::bmcg_sat_solver_reset(solver);
+            pabc::bmcg_sat_solver_stop(solver);
+            solver = pabc::bmcg_sat_solver_start();
+            pabc::bmcg_sat_solver_set_stop(solver, pstop);
+            simplify = preprocess;
+            eliminated = false;
+            clause_log.clear();
         }
 
         void set_nr_vars(int nr_vars)
@@ -40,8 +127,7 @@ namespace percy
 
         int nr_vars()
         {
-            // Not currently supported
-            return -1;
+            return pabc::bmcg_sat_solver_varnum(solver);
         }
 
         int nr_clauses()
@@ -56,6 +142,13 @@ namespace percy
 
         int add_clause(pabc::lit* begin, pabc::lit* end)
         {
+            if (simplify) {
+                if (is_eliminated(begin, end)) {
+                    rebuild();
+                }
+                clause_log.push_back(static_cast<int>(end - begin));
+                clause_log.insert(clause_log.end(), begin, end);
+            }
             return pabc::bmcg_sat_solver_addclause(solver, begin, end - begin);
         }
 
@@ -71,28 +164,20 @@ namespace percy
 
         synth_result solve(int cl)
         {
-            pabc::bmcg_sat_solver_set_conflict_budget(solver, cl);
-            auto res = pabc::bmcg_sat_solver_solve(solver, 0, 0);
-            if (res == 1) {
-                return success;
-            } else if (res == -1) {
-                return failure;
-            } else {
-                return timeout;
-            }
+            return solve_assumptions(nullptr, nullptr, cl);
+        }
+
+        /// Makes solve() return timeout as soon as *pstop becomes non-zero.
+        /// The flag is checked at restarts and kept when the solver is rebuilt.
+        void set_stop(int* pstop)
+        {
+            this->pstop = pstop;
+            pabc::bmcg_sat_solver_set_stop(solver, pstop);
         }
 
         synth_result solve(pabc::lit* begin, pabc::lit* end, int cl)
         {
-            pabc::bmcg_sat_solver_set_conflict_budget(solver, cl);
-            auto res = pabc::bmcg_sat_solver_solve(solver, begin, end - begin);
-            if (res == 1) {
-                return success;
-            } else if (res == -1) {
-                return failure;
-            } else {
-                return timeout;
-            }
+            return solve_assumptions(begin, end, cl);
         }
 
     };
@@ -135,5 +135,12 @@ namespace percy
             solver_init_activities(solver);
         }
 
+        /// Makes solve() return timeout as soon as *pstop becomes non-zero.
+        /// The flag may be set from another thread.
+        void set_stop(int* pstop)
+        {
+            pabc::sat_solver_set_stop(solver, pstop);
+        }
+
     };
 }
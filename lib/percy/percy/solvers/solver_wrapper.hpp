@@ -35,6 +35,13 @@ namespace percy
         virtual int  var_value(int var) = 0;
         virtual synth_result solve(int conflict_limit = 0) = 0;
         virtual synth_result solve(pabc::lit* begin, pabc::lit* end, int conflict_limit = 0) = 0;
+
+        /// Makes solve() return timeout as soon as *pstop becomes non-zero.
+        /// Solvers without support for a stop flag ignore it.
+        virtual void set_stop(int* pstop)
+        {
+            (void)pstop;
+        }
     };
 	
 }
@@ -61,6 +61,7 @@ namespace percy
         SLV_CMSAT,
         SLV_GLUCOSE,
         SLV_SATOKO,
+        SLV_BMCG,
         SLV_TOTAL,
     };
 
@@ -70,6 +71,7 @@ namespace percy
         "SLV_CMSAT",
         "SLV_GLUCOSE",
         "SLV_SATOKO",
+        "SLV_BMCG",
     };
 
     enum Primitive
@@ -125,6 +127,20 @@ namespace percy
 
             /// Limit on the number of SAT conflicts. Zero means no limit.
             int conflict_limit = 0;
+
+            /// Synthesis returns timeout as soon as *stop becomes non-zero.
+            /// The flag may be set from another thread. Null means no flag.
+            int* stop = nullptr;
+
+            /// Returns true if the stop flag has been raised.
+            bool is_stopped() const
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                return stop && __atomic_load_n(stop, __ATOMIC_RELAXED);
+#else
+                return stop && *(volatile int*)stop;
+#endif
+            }
             
             /// Constructs a spec with one output
             spec()
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "spec.hpp"
+#include "chain.hpp"
+#include "partial_dag.hpp"
+#include "solvers.hpp"
+#include "encoders.hpp"
+
+/*******************************************************************************
+    A pool of worker threads that synthesize chains from partial DAGs in
+    parallel. The threads, their SAT solvers, and their encoders persist
+    across synthesis calls. Idle workers block on a condition variable
+    instead of spinning. As soon as a chain is found, workers that solve
+    instances of the same or a larger size are stopped from within the SAT
+    solver's search loop. The same mechanism is used to cancel a running
+    synthesis call from another thread.
+*******************************************************************************/
+namespace percy
+{
+    class pd_worker_pool
+    {
+    private:
+        struct worker
+        {
+            std::thread thread;
+            bsat_wrapper solver;
+            partial_dag_encoder encoder;
+            spec local_spec;
+            uint64_t job = 0;
+            std::atomic<int> nr_steps{no_size};
+
+            worker() : encoder(solver)
+            {
+                solver.set_stop(&stop);
+            }
+
+            /// Sets the stop flag that the SAT solver polls. The flag is a
+            /// plain int, as the solver expects, that is only accessed with
+            /// atomic builtins.
+            void set_stop(int value)
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                __atomic_store_n(&stop, value, __ATOMIC_SEQ_CST);
+#else
+                *static_cast<volatile int*>(&stop) = value;
+#endif
+            }
+
+        private:
+            int stop = 0;
+        };
+
+        static constexpr int no_size = std::numeric_limits<int>::max();
+
+        std::vector<std::unique_ptr<worker>> workers;
+        std::deque<partial_dag> queue;
+        std::size_t queue_capacity;
+
+        std::mutex mutex;
+        std::condition_variable work_cv;  ///< Signals new DAGs or shutdown
+        std::condition_variable space_cv; ///< Signals free queue slots or a result
+        std::condition_variable done_cv;  ///< Signals that all workers are idle
+
+        /// State of the current synthesis call
+        const spec* job_spec = nullptr;
+        chain* job_chain = nullptr;
+        uint64_t job = 0;
+        int active = 0;
+        bool shutdown = false;
+        std::atomic<int> size_found{no_size};
+        std::atomic<bool> cancelled{false};
+        std::mutex run_mutex;
+
+        void work(worker& w)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                work_cv.wait(lock, [this] { return shutdown || !queue.empty(); });
+                if (shutdown) {
+                    return;
+                }
+
+                auto dag = std::move(queue.front());
+                queue.pop_front();
+                ++active;
+                if (w.job != job) {
+                    w.local_spec = *job_spec;
+                    w.job = job;
+                }
+                space_cv.notify_one();
+                lock.unlock();
+
+                solve(w, dag);
+
+                lock.lock();
+                if (--active == 0 && queue.empty()) {
+                    done_cv.notify_all();
+                }
+            }
+        }
+
+        void solve(worker& w, const partial_dag& dag)
+        {
+            const auto nr_steps = dag.nr_vertices();
+
+            /* publish the size before checking for results, such that a
+               concurrent call to found() either raises the stop flag or is
+               seen here */
+            w.nr_steps = nr_steps;
+            w.set_stop(0);
+            if (cancelled || size_found <= nr_steps) {
+                return;
+            }
+
+            w.local_spec.nr_steps = nr_steps;
+            w.solver.restart();
+            if (!w.encoder.encode(w.local_spec, dag)) {
+                return;
+            }
+            if (w.solver.solve(0) == success) {
+                found(w, dag);
+            }
+        }
+
+        void found(worker& w, const partial_dag& dag)
+        {
+            const auto nr_steps = dag.nr_vertices();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (size_found <= nr_steps) {
+                    return;
+                }
+                w.encoder.extract_chain(w.local_spec, dag, *job_chain);
+                size_found = nr_steps;
+            }
+
+            /* stop workers that cannot find a smaller chain anymore */
+            for (auto& other : workers) {
+                if (other->nr_steps >= nr_steps) {
+                    other->set_stop(1);
+                }
+            }
+            space_cv.notify_all();
+        }
+
+    public:
+        explicit pd_worker_pool(int num_threads = std::thread::hardware_concurrency())
+        {
+            if (num_threads < 1) {
+                num_threads = 1;
+            }
+            queue_capacity = 3 * num_threads;
+            for (int i = 0; i < num_threads; i++) {
+                workers.emplace_back(new worker());
+            }
+            for (auto& w : workers) {
+                auto& wr = *w;
+                w->thread = std::thread([this, &wr] { work(wr); });
+            }
+        }
+
+        ~pd_worker_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                shutdown = true;
+            }
+            cancel();
+            work_cv.notify_all();
+            for (auto& w : workers) {
+                w->thread.join();
+            }
+        }
+
+        pd_worker_pool(const pd_worker_pool&) = delete;
+        pd_worker_pool& operator=(const pd_worker_pool&) = delete;
+
+        int nr_threads() const
+        {
+            return static_cast<int>(workers.size());
+        }
+
+        /// Cancels the running synthesis call. Safe to call from any thread.
+        void cancel()
+        {
+            cancelled = true;
+            for (auto& w : workers) {
+                w->set_stop(1);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            space_cv.notify_all();
+        }
+
+        /// Synthesizes a chain for a preprocessed specification.
+        ///
+        /// The generator is called on the calling thread with a function
+        /// `push(const partial_dag&)` that enqueues a DAG. It blocks while
+        /// the queue is full and returns false once the remaining DAGs can
+        /// be skipped, i.e., after a chain was found or the call was
+        /// cancelled. DAGs should be generated in order of increasing size.
+        ///
+        /// On success, the smallest chain found is stored in `c` and its
+        /// size in `spec.nr_steps`. Returns timeout if the call was
+        /// cancelled before any chain was found. Calls are serialized.
+        template<class Generator>
+        synth_result synthesize(spec& spec, chain& c, Generator&& generate)
+        {
+            std::lock_guard<std::mutex> run_lock(run_mutex);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job_spec = &spec;
+                job_chain = &c;
+                ++job;
+                size_found = no_size;
+                cancelled = false;
+            }
+
+            generate([this](const partial_dag& dag) {
+                std::unique_lock<std::mutex> lock(mutex);
+                space_cv.wait(lock, [this] {
+                    return queue.size() < queue_capacity || cancelled || size_found != no_size;
+                });
+                if (cancelled || size_found != no_size) {
+                    return false;
+                }
+                queue.push_back(dag);
+                work_cv.notify_one();
+                return true;
+            });
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                done_cv.wait(lock, [this] { return active == 0 && queue.empty(); });
+                job_spec = nullptr;
+                job_chain = nullptr;
+            }
+
+            if (size_found != no_size) {
+                spec.nr_steps = size_found;
+                return success;
+            }
+            return cancelled ? timeout : failure;
+        }
+    };
+}
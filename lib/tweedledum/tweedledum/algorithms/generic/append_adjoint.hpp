@@ -0,0 +1,93 @@
+/*--------------------------------------------------------------------------------------------------
+| This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+| Author(s): Mathias Soeken
+*-------------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../gates/gate_base.hpp"
+#include "../../networks/qubit.hpp"
+#include "../../views/adjoint_view.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief Appends the adjoint of a network to another network.
+ *
+ * The gates of ``src`` are appended to ``dest`` in reverse order and replaced by their adjoints
+ * (see ``adjoint_view``), where qubit ``i`` of ``src`` is mapped to qubit ``qubit_map[i]`` of
+ * ``dest``.  This uncomputes ``src`` when it was applied to the same qubits before, e.g., when
+ * building compute-copy-uncompute circuits.  Rewiring in ``src`` is taken into account, and
+ * ``dest`` is rewired such that afterwards qubit ``qubit_map[i]`` of ``dest`` holds the input
+ * qubit ``i`` of ``src``.
+ *
+ * Storage for all gates is reserved up-front.  If the qubits are not relabeled, each gate is
+ * copied as a whole and only its operation is replaced; otherwise, it is recreated from its
+ * operation, controls, and targets, which is not possible for gates that are not in the gate set
+ * (``gate_set::num_defined_ops``).
+ *
+ * **Required gate functions:**
+ * - `adjoint_operation`
+ * - `foreach_control`
+ * - `foreach_target`
+ *
+ * **Required network functions:**
+ * - `emplace_gate`
+ * - `foreach_rcgate`
+ * - `num_gates`
+ * - `num_qubits`
+ * - `reserve`
+ * - `rewire`
+ * - `rewire_map`
+ */
+template<class NetworkDest, class NetworkSrc>
+void append_adjoint(NetworkDest& dest, NetworkSrc const& src,
+                    std::vector<qubit_id> const& qubit_map)
+{
+	using gate_type = typename NetworkDest::gate_type;
+	assert(qubit_map.size() == src.num_qubits());
+
+	/* At the end of src, qubit i is on wire src_map[i] */
+	auto const src_map = src.rewire_map();
+	auto dest_map = dest.rewire_map();
+	std::vector<uint32_t> wire_to_dest(src.num_qubits());
+	bool relabel = false;
+	for (auto i = 0u; i < src_map.size(); ++i) {
+		assert(qubit_map[i].index() < dest.num_qubits());
+		wire_to_dest[src_map[i]] = dest_map[qubit_map[i].index()];
+		relabel = relabel || wire_to_dest[src_map[i]] != src_map[i];
+	}
+
+	dest.reserve(src.num_gates());
+	src.foreach_rcgate([&](auto const& node) {
+		if constexpr (std::is_same_v<gate_type, typename NetworkSrc::gate_type>) {
+			if (!relabel) {
+				dest.emplace_gate(adjoint_gate(node.gate));
+				return;
+			}
+		}
+
+		assert(!node.gate.is(gate_set::num_defined_ops));
+		std::vector<qubit_id> controls;
+		std::vector<qubit_id> targets;
+		node.gate.foreach_control([&](auto control) {
+			controls.emplace_back(wire_to_dest[control.index()], control.is_complemented());
+		});
+		node.gate.foreach_target([&](auto target) {
+			targets.emplace_back(wire_to_dest[target.index()]);
+		});
+		dest.emplace_gate(gate_type(node.gate.adjoint_operation(), controls, targets));
+	});
+
+	/* Afterwards, wire w of src holds input qubit w of src */
+	for (auto w = 0u; w < src_map.size(); ++w) {
+		dest_map[qubit_map[w].index()] = wire_to_dest[w];
+	}
+	dest.rewire(dest_map);
+}
+
+} // namespace tweedledum
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <easy/utils/cancellation.hpp>
 #include <numeric>
 #include <unordered_map>
 #include <vector>
@@ -128,6 +129,12 @@ struct cnot_patel_params {
 	bool best_partition_size = false;
 	/*! \brief Partition size */
 	uint32_t partition_size = 1u;
+	/*! \brief Cancellation token (optional).
+	 *
+	 * The token is polled after each candidate of the search for the best rewiring and partition
+	 * size.  If it is canceled, the best candidate found so far is synthesized.
+	 */
+	easy::utils::cancellation_token const* token = nullptr;
 };
 
 /*! \brief CNOT Patel synthesis for linear circuits
@@ -165,6 +172,7 @@ void cnot_patel(Network& network, std::vector<qubit_id> const& qubits, Matrix co
 	auto const old_num_gates = network.num_gates();
 	(void)old_num_gates; /* var not used in Release mode */
 	auto best_num_gates = std::numeric_limits<uint32_t>::max();
+	auto const is_canceled = [&]() { return params.token && params.token->is_canceled(); };
 
 	if (params.allow_rewiring == true) {
 		auto best_ps = min_ps;
@@ -185,8 +193,8 @@ void cnot_patel(Network& network, std::vector<qubit_id> const& qubits, Matrix co
 				}
 				++ps;
 				assert(network.num_gates() == old_num_gates);
-			} while (ps < max_ps);
-		} while (std::next_permutation(permutation.begin(), permutation.end()));
+			} while (ps < max_ps && !is_canceled());
+		} while (!is_canceled() && std::next_permutation(permutation.begin(), permutation.end()));
 
 		auto permuted_matrix = matrix.permute_rows(best_permutation);
 		detail::cnot_patel_ftor synthesizer(network, qubits, permuted_matrix, best_ps);
@@ -210,7 +218,7 @@ void cnot_patel(Network& network, std::vector<qubit_id> const& qubits, Matrix co
 			}
 			++ps;
 			assert(network.num_gates() == old_num_gates);
-		} while (ps < max_ps);
+		} while (ps < max_ps && !is_canceled());
 		detail::cnot_patel_ftor synthesizer(network, qubits, matrix, best_ps);
 		synthesizer.synthesize();
 	}
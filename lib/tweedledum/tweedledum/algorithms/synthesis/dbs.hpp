@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <easy/utils/cancellation.hpp>
 #include <fmt/format.h>
 #include <iostream>
 #include <kitty/constructors.hpp>
@@ -25,13 +26,22 @@ namespace tweedledum {
 
 /*! \brief Parameters for `dbs`. */
 struct dbs_params {
+	/*! \brief Cancellation token (optional).
+	 *
+	 * The token is polled during the decomposition of the permutation.  If it is canceled, the
+	 * network is returned without gates.  Single-target gate synthesis is not affected by the
+	 * token; it is configured with its own parameters.
+	 */
+	easy::utils::cancellation_token const* token = nullptr;
+
 	/*! \brief Be verbose. */
 	bool verbose = false;
 };
 
 namespace detail {
 
-auto decompose(std::vector<uint32_t>& permutation, uint8_t var)
+auto decompose(std::vector<uint32_t>& permutation, uint8_t var,
+               easy::utils::cancellation_token const* token = nullptr)
 {
 	std::vector<uint32_t> left(permutation.size(), 0);
 	std::vector<uint32_t> right(permutation.size(), 0);
@@ -39,6 +49,9 @@ auto decompose(std::vector<uint32_t>& permutation, uint8_t var)
 
 	uint32_t row = 0u;
 	while (true) {
+		if (token && token->is_canceled()) {
+			return std::make_pair(left, right);
+		}
 		if (visited[row]) {
 			const auto it = std::find(visited.begin(), visited.end(), 0);
 			if (it == visited.end()) {
@@ -126,7 +139,10 @@ Network dbs(std::vector<uint32_t> permutation, STGSynthesisFn&& stg_synth, dbs_p
 	std::list<std::pair<kitty::dynamic_truth_table, std::vector<qubit_id>>> gates;
 	auto pos = gates.begin();
 	for (uint32_t i = 0u; i < num_qubits; ++i) {
-		const auto [left, right] = detail::decompose(permutation, i);
+		const auto [left, right] = detail::decompose(permutation, i, params.token);
+		if (params.token && params.token->is_canceled()) {
+			return network;
+		}
 
 		auto [tt_l, vars_l] = detail::control_function_abs(num_qubits, left);
 		vars_l.push_back(i);
@@ -7,11 +7,107 @@
 
 #include "../../networks/netlist.hpp"
 
+#include <cstdint>
+#include <easy/esop/esop_from_pkrm.hpp>
 #include <easy/esop/esop_from_pprm.hpp>
+#include <easy/esop/exorlink.hpp>
+#include <kitty/cube.hpp>
 #include <vector>
 
 namespace tweedledum {
 
+/*! \brief Parameters for `esop_phase_synth`. */
+struct esop_phase_synth_params {
+	enum class esop_type : uint8_t {
+		/*! \brief Positive polarity Reed-Muller expression */
+		pprm,
+		/*! \brief Optimum pseudo-Kronecker Reed-Muller expression */
+		pkrm,
+		/*! \brief PKRM expression improved by EXORLINK cube transformations */
+		exorlink,
+	} esop = esop_type::pprm;
+
+	/*! \brief Maximum number of passes of EXORLINK cube transformations. */
+	uint32_t exorlink_rounds = 4u;
+};
+
+namespace detail {
+
+/* Removes pairs of equal cubes and merges pairs of cubes with distance 1 */
+inline bool merge_esop_cubes(std::vector<kitty::cube>& cubes)
+{
+	bool changed = false;
+	for (auto i = 0u; i < cubes.size(); ++i) {
+		for (auto j = i + 1u; j < cubes.size();) {
+			auto const distance = cubes[i].distance(cubes[j]);
+			if (distance > 1) {
+				++j;
+				continue;
+			}
+			changed = true;
+			cubes[i] = cubes[i].merge(cubes[j]);
+			cubes.erase(cubes.begin() + j);
+			if (distance == 0) {
+				cubes.erase(cubes.begin() + i);
+				if (i == cubes.size()) {
+					break;
+				}
+			}
+			j = i + 1u;
+		}
+	}
+	return changed;
+}
+
+/* Improves an ESOP expression with EXORLINK-2 cube transformations
+ *
+ * Two cubes with distance 2 are replaced by one of their two equivalent pairs of cubes if one of
+ * the new cubes can be merged with another cube of the expression.  Each accepted transformation
+ * hence removes at least one cube.
+ */
+inline void exorlink_esop(std::vector<kitty::cube>& cubes, uint32_t rounds)
+{
+	while (merge_esop_cubes(cubes)) {
+	}
+
+	for (auto round = 0u; round < rounds; ++round) {
+		bool improved = false;
+		for (auto i = 0u; i < cubes.size(); ++i) {
+			for (auto j = i + 1u; j < cubes.size(); ++j) {
+				if (cubes[i].distance(cubes[j]) != 2) {
+					continue;
+				}
+				for (auto group = 0u; group < 2u; ++group) {
+					auto const linked = easy::esop::exorlink(
+					    cubes[i], cubes[j], 2u, &easy::esop::cube_groups2[4u * group]);
+					auto const mergeable = std::any_of(
+					    linked.begin(), linked.end(), [&](auto const& cube) {
+						    for (auto k = 0u; k < cubes.size(); ++k) {
+							    if (k != i && k != j && cube.distance(cubes[k]) <= 1) {
+								    return true;
+							    }
+						    }
+						    return false;
+					    });
+					if (mergeable) {
+						cubes[i] = linked[0];
+						cubes[j] = linked[1];
+						while (merge_esop_cubes(cubes)) {
+						}
+						improved = true;
+						break;
+					}
+				}
+			}
+		}
+		if (!improved) {
+			break;
+		}
+	}
+}
+
+} // namespace detail
+
 /*! \brief ESOP-phase synthesis.
  *
  * This is the in-place variant of ``esop_phase_synth``, in which the network is passed as a
@@ -21,26 +117,54 @@ namespace tweedledum {
  * \param network A quantum circuit
  * \param qubits A qubit mapping
  * \param function A Boolean function
+ * \param params Parameters (see ``esop_phase_synth_params``)
  */
 template<typename Network>
 void esop_phase_synth(Network& network, std::vector<qubit_id> const& qubits,
-                      kitty::dynamic_truth_table const& function)
+                      kitty::dynamic_truth_table const& function,
+                      esop_phase_synth_params params = {})
 {
-	for (const auto& cube : easy::esop::esop_from_pprm(function)) {
+	using esop_type = esop_phase_synth_params::esop_type;
+
+	std::vector<kitty::cube> cubes;
+	switch (params.esop) {
+	case esop_type::pprm:
+		cubes = easy::esop::esop_from_pprm(function);
+		break;
+	case esop_type::pkrm:
+		cubes = easy::esop::esop_from_optimum_pkrm(function);
+		break;
+	case esop_type::exorlink:
+		cubes = easy::esop::esop_from_optimum_pkrm(function);
+		detail::exorlink_esop(cubes, params.exorlink_rounds);
+		break;
+	}
+
+	/* A cube with only negative literals has no target for its multiple-controlled Z gate
+	 * and is conjugated with a NOT gate; cubes without literals are a global phase. */
+	for (const auto& cube : cubes) {
 		std::vector<qubit_id> controls;
 		std::vector<qubit_id> targets;
 		for (auto i = 0; i < function.num_vars(); ++i) {
 			if (!cube.get_mask(i)) {
 				continue;
 			}
-			assert(cube.get_bit(i));
-			if (targets.empty()) {
+			if (targets.empty() && cube.get_bit(i)) {
 				targets.emplace_back(qubits[i]);
 			} else {
-				controls.emplace_back(qubits[i]);
+				controls.emplace_back(qubits[i], !cube.get_bit(i));
 			}
 		}
-		if (!targets.empty()) {
+		if (controls.empty() && targets.empty()) {
+			continue;
+		}
+		if (targets.empty()) {
+			targets.emplace_back(controls.back().index());
+			controls.pop_back();
+			network.add_gate(gate::pauli_x, targets.back());
+			network.add_gate(gate::mcz, controls, targets);
+			network.add_gate(gate::pauli_x, targets.back());
+		} else {
 			network.add_gate(gate::mcz, controls, targets);
 		}
 	}
@@ -53,16 +177,19 @@ void esop_phase_synth(Network& network, std::vector<qubit_id> const& qubits,
  * the circuit is the same for the function and its inverse.
  *
  * In order to find the multiple-controlled Z gates, the algorithm computes
- * the function's PPRM representation.
+ * an ESOP representation of the function, by default its PPRM representation.
+ * Negative literals are realized with complemented controls.
  *
  * \param function A Boolean function
+ * \param params Parameters (see ``esop_phase_synth_params``)
  *
  * \algtype synthesis
  * \algexpects Boolean function
  * \algreturns Quantum circuit
  */
 template<class Network>
-Network esop_phase_synth(kitty::dynamic_truth_table const& function)
+Network esop_phase_synth(kitty::dynamic_truth_table const& function,
+                         esop_phase_synth_params params = {})
 {
 	Network network;
 	const uint32_t num_qubits = function.num_vars();
@@ -71,7 +198,7 @@ Network esop_phase_synth(kitty::dynamic_truth_table const& function)
 	}
 	std::vector<qubit_id> qubits(num_qubits);
 	std::iota(qubits.begin(), qubits.end(), 0u);
-	esop_phase_synth(network, qubits, function);
+	esop_phase_synth(network, qubits, function, params);
 	return network;
 }
 
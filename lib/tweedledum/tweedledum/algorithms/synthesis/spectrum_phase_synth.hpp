@@ -0,0 +1,91 @@
+/*--------------------------------------------------------------------------------------------------
+| This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+| Author(s): Mathias Soeken
+*-------------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../networks/qubit.hpp"
+#include "../../utils/parity_terms.hpp"
+#include "gray_synth.hpp"
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/spectral.hpp>
+#include <numeric>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief Parameters for `spectrum_phase_synth`. */
+struct spectrum_phase_synth_params {
+	/* Qubits are not rewired, such that the circuit realizes a diagonal unitary */
+	gray_synth_params gs_params = {{
+		/*allow_rewiring*/ false,
+		/*best_partition_size*/ true
+	}};
+};
+
+/*! \brief Spectrum-phase synthesis.
+ *
+ * This is the in-place variant of ``spectrum_phase_synth``, in which the network is passed as a
+ * parameter and can potentially already contain some gates. The parameter ``qubits`` provides a
+ * qubit mapping to the existing qubits in the network.
+ *
+ * \param network A quantum circuit
+ * \param qubits A qubit mapping
+ * \param function A Boolean function
+ * \param params Parameters (see ``spectrum_phase_synth_params``)
+ */
+template<typename Network>
+void spectrum_phase_synth(Network& network, std::vector<qubit_id> const& qubits,
+                          kitty::dynamic_truth_table const& function,
+                          spectrum_phase_synth_params params = {})
+{
+	assert(qubits.size() >= static_cast<uint32_t>(function.num_vars()));
+
+	/* Up to a global phase, (-1)^f(x) is the product of the rotations by s_w * π / 2^n on the
+	 * parities w.x, where s_w is the Rademacher-Walsh coefficient of f for w. */
+	parity_terms parities;
+	const auto spectrum = kitty::rademacher_walsh_spectrum(function);
+	for (auto i = 1u; i < spectrum.size(); ++i) {
+		if (spectrum[i] == 0) {
+			continue;
+		}
+		parities.add_term(i, angle(spectrum[i], function.num_vars()));
+	}
+	gray_synth(network, qubits, parities, params.gs_params);
+}
+
+/*! \brief Spectrum-phase synthesis.
+ *
+ * Finds a quantum circuit of CNOT and Rz gates that computes a phase into a
+ * quantum state based on the Boolean function, i.e., it realizes the diagonal
+ * unitary with entries :math:`(-1)^{f(x)}` up to a global phase.  Unlike
+ * ``stg_from_spectrum``, it does not require a target qubit.
+ *
+ * The rotation angles are computed from the function's Rademacher-Walsh
+ * spectrum and the parities are synthesized using ``gray_synth``.
+ *
+ * \param function A Boolean function
+ * \param params Parameters (see ``spectrum_phase_synth_params``)
+ *
+ * \algtype synthesis
+ * \algexpects Boolean function
+ * \algreturns Quantum circuit
+ */
+template<class Network>
+Network spectrum_phase_synth(kitty::dynamic_truth_table const& function,
+                             spectrum_phase_synth_params params = {})
+{
+	Network network;
+	const uint32_t num_qubits = function.num_vars();
+	for (auto i = 0u; i < num_qubits; ++i) {
+		network.add_qubit();
+	}
+	std::vector<qubit_id> qubits(num_qubits);
+	std::iota(qubits.begin(), qubits.end(), 0u);
+	spectrum_phase_synth(network, qubits, function, params);
+	return network;
+}
+
+} // namespace tweedledum
@@ -24,11 +24,22 @@
 namespace tweedledum {
 
 /*! \brief Parameters for `stg_from_exact_esop`. */
-struct stg_from_esop_params {};
+struct stg_from_esop_params {
+	/*! \brief Cancellation token (optional).
+	 *
+	 * If the token is canceled, the best ESOP found so far is used, or the optimum PKRM
+	 * expression if no ESOP has been found yet.
+	 */
+	easy::utils::cancellation_token const* token = nullptr;
+};
 
 /*! \brief Synthesize a quantum network from a function by computing exact ESOP representation
  */
 struct stg_from_exact_esop {
+	stg_from_exact_esop(stg_from_esop_params const& params_ = {})
+	    : params(params_)
+	{}
+
 	/*! \brief Synthesize into a _existing_ quantum network
 	 *
 	 * \param network  A quantum network
@@ -47,10 +58,15 @@ struct stg_from_exact_esop {
 
 		easy::esop::helliwell_maxsat_statistics stats;
 		easy::esop::helliwell_maxsat_params ps;
+		ps.token = params.token;
 		exact_synthesizer synthesizer(stats, ps);
 
 		std::vector<qubit_id> target = {qubits.back()};
-		const auto cubes = synthesizer.synthesize(function);
+		auto cubes = synthesizer.synthesize(function);
+		if (cubes.empty() && !kitty::is_const0(function)) {
+			/* canceled before the first solution */
+			cubes = easy::esop::esop_from_optimum_pkrm(function);
+		}
 		for (auto const& cube : cubes) {
 			std::vector<qubit_id> controls;
 			std::vector<qubit_id> negations;
@@ -66,6 +82,8 @@ struct stg_from_exact_esop {
 			network.add_gate(gate::mcx, controls, target);
 		}
 	}
+
+	stg_from_esop_params params;
 };
 
 /*! \brief Synthesize a quantum network from a function by computing PKRM representation
@@ -177,19 +195,19 @@ struct stg_from_spectrum {
 		gate_function &= xt;
 
 		parity_terms parities;
-		const float nom = M_PI / (1 << gate_function.num_vars());
 		const auto spectrum = kitty::rademacher_walsh_spectrum(gate_function);
 		for (auto i = 1u; i < spectrum.size(); ++i) {
 			if (spectrum[i] == 0) {
 				continue;
 			}
-			parities.add_term(i, nom * spectrum[i]);
+			parities.add_term(i, angle(spectrum[i], gate_function.num_vars()));
 		}
 
 		network.add_gate(gate::hadamard, qubits.back());
 		if (params.behavior == stg_from_spectrum_params::behavior::use_linear_synth) {
 			linear_synth(network, qubits, parities, params.ls_params);
-		} else if (parities.num_terms() == spectrum.size() - 1) {
+		} else if (parities.num_terms() == spectrum.size() - 1 && qubits.size() <= 6) {
+			/* linear_synth enumerates all orders of the parities and is limited to 6 qubits */
 			linear_synth(network, qubits, parities, params.ls_params);
 		} else {
 			gray_synth(network, qubits, parities, params.gs_params);
@@ -10,6 +10,7 @@
 
 #include <cmath>
 #include <cstdint>
+#include <easy/utils/cancellation.hpp>
 #include <fmt/format.h>
 #include <functional>
 #include <iostream>
@@ -49,6 +50,13 @@ struct tbs_params {
 		return __builtin_popcount(z ^ x) + __builtin_popcount(x ^ permutation[z]);
 	};
 
+	/*! \brief Cancellation token (optional).
+	 *
+	 * The token is polled once for each row of the permutation.  If it is canceled, synthesis stops
+	 * without adding any gates to the network.
+	 */
+	easy::utils::cancellation_token const* token = nullptr;
+
 	/*! \brief Be verbose. */
 	bool verbose = false;
 };
@@ -94,10 +102,13 @@ inline void update_permutation_inv(std::vector<uint32_t>& permutation, uint32_t
 
 template<typename Network>
 void tbs_unidirectional(Network& network, std::vector<qubit_id> const& qubits,
-                        std::vector<uint32_t>& permutation)
+                        std::vector<uint32_t>& permutation, tbs_params const& params)
 {
 	std::vector<std::pair<uint32_t, uint32_t>> gates;
 	for (auto x = 0u; x < permutation.size(); ++x) {
+		if (params.token && params.token->is_canceled()) {
+			return;
+		}
 		// skip identity lines
 		if (permutation[x] == x) {
 			continue;
@@ -125,11 +136,14 @@ void tbs_unidirectional(Network& network, std::vector<qubit_id> const& qubits,
 
 template<typename Network>
 void tbs_bidirectional(Network& network, std::vector<qubit_id> const& qubits,
-                       std::vector<uint32_t>& permutation)
+                       std::vector<uint32_t>& permutation, tbs_params const& params)
 {
 	std::list<std::pair<uint32_t, uint32_t>> gates;
 	auto pos = gates.begin();
 	for (auto x = 0u; x < permutation.size(); ++x) {
+		if (params.token && params.token->is_canceled()) {
+			return;
+		}
 		// skip identity lines
 		if (permutation[x] == x) {
 			continue;
@@ -178,6 +192,9 @@ void tbs_multidirectional(Network& network, std::vector<qubit_id> const& qubits,
 	std::list<std::pair<uint32_t, uint32_t>> gates;
 	auto pos = gates.begin();
 	for (auto x = 0u; x < permutation.size(); ++x) {
+		if (params.token && params.token->is_canceled()) {
+			return;
+		}
 		// find cheapest assignment
 		auto x_best = x;
 		uint32_t x_cost = __builtin_popcount(x ^ permutation[x]);
@@ -246,10 +263,10 @@ void tbs(Network& network, std::vector<qubit_id> const& qubits, std::vector<uint
 
 	switch (params.behavior) {
 		case tbs_params::behavior::unidirectional:
-			detail::tbs_unidirectional(network, qubits, permutation);
+			detail::tbs_unidirectional(network, qubits, permutation, params);
 			break;
 		case tbs_params::behavior::bidirectional:
-			detail::tbs_bidirectional(network, qubits, permutation);
+			detail::tbs_bidirectional(network, qubits, permutation, params);
 			break;
 		case tbs_params::behavior::multidirectional:
 			detail::tbs_multidirectional(network, qubits, permutation, params);
@@ -18,10 +18,15 @@ namespace tweedledum {
 class gate_base {
 public:
 #pragma region Constructors
+	/* A z rotation by a multiple of π/4 is recognized as the corresponding Clifford+T gate. */
 	constexpr gate_base(gate_set operation, angle rotation_angle = 0.0)
 	    : operation_(operation)
 	    , rotation_angle_(rotation_angle)
-	{}
+	{
+		if (operation_ == gate_set::rotation_z && rotation_angle_.is_symbolic_defined()) {
+			update_operation();
+		}
+	}
 
 	// gate_base(gate_set operation, angle rotation_angle)
 	//     : operation_(operation)
@@ -38,6 +43,19 @@ public:
 		return detail::gates_info[static_cast<uint8_t>(operation_)].adjoint;
 	}
 
+	/*! \brief Returns the adjoint operation together with the negated rotation angle.
+	 *
+	 * Operations that are not in the gate set (``gate_set::num_defined_ops``), such as
+	 * single-target gates with a control function, are their own adjoint.
+	 */
+	constexpr gate_base adjoint_operation() const
+	{
+		if (operation_ == gate_set::num_defined_ops) {
+			return *this;
+		}
+		return gate_base(adjoint(), -rotation_angle_);
+	}
+
 	/*! \brief Returns true if this is a meta gate. */
 	constexpr bool is_meta() const
 	{
@@ -113,7 +131,7 @@ public:
 	/* When one of the rotation angles is defined numerically, the resulting rotation angle
 	 * will be numerically defined.
 	 *
-	 * The sum of two symbolically defined angles is done using modulo-8 sum.
+	 * The sum of two exactly defined angles is exact (see ``dyadic_angle``).
 	 */
 	gate_base& operator+=(gate_base const& rhs)
 	{
@@ -173,7 +191,7 @@ private:
 		return true;
 	}
 
-	void update_operation()
+	constexpr void update_operation()
 	{
 		switch (rotation_angle_.symbolic_value()) {
 		case symbolic_angles::zero:
@@ -206,7 +224,7 @@ private:
 			break;
 
 		default:
-			assert(0);
+			operation_ = gate_set::rotation_z;
 			break;
 		}
 	}
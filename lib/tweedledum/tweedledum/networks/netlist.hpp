@@ -112,6 +112,12 @@ public:
 #pragma endregion
 
 #pragma region Add gates(qids)
+	/*! \brief Reserves storage for ``num_gates`` additional gates. */
+	void reserve(uint32_t num_gates)
+	{
+		storage_->nodes.reserve(storage_->nodes.size() + num_gates);
+	}
+
 	template<typename... Args>
 	node_type& emplace_gate(Args&&... args)
 	{
@@ -248,6 +254,19 @@ public:
 		                   fn);
 	}
 
+	/*! \brief Calls ``fn`` on every gate in reverse order. */
+	template<typename Fn>
+	void foreach_rcgate(Fn&& fn) const
+	{
+		// clang-format off
+		static_assert(std::is_invocable_r_v<void, Fn, node_type const&> ||
+		              std::is_invocable_r_v<bool, Fn, node_type const&>);
+		// clang-format on
+		foreach_element_if(storage_->nodes.crbegin(), storage_->nodes.crend(),
+		                   [](auto const& node) { return node.gate.is_unitary_gate(); },
+		                   fn);
+	}
+
 	template<typename Fn>
 	void foreach_cnode(Fn&& fn) const
 	{
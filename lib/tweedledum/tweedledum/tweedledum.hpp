@@ -6,6 +6,7 @@
 
 #include "algorithms/decomposition/barenco.hpp"
 #include "algorithms/decomposition/dt.hpp"
+#include "algorithms/generic/append_adjoint.hpp"
 #include "algorithms/synthesis/cnot_patel.hpp"
 #include "algorithms/synthesis/dbs.hpp"
 #include "algorithms/synthesis/gray_synth.hpp"
@@ -23,3 +24,4 @@
 #include "networks/netlist.hpp"
 #include "traits.hpp"
 #include "utils/angle.hpp"
+#include "views/adjoint_view.hpp"
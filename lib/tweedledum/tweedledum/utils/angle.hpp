@@ -6,8 +6,11 @@
 #pragma once
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <functional>
 
 namespace tweedledum {
 
@@ -33,53 +36,198 @@ enum class symbolic_angles : uint32_t {
 	numerically_defined,
 };
 
+/*! \brief Exact rotation angle of the form k * π / 2^e (modulo 2π)
+ *
+ * The angle is kept normalized, i.e., 0 <= k < 2^(e + 1) and k is odd unless the angle is zero,
+ * in which case also e is zero.  Hence, two angles are equal if and only if their numerators
+ * and exponents are equal.  Addition aligns the exponents, reduces the numerator modulo 2π
+ * with a mask, and strips common factors of two with a single count of trailing zeros.
+ */
+class dyadic_angle {
+public:
+	/*! \brief Largest supported exponent. */
+	static constexpr uint32_t max_exponent = 62u;
+
+#pragma region Constructors
+	constexpr dyadic_angle()
+	    : numerator_(0u)
+	    , exponent_(0u)
+	{}
+
+	/*! \brief Constructs the angle numerator * π / 2^exponent. */
+	constexpr dyadic_angle(int64_t numerator, uint32_t exponent)
+	    : numerator_(static_cast<uint64_t>(numerator))
+	    , exponent_(exponent)
+	{
+		assert(exponent <= max_exponent);
+		normalize();
+	}
+#pragma endregion
+
+#pragma region Properties
+	/*! \brief Returns the numerator k of k * π / 2^e. */
+	constexpr auto numerator() const
+	{
+		return numerator_;
+	}
+
+	/*! \brief Returns the exponent e of k * π / 2^e. */
+	constexpr auto exponent() const
+	{
+		return exponent_;
+	}
+
+	/*! \brief Returns true if this angle is zero (modulo 2π). */
+	constexpr bool is_zero() const
+	{
+		return numerator_ == 0u;
+	}
+
+	/*! \brief Returns the numeric value of this angle in [0, 2π). */
+	constexpr double numeric_value() const
+	{
+		return static_cast<double>(numerator_) * M_PI
+		       / static_cast<double>(uint64_t(1) << exponent_);
+	}
+#pragma endregion
+
+#pragma region Overloads
+	constexpr bool operator==(dyadic_angle const& rhs) const
+	{
+		return numerator_ == rhs.numerator_ && exponent_ == rhs.exponent_;
+	}
+
+	constexpr bool operator!=(dyadic_angle const& rhs) const
+	{
+		return !(*this == rhs);
+	}
+
+	constexpr dyadic_angle& operator+=(dyadic_angle const& rhs)
+	{
+		auto const exponent = std::max(exponent_, rhs.exponent_);
+		numerator_ = (numerator_ << (exponent - exponent_))
+		             + (rhs.numerator_ << (exponent - rhs.exponent_));
+		exponent_ = exponent;
+		normalize();
+		return *this;
+	}
+
+	friend constexpr dyadic_angle operator+(dyadic_angle lhs, dyadic_angle const& rhs)
+	{
+		lhs += rhs;
+		return lhs;
+	}
+
+	constexpr dyadic_angle operator-() const
+	{
+		dyadic_angle result;
+		result.numerator_ = 0u - numerator_;
+		result.exponent_ = exponent_;
+		result.normalize();
+		return result;
+	}
+#pragma endregion
+
+private:
+	/* Since 0 <= k < 2^(e + 1), the sum of two aligned numerators never overflows for e <= 62.
+	 * Or-ing 2^e into the numerator bounds the shift by e, and maps zero to 0 * π / 2^0. */
+	constexpr void normalize()
+	{
+		numerator_ &= (uint64_t(2) << exponent_) - 1u;
+		auto const shift = static_cast<uint32_t>(
+		    __builtin_ctzll(numerator_ | (uint64_t(1) << exponent_)));
+		numerator_ >>= shift;
+		exponent_ -= shift;
+	}
+
+private:
+	uint64_t numerator_;
+	uint32_t exponent_;
+};
+
 /*! \brief Simple class to represent rotation angles
  *
- * A angle can be defined symbolically or numerically.
- * The numeric value of a rotation angle is given in radians (rad).
+ * A angle can be defined exactly, as a multiple of π / 2^e (see ``dyadic_angle``), or
+ * numerically.  Symbolic angles are the exact angles that are multiples of π / 4.  The numeric
+ * value of a rotation angle is given in radians (rad).
  */
 class angle {
 public:
 #pragma region Constructors
 	constexpr angle(symbolic_angles angle)
-	    : symbolic_(angle)
+	    : dyadic_(static_cast<int64_t>(angle), 2u)
+	    , numerical_(0.0)
+	    , is_dyadic_(true)
+	{
+		assert(angle != symbolic_angles::numerically_defined);
+	}
+
+	constexpr angle(dyadic_angle angle)
+	    : dyadic_(angle)
+	    , numerical_(0.0)
+	    , is_dyadic_(true)
+	{}
+
+	/*! \brief Constructs the exact angle numerator * π / 2^exponent. */
+	constexpr angle(int64_t numerator, uint32_t exponent)
+	    : dyadic_(numerator, exponent)
 	    , numerical_(0.0)
+	    , is_dyadic_(true)
 	{}
 
 	constexpr angle(double angle)
-	    : symbolic_(symbolic_angles::numerically_defined)
+	    : dyadic_()
 	    , numerical_(angle)
+	    , is_dyadic_(false)
 	{}
 #pragma endregion
 
 #pragma region Properties
+	/*! \brief Returns true if this angle is exactly defined as a multiple of π / 2^e. */
+	constexpr bool is_dyadic() const
+	{
+		return is_dyadic_;
+	}
+
+	/*! \brief Returns the exact value of this angle (requires ``is_dyadic()``). */
+	constexpr dyadic_angle dyadic_value() const
+	{
+		assert(is_dyadic_);
+		return dyadic_;
+	}
+
 	/*! \brief Returns true if this angle is symbolically defined. */
-	constexpr auto is_symbolic_defined() const
+	constexpr bool is_symbolic_defined() const
 	{
-		return symbolic_ != symbolic_angles::numerically_defined;
+		return is_dyadic_ && dyadic_.exponent() <= 2u;
 	}
 
 	/*! \brief Returns the symbolic value of this angle. */
-	constexpr auto symbolic_value() const
+	constexpr symbolic_angles symbolic_value() const
 	{
-		return symbolic_;
+		if (!is_symbolic_defined()) {
+			return symbolic_angles::numerically_defined;
+		}
+		return static_cast<symbolic_angles>(dyadic_.numerator() << (2u - dyadic_.exponent()));
+	}
+
+	/*! \brief Returns true if this angle is zero. */
+	constexpr bool is_zero() const
+	{
+		return is_dyadic_ ? dyadic_.is_zero() : numerical_ == 0.0;
 	}
 
 	/*! \brief Returns the numeric value of this angle. */
-	constexpr auto numeric_value() const
+	constexpr double numeric_value() const
 	{
-		if (symbolic_ == symbolic_angles::numerically_defined) {
-			return numerical_;
-		}
-		auto const factor = static_cast<double>(symbolic_) / 4;
-		return static_cast<double>(factor * M_PI);
+		return is_dyadic_ ? dyadic_.numeric_value() : numerical_;
 	}
 #pragma endregion
 
 #pragma region Overloads
 	bool operator==(symbolic_angles angle) const
 	{
-		return symbolic_ == angle;
+		return symbolic_value() == angle;
 	}
 
 	bool operator==(double angle) const
@@ -87,51 +235,92 @@ public:
 		return numeric_value() == angle;
 	}
 
+	/* Exact angles are never equal to numerically defined ones. */
+	bool operator==(angle const& rhs) const
+	{
+		if (is_dyadic_ != rhs.is_dyadic_) {
+			return false;
+		}
+		return is_dyadic_ ? dyadic_ == rhs.dyadic_ : numerical_ == rhs.numerical_;
+	}
+
 	bool operator!=(symbolic_angles angle) const
 	{
-		return symbolic_ != angle;
+		return !(*this == angle);
 	}
 
 	bool operator!=(double angle) const
 	{
-		return numeric_value() != angle;
+		return !(*this == angle);
+	}
+
+	bool operator!=(angle const& rhs) const
+	{
+		return !(*this == rhs);
 	}
 
 	/* When one of the rotation angles is defined numerically, the resulting rotation angle
 	 * will be numerically defined.
 	 *
-	 * The sum of two symbolically defined angles is done using modulo-8 sum.
+	 * The sum of two exactly defined angles is exact (modulo 2π).
 	 */
 	angle& operator+=(angle const& rhs)
 	{
-		if (!is_symbolic_defined() || !rhs.is_symbolic_defined()) {
-			symbolic_ = symbolic_angles::numerically_defined;
-			numerical_ += rhs.numeric_value();
+		if (is_dyadic_ && rhs.is_dyadic_) {
+			dyadic_ += rhs.dyadic_;
 			return *this;
 		}
-		auto angle0 = static_cast<uint32_t>(symbolic_);
-		auto angle1 = static_cast<uint32_t>(rhs.symbolic_);
-		symbolic_ = static_cast<symbolic_angles>(((angle0 + angle1) % 8));
+		numerical_ = numeric_value() + rhs.numeric_value();
+		is_dyadic_ = false;
 		return *this;
 	}
 
 	friend angle operator+(angle lhs, angle const& rhs)
 	{
-		if (!lhs.is_symbolic_defined() || !rhs.is_symbolic_defined()) {
-			lhs.symbolic_ = symbolic_angles::numerically_defined;
-			lhs = lhs.numeric_value() + rhs.numeric_value();
-			return lhs;
-		}
-		auto angle0 = static_cast<uint32_t>(lhs.symbolic_);
-		auto angle1 = static_cast<uint32_t>(rhs.symbolic_);
-		lhs.symbolic_ = static_cast<symbolic_angles>(((angle0 + angle1) % 8));
+		lhs += rhs;
 		return lhs;
 	}
+
+	constexpr angle operator-() const
+	{
+		if (is_dyadic_) {
+			return angle(-dyadic_);
+		}
+		return angle(-numerical_);
+	}
 #pragma endregion
 
 private:
-	symbolic_angles symbolic_;
+	dyadic_angle dyadic_;
 	double numerical_;
+	bool is_dyadic_;
 };
 
 } // namespace tweedledum
+
+namespace std {
+
+template<>
+struct hash<tweedledum::dyadic_angle> {
+	using argument_type = tweedledum::dyadic_angle;
+	using result_type = size_t;
+	result_type operator()(argument_type const& in) const
+	{
+		return static_cast<result_type>((in.numerator() << 6) ^ in.exponent());
+	}
+};
+
+template<>
+struct hash<tweedledum::angle> {
+	using argument_type = tweedledum::angle;
+	using result_type = size_t;
+	result_type operator()(argument_type const& in) const
+	{
+		if (in.is_dyadic()) {
+			return hash<tweedledum::dyadic_angle>()(in.dyadic_value());
+		}
+		return hash<double>()(in.numeric_value());
+	}
+};
+
+} // namespace std
@@ -46,14 +46,18 @@ public:
 #pragma region Modifiers
 	/*! \brief Add parity term.
 	 *
-	 * If the term already exist it increments the rotation angle
+	 * If the term already exist it increments the rotation angle.  Terms whose rotation angles
+	 * cancel are removed.
 	 */
 	void add_term(uint32_t term, angle rotation_angle)
 	{
-		assert(rotation_angle != 0.0);
+		assert(!rotation_angle.is_zero());
 		auto search = term_to_angle_.find(term);
 		if (search != term_to_angle_.end()) {
 			search->second += rotation_angle;
+			if (search->second.is_zero()) {
+				term_to_angle_.erase(search);
+			}
 		} else {
 			term_to_angle_.emplace(term, rotation_angle);
 		}
@@ -0,0 +1,88 @@
+/*-------------------------------------------------------------------------------------------------
+| This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+| Author(s): Mathias Soeken
+*------------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include "../gates/gate_base.hpp"
+#include "immutable_view.hpp"
+
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief Returns the adjoint of a gate.
+ *
+ * The gate is copied with all its qubits (and further data, e.g., a control function) and its
+ * operation is replaced by the adjoint operation (see ``gate_base::adjoint_operation``).
+ */
+template<typename GateType>
+GateType adjoint_gate(GateType gate)
+{
+	static_cast<gate_base&>(gate) = gate.adjoint_operation();
+	return gate;
+}
+
+/*! \brief Adjoint of a network.
+ *
+ * This view visits the gates of a network in reverse order and replaces each gate by its
+ * adjoint, e.g., T by T†, S by S†, and Rz(θ) by Rz(-θ), without copying the network.  The adjoint
+ * of a gate is created when it is visited in `foreach_cgate` and is only valid during the call.
+ *
+ * The gates act on the same qubits as in the network.  Hence, if the network rewires qubits, the
+ * adjoint expects qubit ``i`` where the network leaves it, i.e., on qubit ``rewire_map()[i]``,
+ * and `rewire_map` of this view is the identity.
+ *
+ * **Required gate functions:**
+ * - `adjoint_operation`
+ *
+ * **Required network functions:**
+ * - `foreach_rcgate`
+ * - `num_qubits`
+ */
+template<typename Network>
+class adjoint_view : public immutable_view<Network> {
+public:
+	using gate_type = typename Network::gate_type;
+	using node_type = typename Network::node_type;
+	using node_ptr_type = typename Network::node_ptr_type;
+	using storage_type = typename Network::storage_type;
+
+	/*! \brief Default constructor.
+	 *
+	 * Constructs adjoint view on a network.
+	 */
+	explicit adjoint_view(Network const& network)
+	    : immutable_view<Network>(network)
+	{}
+
+	/*! \brief Calls ``fn`` on the adjoint gates in reverse order. */
+	template<typename Fn>
+	void foreach_cgate(Fn&& fn) const
+	{
+		// clang-format off
+		static_assert(std::is_invocable_r_v<void, Fn, node_type const&> ||
+		              std::is_invocable_r_v<bool, Fn, node_type const&>);
+		// clang-format on
+		Network::foreach_rcgate([&](node_type const& node) {
+			node_type const adjoint(adjoint_gate(node.gate));
+			if constexpr (std::is_invocable_r_v<bool, Fn, node_type const&>) {
+				return fn(adjoint);
+			} else {
+				fn(adjoint);
+			}
+		});
+	}
+
+	std::vector<uint32_t> rewire_map() const
+	{
+		std::vector<uint32_t> map(this->num_qubits());
+		std::iota(map.begin(), map.end(), 0u);
+		return map;
+	}
+};
+
+} // namespace tweedledum
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <easy/utils/cancellation.hpp>
+#include <tweedledum/algorithms/synthesis/tbs.hpp>
+#include <tweedledum/gates/mcmt_gate.hpp>
+#include <tweedledum/networks/netlist.hpp>
+
+using namespace easy::utils;
+using namespace tweedledum;
+
+std::vector<uint32_t> random_perm( uint32_t num_vars )
+{
+  std::vector<uint32_t> perm( 1u << num_vars );
+  std::iota( perm.begin(), perm.end(), 0u );
+  std::shuffle( perm.begin(), perm.end(), std::default_random_engine( 1u ) );
+  return perm;
+}
+
+/* the state of a token only depends on the clock if its budget is positive */
+void token_state()
+{
+  cancellation_token unlimited;
+  assert( !unlimited.has_deadline() );
+  assert( !unlimited.is_canceled() );
+  assert( *unlimited.stop_flag() == 0 );
+
+  cancellation_token no_budget( -1.0 );
+  assert( !no_budget.has_deadline() );
+  assert( !no_budget.is_canceled() );
+
+  /* a budget of 0 raises the stop flag before anyone polls the token */
+  cancellation_token zero_budget( 0.0 );
+  assert( zero_budget.has_deadline() );
+  assert( *zero_budget.stop_flag() != 0 );
+  assert( zero_budget.is_canceled() );
+
+  cancellation_token later( 1e6 );
+  assert( !later.is_canceled() );
+  std::thread( [&]() { later.cancel(); } ).join();
+  assert( later.is_canceled() );
+  assert( *later.stop_flag() != 0 );
+}
+
+/* the watcher raises the stop flag of a token whose deadline has passed without polling it */
+void watcher()
+{
+  cancellation_token token( 0.01 );
+  {
+    deadline_watcher watcher( &token );
+    while ( __atomic_load_n( token.stop_flag(), __ATOMIC_RELAXED ) == 0 )
+    {
+      std::this_thread::yield();
+    }
+  }
+  assert( token.is_canceled() );
+
+  /* destroying the watcher before the deadline does not cancel the token */
+  cancellation_token later( 1e6 );
+  {
+    deadline_watcher watcher( &later );
+  }
+  assert( !later.is_canceled() );
+}
+
+/* synthesis stops at a canceled token and is unaffected by a token that is not canceled */
+void synthesis()
+{
+  const auto perm = random_perm( 6u );
+
+  const auto reference = tbs<netlist<mcmt_gate>>( perm );
+  assert( reference.num_gates() > 0u );
+
+  tbs_params ps;
+  cancellation_token later( 1e6 );
+  ps.token = &later;
+  const auto with_token = tbs<netlist<mcmt_gate>>( perm, ps );
+  assert( !later.is_canceled() );
+  assert( with_token.num_gates() == reference.num_gates() );
+
+  cancellation_token canceled( 0.0 );
+  ps.token = &canceled;
+  const auto stopped = tbs<netlist<mcmt_gate>>( perm, ps );
+  assert( stopped.num_qubits() == reference.num_qubits() );
+  assert( stopped.num_gates() == 0u );
+
+  for ( auto behavior : {tbs_params::behavior::bidirectional, tbs_params::behavior::multidirectional} )
+  {
+    ps.behavior = behavior;
+    assert( tbs<netlist<mcmt_gate>>( perm, ps ).num_gates() == 0u );
+  }
+}
+
+int main()
+{
+  token_state();
+  watcher();
+  synthesis();
+  return 0;
+}
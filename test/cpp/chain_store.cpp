@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/npn.hpp>
+#include <kitty/operators.hpp>
+#include <percy/chain_store.hpp>
+
+using namespace percy;
+
+std::string read_file( std::string const& filename )
+{
+  std::ifstream in( filename, std::ios::binary );
+  return std::string( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+}
+
+void write_file( std::string const& filename, std::string const& contents )
+{
+  std::ofstream( filename, std::ios::binary | std::ios::trunc ).write( contents.data(), contents.size() );
+}
+
+kitty::dynamic_truth_table from_hex( uint32_t num_vars, std::string const& hex )
+{
+  kitty::dynamic_truth_table tt( num_vars );
+  kitty::create_from_hex_string( tt, hex );
+  return tt;
+}
+
+spec make_spec( kitty::dynamic_truth_table const& function, Primitive primitive, int fanin )
+{
+  spec s;
+  s[0] = function;
+  s.fanin = fanin;
+  s.set_primitive( primitive );
+  return s;
+}
+
+/* maj(maj(x0, x1, x2), x0, x3) over the non-closed primitive set MAJ */
+chain majority_chain()
+{
+  const auto maj = from_hex( 3u, "e8" );
+  chain c;
+  c.reset( 4, 1, 2, 3 );
+  c.set_step( 0, std::vector<int>{0, 1, 2}, maj );
+  c.set_step( 1, std::vector<int>{4, 0, 3}, maj );
+  c.set_output( 0, 6 << 1 );
+  return c;
+}
+
+/* ( x0 & x1 ) | ( x2 & ~x3 ) over the AIG primitive set, which is closed under input negation */
+chain and_or_chain()
+{
+  chain c;
+  c.reset( 4, 1, 3, 2 );
+  c.set_step( 0, 0, 1, from_hex( 2u, "8" ) );
+  c.set_step( 1, 2, 3, from_hex( 2u, "2" ) );
+  c.set_step( 2, 4, 5, from_hex( 2u, "e" ) );
+  c.set_output( 0, 7 << 1 );
+  return c;
+}
+
+bool uses_primitives( chain const& c, spec const& s )
+{
+  const auto& primitives = s.get_compiled_primitives();
+  for ( int i = 0; i < c.get_nr_steps(); i++ )
+  {
+    if ( std::find( primitives.begin(), primitives.end(), c.get_operator( i ) ) == primitives.end() )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* chains survive reopening the memory-mapped file and are found for other members of their NPN class */
+void round_trip()
+{
+  const auto maj = majority_chain();
+  const auto aig = and_or_chain();
+  const auto f_maj = maj.simulate()[0];
+  const auto f_aig = aig.simulate()[0];
+
+  {
+    chain_store store( "chains.db" );
+    store.insert( make_spec( f_maj, MAJ, 3 ), maj );
+    store.insert( make_spec( f_aig, AIG, 2 ), aig );
+    assert( store.size() == 2u );
+  }
+
+  chain_store store( "chains.db" );
+  assert( store.size() == 2u );
+
+  /* permuted inputs of a majority chain keep all operators majority gates */
+  std::vector<uint8_t> perm{0, 1, 2, 3};
+  do
+  {
+    const auto g = kitty::create_from_npn_config( std::make_tuple( f_maj, 0u, perm ) );
+    const auto s = make_spec( g, MAJ, 3 );
+    chain c;
+    assert( store.lookup( s, c ) );
+    assert( c.simulate()[0] == g );
+    assert( c.get_nr_steps() == 2 );
+    assert( uses_primitives( c, s ) );
+  } while ( std::next_permutation( perm.begin(), perm.end() ) );
+
+  /* complemented inputs change the operators a majority chain would need,
+   * so these may miss, but the store must never return a chain with other
+   * operators */
+  for ( auto phase = 1u; phase < 32u; ++phase )
+  {
+    const auto g = kitty::create_from_npn_config( std::make_tuple( f_maj, phase, std::vector<uint8_t>{2, 0, 3, 1} ) );
+    const auto s = make_spec( g, MAJ, 3 );
+    chain c;
+    if ( store.lookup( s, c ) )
+    {
+      assert( c.simulate()[0] == g );
+      assert( uses_primitives( c, s ) );
+    }
+  }
+
+  /* any NPN transformation of an AIG chain is an AIG chain */
+  perm = {0, 1, 2, 3};
+  do
+  {
+    for ( auto phase = 0u; phase < 32u; ++phase )
+    {
+      const auto g = kitty::create_from_npn_config( std::make_tuple( f_aig, phase, perm ) );
+      const auto s = make_spec( g, AIG, 2 );
+      chain c;
+      assert( store.lookup( s, c ) );
+      assert( c.simulate()[0] == g );
+      assert( c.get_nr_steps() == 3 );
+      assert( uses_primitives( c, s ) );
+    }
+  } while ( std::next_permutation( perm.begin(), perm.end() ) );
+
+  /* a different primitive set is a different key */
+  {
+    const auto s = make_spec( f_maj, AIG, 2 );
+    chain c;
+    assert( !store.lookup( s, c ) );
+  }
+}
+
+/* damaged stores are read up to the damage and never appended to */
+void damaged_stores()
+{
+  const auto contents = read_file( "chains.db" );
+  assert( contents.compare( 0, 8, "PCYSTOR1" ) == 0 );
+
+  const auto f_maj = majority_chain().simulate()[0];
+  const auto f_aig = and_or_chain().simulate()[0];
+  const auto spec_maj = make_spec( f_maj, MAJ, 3 );
+  const auto spec_aig = make_spec( f_aig, AIG, 2 );
+  const auto other = make_spec( from_hex( 2u, "8" ), AIG, 2 );
+  chain other_chain;
+  other_chain.reset( 2, 1, 1, 2 );
+  other_chain.set_step( 0, 0, 1, from_hex( 2u, "8" ) );
+  other_chain.set_output( 0, 3 << 1 );
+
+  const auto check_read_only = [&]( std::string const& filename ) {
+    const auto before = read_file( filename );
+    chain_store store( filename );
+    store.insert( other, other_chain );
+    assert( read_file( filename ) == before );
+  };
+
+  /* the last record is truncated */
+  write_file( "truncated.db", contents.substr( 0, contents.size() - 3u ) );
+  {
+    chain_store store( "truncated.db" );
+    chain c;
+    assert( store.size() == 1u );
+    assert( store.lookup( spec_maj, c ) );
+    assert( !store.lookup( spec_aig, c ) );
+  }
+  check_read_only( "truncated.db" );
+
+  /* only the magic number survives partially */
+  write_file( "magic.db", contents.substr( 0, 5u ) );
+  {
+    chain_store store( "magic.db" );
+    assert( store.size() == 0u );
+  }
+  check_read_only( "magic.db" );
+
+  /* another file format */
+  auto foreign = contents;
+  foreign[7] = '0';
+  write_file( "foreign.db", foreign );
+  {
+    chain_store store( "foreign.db" );
+    chain c;
+    assert( store.size() == 0u );
+    assert( !store.lookup( spec_maj, c ) );
+  }
+  check_read_only( "foreign.db" );
+
+  /* the step count of the first chain does not match its size */
+  auto malformed = contents;
+  const auto key_size = static_cast<uint8_t>( malformed[8] );
+  malformed[8 + 8 + key_size + 4] ^= 0x10;
+  write_file( "malformed.db", malformed );
+  {
+    chain_store store( "malformed.db" );
+    chain c;
+    assert( store.size() == 0u );
+    assert( !store.lookup( spec_maj, c ) );
+    assert( !store.lookup( spec_aig, c ) );
+  }
+  check_read_only( "malformed.db" );
+
+  /* the output literal of the last chain refers to a step that does not exist */
+  auto out_of_range = contents;
+  out_of_range.back() ^= 0x01;
+  write_file( "out_of_range.db", out_of_range );
+  {
+    chain_store store( "out_of_range.db" );
+    chain c;
+    assert( store.size() == 1u );
+    assert( store.lookup( spec_maj, c ) );
+    assert( !store.lookup( spec_aig, c ) );
+  }
+  check_read_only( "out_of_range.db" );
+
+  /* a well-formed chain that realizes another function is not returned */
+  auto corrupt = contents;
+  corrupt[corrupt.size() - 4u] ^= 0x01;
+  write_file( "corrupt.db", corrupt );
+  {
+    chain_store store( "corrupt.db" );
+    chain c;
+    assert( store.size() == 2u );
+    assert( store.lookup( spec_maj, c ) );
+    assert( !store.lookup( spec_aig, c ) );
+  }
+}
+
+int main()
+{
+  round_trip();
+  damaged_stores();
+  return 0;
+}
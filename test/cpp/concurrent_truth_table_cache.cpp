@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operators.hpp>
+#include <mockturtle/networks/klut.hpp>
+#include <mockturtle/utils/concurrent_truth_table_cache.hpp>
+
+using namespace mockturtle;
+
+/* every thread inserts the same functions in a different order, half of them complemented */
+void insert_and_lookup_concurrently()
+{
+  constexpr auto num_threads = 8u;
+  constexpr auto num_functions = 5000u;
+
+  std::vector<kitty::dynamic_truth_table> functions;
+  for ( auto i = 0u; i < num_functions; ++i )
+  {
+    kitty::dynamic_truth_table tt( 7u );
+    kitty::create_random( tt, i + 1u ); /* seeds 0 and 1 coincide */
+    functions.push_back( tt );
+  }
+
+  concurrent_truth_table_cache<kitty::dynamic_truth_table> cache( 16u, 4u );
+  std::vector<std::vector<uint32_t>> literals( num_threads, std::vector<uint32_t>( num_functions ) );
+
+  std::vector<std::thread> threads;
+  for ( auto t = 0u; t < num_threads; ++t )
+  {
+    threads.emplace_back( [&, t]() {
+      std::vector<uint32_t> order( num_functions );
+      for ( auto i = 0u; i < num_functions; ++i )
+      {
+        order[i] = i;
+      }
+      std::shuffle( order.begin(), order.end(), std::default_random_engine( t ) );
+
+      for ( auto i : order )
+      {
+        const auto lit = ( i + t ) % 2 ? cache.insert( ~functions[i] ) ^ 1 : cache.insert( functions[i] );
+        literals[t][i] = lit;
+        assert( cache[lit] == functions[i] );
+        assert( cache[lit ^ 1] == ~functions[i] );
+      }
+    } );
+  }
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  for ( auto i = 0u; i < num_functions; ++i )
+  {
+    for ( auto t = 1u; t < num_threads; ++t )
+    {
+      assert( literals[t][i] == literals[0][i] );
+    }
+    assert( cache[literals[0][i]] == functions[i] );
+  }
+  assert( cache.size() == num_functions );
+}
+
+/* several k-LUT networks that share one concurrent cache are built in parallel */
+void share_cache_between_networks()
+{
+  constexpr auto num_threads = 4u;
+
+  auto cache = std::make_shared<concurrent_truth_table_cache<kitty::dynamic_truth_table>>();
+  std::vector<klut_network> networks;
+  for ( auto t = 0u; t < num_threads; ++t )
+  {
+    auto storage = std::make_shared<klut_storage>();
+    storage->data.concurrent_cache = cache;
+    networks.emplace_back( storage );
+  }
+
+  std::vector<std::thread> threads;
+  for ( auto t = 0u; t < num_threads; ++t )
+  {
+    threads.emplace_back( [&, t]() {
+      auto& ntk = networks[t];
+      std::vector<klut_network::signal> pis;
+      for ( auto i = 0u; i < 4u; ++i )
+      {
+        pis.push_back( ntk.create_pi() );
+      }
+
+      for ( auto i = 0u; i < 1000u; ++i )
+      {
+        kitty::dynamic_truth_table tt( 4u );
+        kitty::create_random( tt, i * num_threads + t );
+        const auto n = ntk.create_node( pis, tt );
+        assert( ntk.node_function( ntk.get_node( n ) ) == tt );
+        ntk.create_po( n );
+      }
+    } );
+  }
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  for ( auto& ntk : networks )
+  {
+    assert( ntk._storage->data.cache.size() == 0u );
+    ntk.foreach_gate( [&]( auto const& n ) {
+      assert( ntk.node_function( n ) == ( *cache )[ntk._storage->nodes[n].data[1].h1] );
+    } );
+  }
+}
+
+int main()
+{
+  insert_and_lookup_concurrently();
+  share_cache_between_networks();
+  return 0;
+}
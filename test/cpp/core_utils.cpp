@@ -0,0 +1,55 @@
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <easy/sat2/core_utils.hpp>
+#include <easy/sat2/sat_solver.hpp>
+
+using namespace easy::sat2;
+
+/* x1 -> x2 -> x3 -> x4, ~x4, with selectors s5..s9 that enable the clauses */
+void add_chain( sat_solver& solver )
+{
+  solver.add_clause( {-5, -1, 2} );
+  solver.add_clause( {-6, -2, 3} );
+  solver.add_clause( {-7, -3, 4} );
+  solver.add_clause( {-8, -4} );
+  solver.add_clause( {-9, 2} ); /* redundant for the conflict */
+}
+
+/* the core without the redundant selector is found, and the caller's budget is kept */
+void minimize_with_budget( int64_t caller_budget )
+{
+  sat_solver_statistics stats;
+  sat_solver_params ps;
+  sat_solver solver( stats, ps );
+  add_chain( solver );
+
+  if ( caller_budget >= 0 )
+  {
+    solver.set_budget( caller_budget );
+  }
+
+  const std::vector<int> assumptions{1, 5, 6, 7, 8, 9};
+  solver.solve( assumptions );
+  assert( solver.is_unsat() );
+
+  const auto cs = solver.get_core();
+  const auto minimized = minimize_core_copy( solver, cs, 10 );
+  assert( minimized.size() <= cs.size() );
+  assert( minimized.size() == 5u );
+  assert( solver.get_budget() == caller_budget );
+
+  solver.solve( std::vector<int>( minimized ) );
+  assert( solver.is_unsat() );
+  solver.solve( {1, 5, 6, 7, 9} );
+  assert( solver.get_state() == sat_solver::state::sat );
+}
+
+int main()
+{
+  minimize_with_budget( -1 );
+  minimize_with_budget( 100 );
+  minimize_with_budget( 5000 );
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
+#include <mockturtle/algorithms/partial_simulation.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/networks/aig.hpp>
+
+using namespace mockturtle;
+
+/* random AIG over 8 inputs, in which every gate is a primary output */
+aig_network random_aig()
+{
+  aig_network aig;
+  std::vector<aig_network::signal> signals;
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    signals.push_back( aig.create_pi() );
+  }
+
+  std::default_random_engine rng( 1u );
+  for ( auto i = 0u; i < 200u; ++i )
+  {
+    const auto a = signals[rng() % signals.size()] ^ ( rng() % 2 == 0 );
+    const auto b = signals[rng() % signals.size()] ^ ( rng() % 2 == 0 );
+    signals.push_back( rng() % 3 == 0 ? aig.create_xor( a, b ) : aig.create_and( a, b ) );
+  }
+  for ( auto f : signals )
+  {
+    aig.create_po( f );
+  }
+  return aig;
+}
+
+/* index of the input assignment in a pattern, as bit position in a complete truth table */
+uint32_t assignment( aig_network const& aig, partial_simulator<aig_network> const& sim, uint32_t pattern )
+{
+  uint32_t index{0u};
+  aig.foreach_pi( [&]( auto const& n, auto i ) {
+    if ( sim.get_bit( aig.make_signal( n ), pattern ) )
+    {
+      index |= 1u << i;
+    }
+  } );
+  return index;
+}
+
+/* every output agrees with its complete truth table on all simulated patterns */
+void check_against_simulate( aig_network const& aig, partial_simulator<aig_network> const& sim )
+{
+  const auto tts = simulate<kitty::dynamic_truth_table>( aig, default_simulator<kitty::dynamic_truth_table>( aig.num_pis() ) );
+
+  for ( auto p = 0u; p < sim.num_patterns(); ++p )
+  {
+    const auto index = assignment( aig, sim, p );
+    aig.foreach_po( [&]( auto const& f, auto i ) {
+      assert( sim.get_bit( f, p ) == kitty::get_bit( tts[i], index ) );
+    } );
+  }
+}
+
+void simulate_random_patterns()
+{
+  const auto aig = random_aig();
+
+  partial_simulator_params ps;
+  partial_simulator<aig_network> sim( aig, 8u, ps );
+  assert( sim.num_patterns() == 512u );
+  check_against_simulate( aig, sim );
+
+  /* pattern blocks simulated in parallel lead to the same words */
+  ps.num_threads = 3u;
+  partial_simulator<aig_network> parallel_sim( aig, 8u, ps );
+  aig.foreach_node( [&]( auto const& n ) {
+    for ( auto w = 0u; w < sim.num_words(); ++w )
+    {
+      assert( sim.words( n )[w] == parallel_sim.words( n )[w] );
+    }
+  } );
+}
+
+void add_patterns()
+{
+  const auto aig = random_aig();
+
+  /* start with one word and add all assignments, which grows the arena twice */
+  partial_simulator<aig_network> sim( aig, 1u );
+  for ( auto index = 0u; index < 256u; ++index )
+  {
+    std::vector<bool> pattern( aig.num_pis() );
+    for ( auto i = 0u; i < pattern.size(); ++i )
+    {
+      pattern[i] = ( index >> i ) & 1;
+    }
+    sim.add_pattern( pattern );
+    assert( assignment( aig, sim, sim.num_patterns() - 1u ) == index );
+  }
+  assert( sim.num_patterns() == 64u + 256u );
+  assert( sim.num_words() == 5u );
+  check_against_simulate( aig, sim );
+
+  /* with all assignments simulated, equal signals are functionally equivalent */
+  const auto tts = simulate<kitty::dynamic_truth_table>( aig, default_simulator<kitty::dynamic_truth_table>( aig.num_pis() ) );
+  std::vector<aig_network::signal> outputs;
+  aig.foreach_po( [&]( auto const& f ) { outputs.push_back( f ); } );
+  for ( auto i = 0u; i < outputs.size(); ++i )
+  {
+    for ( auto j = i + 1u; j < outputs.size(); ++j )
+    {
+      assert( sim.equal( outputs[i], outputs[j] ) == ( tts[i] == tts[j] ) );
+      assert( sim.equal( outputs[i], !outputs[j] ) == ( tts[i] == ~tts[j] ) );
+    }
+  }
+}
+
+int main()
+{
+  simulate_random_patterns();
+  add_patterns();
+  return 0;
+}
@@ -0,0 +1,54 @@
+import revkit
+import pytest
+
+def test_cache_returns_same_circuit():
+  revkit.enable_cache(capacity=4)
+  before = revkit.cache_stats()
+
+  net1 = revkit.tbs([0, 2, 1, 3])
+  net2 = revkit.tbs([0, 2, 1, 3])
+  stats = revkit.cache_stats()
+  revkit.disable_cache()
+
+  assert stats["misses"] == before["misses"] + 1
+  assert stats["hits"] == before["hits"] + 1
+  assert net1.num_gates == net2.num_gates
+  assert net1.num_qubits == net2.num_qubits
+  assert [g.kind for g in net1.gates] == [g.kind for g in net2.gates]
+  assert [g.targets for g in net1.gates] == [g.targets for g in net2.gates]
+
+def _gates(circ):
+  return [(g.kind, g.angle, [(c.index, c.is_complemented) for c in g.controls], g.targets) for g in circ.gates]
+
+def test_cache_loads_results_from_disk(tmp_path):
+  perm = [0, 2, 1, 3, 7, 5, 6, 4]
+  revkit.enable_cache(capacity=4, directory=str(tmp_path))
+  net1 = revkit.tbs(perm)
+  revkit.disable_cache()
+
+  revkit.enable_cache(capacity=4, directory=str(tmp_path))
+  before = revkit.cache_stats()
+  net2 = revkit.tbs(perm)
+  stats = revkit.cache_stats()
+  revkit.disable_cache()
+
+  assert stats["disk_hits"] == before["disk_hits"] + 1
+  assert stats["misses"] == before["misses"]
+  assert net1.num_qubits == net2.num_qubits
+  assert _gates(net1) == _gates(net2)
+
+def test_cache_keeps_rotation_angles(tmp_path):
+  tt = revkit.truth_table.from_hex("deadbeef")
+  revkit.enable_cache(capacity=4, directory=str(tmp_path))
+  net1 = revkit.phase_oracle_synth(tt, kind=revkit.phase_oracle_synth_type.spectrum)
+  revkit.disable_cache()
+
+  revkit.enable_cache(capacity=4, directory=str(tmp_path))
+  before = revkit.cache_stats()
+  net2 = revkit.phase_oracle_synth(tt, kind=revkit.phase_oracle_synth_type.spectrum)
+  stats = revkit.cache_stats()
+  revkit.disable_cache()
+
+  assert stats["disk_hits"] == before["disk_hits"] + 1
+  assert any(g.kind == revkit.gate.gate_type.rotation_z for g in net1.gates)
+  assert _gates(net1) == _gates(net2)
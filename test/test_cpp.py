@@ -0,0 +1,28 @@
+import glob
+import os
+import shutil
+import subprocess
+import pytest
+
+base_path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+sources = sorted(glob.glob(os.path.join(base_path, "test", "cpp", "*.cpp")))
+
+libraries = ["abcsat", "caterpillar", "easy", "ez", "fmt", "glucose", "kitty", "lorina", "mockturtle", "percy", "rang", "sparsepp", "tweedledum"]
+defines = ["FMT_HEADER_ONLY", "DISABLE_NAUTY", "LIN64", "ABC_NAMESPACE=pabc", "ABC_NO_USE_READLINE"]
+
+def _compiler():
+  return os.environ.get("CXX") or shutil.which("c++") or shutil.which("g++") or shutil.which("clang++")
+
+@pytest.mark.parametrize("source", sources, ids=lambda s: os.path.splitext(os.path.basename(s))[0])
+def test_cpp(tmp_path, source):
+  """Compiles a header-only library test against the bundled libraries and runs it in a temporary directory"""
+  compiler = _compiler()
+  if compiler is None:
+    pytest.skip("no C++ compiler found")
+
+  binary = str(tmp_path / "test")
+  cmd = [compiler, "-std=c++17", "-O1", "-pthread", source, "-o", binary]
+  cmd += [f"-I{os.path.join(base_path, 'lib', lib)}" for lib in libraries]
+  cmd += [f"-D{define}" for define in defines]
+  subprocess.run(cmd, check=True)
+  subprocess.run([binary], check=True, timeout=300, cwd=tmp_path)
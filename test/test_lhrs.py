@@ -0,0 +1,177 @@
+import revkit
+import pytest
+
+def _write_multiplier(path, bits):
+  inputs = [f"a{i}" for i in range(bits)] + [f"b{i}" for i in range(bits)]
+  outputs = [f"y{i}" for i in range(2 * bits)]
+  wires = []
+  assigns = []
+
+  def gate(op, x, y):
+    w = f"w{len(wires)}"
+    wires.append(w)
+    assigns.append(f"  assign {w} = {x} {op} {y};")
+    return w
+
+  columns = [[] for _ in range(2 * bits)]
+  for i in range(bits):
+    for j in range(bits):
+      columns[i + j].append(gate("&", f"a{i}", f"b{j}"))
+  for k in range(2 * bits):
+    while len(columns[k]) > 1:
+      x, y = columns[k].pop(0), columns[k].pop(0)
+      if columns[k]:
+        z = columns[k].pop(0)
+        t = gate("^", x, y)
+        columns[k].append(gate("^", t, z))
+        if k + 1 < 2 * bits:
+          columns[k + 1].append(gate("|", gate("&", x, y), gate("&", t, z)))
+      else:
+        columns[k].append(gate("^", x, y))
+        if k + 1 < 2 * bits:
+          columns[k + 1].append(gate("&", x, y))
+
+  with open(path, "w") as f:
+    f.write(f"module mult({', '.join(inputs + outputs)});\n")
+    f.write(f"  input {', '.join(inputs)};\n")
+    f.write(f"  output {', '.join(outputs)};\n")
+    f.write(f"  wire {', '.join(wires)};\n")
+    f.write("\n".join(assigns) + "\n")
+    for k in range(2 * bits):
+      f.write(f"  assign y{k} = {columns[k][0]};\n")
+    f.write("endmodule\n")
+  return str(path)
+
+@pytest.fixture
+def multiplier(tmp_path):
+  revkit.disable_cache()
+  return _write_multiplier(tmp_path / "mult.v", 3)
+
+def _simulate(circ, stats, values):
+  """Output values of a circuit of NOT, CNOT, and Toffoli gates for input values"""
+  x = sum(1 << q for i, q in enumerate(stats["input_indexes"]) if (values >> i) & 1)
+  for g in circ.gates:
+    assert g.kind in (revkit.gate.gate_type.pauli_x, revkit.gate.gate_type.cx, revkit.gate.gate_type.mcx)
+    if all(((x >> c.index) & 1) != c.is_complemented for c in g.controls):
+      x ^= 1 << g.targets[0]
+  return sum(((x >> q) & 1) << i for i, q in enumerate(stats["output_indexes"]))
+
+def _realizes_multiplier(circ, stats, bits):
+  return all(_simulate(circ, stats, a | (b << bits)) == a * b for a in range(2**bits) for b in range(2**bits))
+
+@pytest.mark.parametrize("network_type, script", [(revkit.lhrs_network_type.aig, "rw;rs"), (revkit.lhrs_network_type.xag, "rw;rf"), (revkit.lhrs_network_type.mig, "rw;rs;ad"), (revkit.lhrs_network_type.xmg, "rf;ad")])
+def test_optimize_script(multiplier, network_type, script):
+  circ, stats = revkit.lhrs(multiplier, network_type=network_type, lut_synthesis=revkit.oracle_synth_type.pprm, optimize=script, optimize_rounds=2)
+
+  sizes = stats["optimization_sizes"]
+  num_passes = len(script.split(";"))
+  assert len(sizes) in (1 + num_passes, 1 + 2 * num_passes)
+  if "ad" not in script:
+    assert sizes == sorted(sizes, reverse=True)
+  assert ("optimization_num_ands" in stats) == (network_type in (revkit.lhrs_network_type.aig, revkit.lhrs_network_type.xag))
+  assert _realizes_multiplier(circ, stats, 3)
+
+def test_optimize_script_rejects_unsupported_pass(multiplier):
+  with pytest.raises(RuntimeError):
+    revkit.lhrs(multiplier, network_type=revkit.lhrs_network_type.xag, optimize="rs")
+
+def test_heuristic_pebbling_without_limit_matches_bennett(multiplier):
+  bennett, _ = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.bennett)
+  heuristic, _ = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.heuristic_pebbling)
+
+  assert heuristic.num_gates == bennett.num_gates
+  assert heuristic.num_qubits == bennett.num_qubits
+
+def test_heuristic_pebbling_with_limit(multiplier):
+  bennett, _ = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.bennett)
+  heuristic, _ = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.heuristic_pebbling, num_pebbles=24)
+
+  assert heuristic.num_qubits < bennett.num_qubits
+  assert heuristic.num_gates > bennett.num_gates
+
+def test_heuristic_pebbling_tradeoff(multiplier):
+  fewest_gates, stats1 = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.heuristic_pebbling, lut_synthesis=revkit.oracle_synth_type.pprm, num_pebbles=24)
+  fewest_qubits, stats0 = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.heuristic_pebbling, lut_synthesis=revkit.oracle_synth_type.pprm, num_pebbles=24, tradeoff=0.0)
+
+  assert stats0["bennett_fallback"] == stats1["bennett_fallback"] == [0]
+  assert fewest_qubits.num_qubits <= fewest_gates.num_qubits <= len(stats1["input_indexes"]) + 24
+  assert fewest_qubits.num_gates >= fewest_gates.num_gates
+  assert _realizes_multiplier(fewest_gates, stats1, 3)
+  assert _realizes_multiplier(fewest_qubits, stats0, 3)
+
+def test_heuristic_pebbling_falls_back_to_bennett(multiplier):
+  bennett, _ = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.bennett, lut_synthesis=revkit.oracle_synth_type.pprm)
+
+  # all six outputs stay pebbled, so three pebbles are never enough
+  circ, stats = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.heuristic_pebbling, lut_synthesis=revkit.oracle_synth_type.pprm, num_pebbles=3)
+
+  assert stats["bennett_fallback"] == [1]
+  assert circ.num_qubits == bennett.num_qubits
+  assert circ.num_gates == bennett.num_gates
+  assert _realizes_multiplier(circ, stats, 3)
+
+def test_optimize_script_removes_redundancy(tmp_path):
+  revkit.disable_cache()
+  filename = tmp_path / "redundant.v"
+  filename.write_text("""module redundant(a, b, c, d, y);
+  input a, b, c, d;
+  output y;
+  wire w0, w1, w2, w3, w4, w5, w6;
+  assign w0 = a & b;
+  assign w1 = a & c;
+  assign w2 = w0 | w1;
+  assign w3 = b | c;
+  assign w4 = a & w3;
+  assign w5 = w4 & d;
+  assign w6 = w2 & d;
+  assign y = w5 | w6;
+endmodule
+""")
+
+  circ, stats = revkit.lhrs(str(filename), network_type=revkit.lhrs_network_type.aig, lut_synthesis=revkit.oracle_synth_type.pprm, optimize="rw;rs", optimize_rounds=3)
+
+  sizes = stats["optimization_sizes"]
+  assert sizes[-1] < sizes[0]
+  assert stats["optimization_num_ands"] == sizes
+  for v in range(16):
+    a, b, c, d = ((v >> i) & 1 for i in range(4))
+    assert _simulate(circ, stats, v) == a & (b | c) & d
+
+def test_best_fit(multiplier):
+  bennett, _ = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.bennett, lut_synthesis=revkit.oracle_synth_type.pprm)
+  circ, stats = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.best_fit, lut_synthesis=revkit.oracle_synth_type.pprm)
+
+  assert circ.num_qubits < bennett.num_qubits
+  assert _realizes_multiplier(circ, stats, 3)
+
+def test_best_fit_with_large_luts(multiplier):
+  bennett, _ = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.bennett)
+  circ, _ = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.best_fit)
+
+  assert circ.num_qubits < bennett.num_qubits
+  assert circ.num_gates > 0
+
+@pytest.mark.parametrize("bits", [3, 4])
+def test_best_fit_with_pkrm_cost(tmp_path, bits):
+  revkit.disable_cache()
+  multiplier = _write_multiplier(tmp_path / "mult.v", bits)
+
+  bennett, _ = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.bennett, lut_synthesis=revkit.oracle_synth_type.pkrm)
+  circ, stats = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.best_fit, lut_synthesis=revkit.oracle_synth_type.pkrm)
+
+  assert circ.num_qubits < bennett.num_qubits
+  assert _realizes_multiplier(circ, stats, bits)
+
+@pytest.mark.parametrize("sat_solver", [revkit.sat_solver_type.bsat, revkit.sat_solver_type.glucose])
+def test_pebbling_sat_solver(multiplier, sat_solver):
+  circ, stats = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.pebbling, lut_synthesis=revkit.oracle_synth_type.pprm, num_pebbles=16, sat_solver=sat_solver)
+
+  assert circ.num_qubits <= len(stats["input_indexes"]) + 16
+  assert _realizes_multiplier(circ, stats, 3)
+
+@pytest.mark.parametrize("sat_solver", [revkit.sat_solver_type.bsat, revkit.sat_solver_type.glucose])
+def test_pebbling_lazy_cardinality(multiplier, sat_solver):
+  circ, stats = revkit.lhrs(multiplier, strategy=revkit.mapping_strategy.pebbling, lut_synthesis=revkit.oracle_synth_type.pprm, num_pebbles=16, sat_solver=sat_solver, lazy_cardinality=True)
+
+  assert circ.num_qubits <= len(stats["input_indexes"]) + 16
+  assert _realizes_multiplier(circ, stats, 3)
@@ -1,4 +1,6 @@
-from revkit import netlist, tbs
+from revkit import diagonal_synth, gate, netlist, tbs
+import cmath
+import math
 import pytest
 
 def test_netlist():
@@ -7,3 +9,41 @@ def test_netlist():
   assert 3 == circ.num_gates
   assert circ.to_quil() == "CNOT 1 0\nCNOT 0 1\nCNOT 1 0\n"
   assert circ.to_qasm() == 'OPENQASM 2.0;\ninclude "qelib1.inc";\nqreg q[2];\ncreg c[2];\ncx q[1],q[0];\ncx q[0],q[1];\ncx q[1],q[0];\n'
+
+def _simulate(circ, x, phase=0.0):
+  """Basis state and phase that a circuit without Hadamard gates maps x to"""
+  for g in circ.gates:
+    target = g.targets[0]
+    active = all(((x >> c.index) & 1) != c.is_complemented for c in g.controls)
+    if g.kind in (gate.gate_type.pauli_x, gate.gate_type.cx, gate.gate_type.mcx):
+      if active:
+        x ^= 1 << target
+    elif g.kind in (gate.gate_type.cz, gate.gate_type.mcz):
+      if active and (x >> target) & 1:
+        phase += math.pi
+    elif g.kind in (gate.gate_type.rotation_z, gate.gate_type.pauli_z, gate.gate_type.phase, gate.gate_type.phase_dagger, gate.gate_type.t, gate.gate_type.t_dagger):
+      if (x >> target) & 1:
+        phase += g.angle
+    else:
+      pytest.fail(f"unexpected gate {g.kind}")
+  return x, phase
+
+def test_adjoint_inverts_permutation():
+  perm = [0, 2, 3, 5, 7, 1, 4, 6]
+  circ = tbs(perm)
+  adj = circ.adjoint()
+
+  assert adj.num_qubits == circ.num_qubits
+  assert adj.num_gates == circ.num_gates
+  for x, y in enumerate(perm):
+    assert _simulate(adj, y)[0] == x
+
+def test_adjoint_round_trip_cancels_phases():
+  circ = diagonal_synth([0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7])
+  adj = circ.adjoint()
+
+  assert adj.num_gates == circ.num_gates
+  for x in range(2**circ.num_qubits):
+    y, phase = _simulate(adj, *_simulate(circ, x))
+    assert y == x
+    assert abs(cmath.exp(1j * phase) - 1) < 1e-9
@@ -0,0 +1,51 @@
+import revkit
+import cmath
+import math
+import pytest
+
+gate_type = revkit.gate.gate_type
+
+def _simulate(circ, x):
+  """Basis state and phase that a circuit without Hadamard gates maps x to"""
+  phase = 0.0
+  for g in circ.gates:
+    target = g.targets[0]
+    active = all(((x >> c.index) & 1) != c.is_complemented for c in g.controls)
+    if g.kind in (gate_type.pauli_x, gate_type.cx, gate_type.mcx):
+      if active:
+        x ^= 1 << target
+    elif g.kind in (gate_type.cz, gate_type.mcz):
+      if active and (x >> target) & 1:
+        phase += math.pi
+    elif g.kind in (gate_type.rotation_z, gate_type.pauli_z, gate_type.phase, gate_type.phase_dagger, gate_type.t, gate_type.t_dagger):
+      if (x >> target) & 1:
+        phase += g.angle
+    else:
+      pytest.fail(f"unexpected gate {g.kind}")
+  return x, phase
+
+def _realizes_phase_oracle(circ, tt):
+  bits = [int(b) for b in reversed(str(tt))]
+  _, global_phase = _simulate(circ, 0)
+  global_phase -= math.pi * bits[0]
+  for x, bit in enumerate(bits):
+    y, phase = _simulate(circ, x)
+    if y != x or abs(cmath.exp(1j * (phase - math.pi * bit - global_phase)) - 1) > 1e-9:
+      return False
+  return True
+
+@pytest.mark.parametrize("kind", [revkit.phase_oracle_synth_type.pkrm, revkit.phase_oracle_synth_type.pprm, revkit.phase_oracle_synth_type.exorlink, revkit.phase_oracle_synth_type.spectrum])
+@pytest.mark.parametrize("function", ["e8", "6996", "8000", "1ee1f00f", "deadbeef"])
+def test_phase_oracle_synth(kind, function):
+  revkit.disable_cache()
+  tt = revkit.truth_table.from_hex(function)
+
+  circ = revkit.phase_oracle_synth(tt, kind=kind)
+  assert circ.num_qubits == tt.num_vars
+  assert _realizes_phase_oracle(circ, tt)
+
+def test_phase_oracle_synth_uses_no_target_qubit():
+  revkit.disable_cache()
+  tt = revkit.truth_table.from_hex("6996")
+
+  assert revkit.phase_oracle_synth(tt).num_qubits + 1 == revkit.oracle_synth(tt).num_qubits
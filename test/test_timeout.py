@@ -0,0 +1,59 @@
+import revkit
+import random
+import pytest
+
+def _random_perm(num_vars):
+  perm = list(range(2**num_vars))
+  random.Random(1).shuffle(perm)
+  return perm
+
+# a timeout of 0 cancels the call before it starts, so these tests do not
+# depend on how fast the synthesis runs
+
+def test_tbs_timeout():
+  revkit.disable_cache()
+  perm = _random_perm(10)
+
+  with pytest.raises(TimeoutError):
+    revkit.tbs(perm, timeout=0)
+
+def test_dbs_timeout():
+  revkit.disable_cache()
+  perm = _random_perm(8)
+
+  with pytest.raises(TimeoutError):
+    revkit.dbs(perm, timeout=0)
+
+def test_no_timeout():
+  revkit.disable_cache()
+  perm = _random_perm(4)
+
+  net1 = revkit.tbs(perm)
+  net2 = revkit.tbs(perm, timeout=None)
+  net3 = revkit.tbs(perm, timeout=1e6)
+
+  assert net1.num_gates == net2.num_gates == net3.num_gates
+  assert [g.targets for g in net1.gates] == [g.targets for g in net2.gates]
+
+def test_oracle_synth_timeout_returns_best_so_far():
+  revkit.disable_cache()
+  tt = revkit.truth_table.from_hex("6996")
+
+  net = revkit.oracle_synth(tt, timeout=0)
+  assert net.num_qubits == 5
+  assert net.num_gates > 0
+
+def test_timeout_results_are_not_cached():
+  revkit.enable_cache(capacity=4)
+  perm = _random_perm(10)
+
+  with pytest.raises(TimeoutError):
+    revkit.tbs(perm, timeout=0)
+  before = revkit.cache_stats()
+  with pytest.raises(TimeoutError):
+    revkit.tbs(perm, timeout=0)
+  stats = revkit.cache_stats()
+  revkit.disable_cache()
+
+  assert stats["hits"] == before["hits"]
+  assert stats["entries"] == before["entries"]